@@ -0,0 +1,67 @@
+#ifndef INCLUDE_POLIP_JSON_BATCH_HPP
+#define INCLUDE_POLIP_JSON_BATCH_HPP
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+#include "polip/json/parser.hpp"
+
+namespace polip
+{
+namespace json
+{
+
+// outcome of loading one document of a batch, error is set if load()
+// threw and value is null then
+struct BatchResult
+{
+    Value value;
+    std::exception_ptr error;
+};
+
+/*
+    Loads many independent documents on a pool of worker threads that is
+    started once and kept for the lifetime of the loader. The documents are
+    handed out in small chunks from a shared atomic counter, so a thread
+    that finishes early takes over the rest of the batch. The calling
+    thread takes part in the work. Results come back in input order, a
+    document that fails to parse does not affect the others.
+
+    Parsing shares no mutable state between threads, the grammar is
+    immutable and every document gets its own builder. Calls to load()
+    from several threads are serialized.
+ */
+class BatchLoader
+{
+public:
+    // threads == 0 uses std::thread::hardware_concurrency(), the calling
+    // thread counts as one of them
+    explicit BatchLoader(std::size_t threads = 0);
+    ~BatchLoader();
+
+    BatchLoader(const BatchLoader&) = delete;
+    BatchLoader& operator=(const BatchLoader&) = delete;
+
+    std::size_t threads() const;
+
+    // documents have to outlive the results, parse_error positions refer
+    // to them
+    std::vector<BatchResult> load(const std::vector<std::string>& documents,
+                                  const ParseOptions& options = ParseOptions{});
+
+private:
+    struct State;
+    std::unique_ptr<State> m_state;
+};
+
+// a BatchLoader for a single batch
+std::vector<BatchResult> load_batch(const std::vector<std::string>& documents,
+                                    const ParseOptions& options = ParseOptions{},
+                                    std::size_t threads = 0);
+
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_BATCH_HPP
@@ -0,0 +1,409 @@
+#ifndef INCLUDE_POLIP_JSON_BIND_HPP
+#define INCLUDE_POLIP_JSON_BIND_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <boost/fusion/include/adapt_struct.hpp>
+#include <boost/fusion/include/at_c.hpp>
+#include <boost/fusion/include/is_sequence.hpp>
+#include <boost/fusion/include/size.hpp>
+#include <boost/fusion/include/value_at.hpp>
+#include <boost/optional.hpp>
+#include "polip/json/parser.hpp"
+#include "polip/json/reader.hpp"
+#include "polip/json/text.hpp"
+
+namespace polip
+{
+namespace json
+{
+
+/*
+    Binding of JSON documents to C++ structs without an intermediate Value.
+    A struct is described by BOOST_FUSION_ADAPT_STRUCT, e.g.
+        struct Point { int64_t x; int64_t y; std::string label; };
+        BOOST_FUSION_ADAPT_STRUCT(Point, x, y, label)
+    after which
+        Point p = load_into<Point>(R"({"x": 1, "y": 2, "label": "a"})");
+        std::string text = dump_from(p);
+
+    Members may be bool, integral and floating point types, std::string,
+    std::vector and boost::optional of bindable types and other adapted
+    structs. Integral members are range checked, unsigned ones are read
+    and written up to the maximum of uint64_t. Unknown object members are
+    skipped, members missing from the document keep their previous value,
+    and a null resets an optional. Values of the wrong type are reported
+    as parse_error<const char*>, see BasicReader, which also checks
+    options.maxDepth and options.limits. Other types are bound by
+    specializing Binding.
+ */
+template <typename T, typename Enable = void>
+struct Binding;
+
+template <typename T>
+T load_into(const std::string& jsonDoc,
+            const ParseOptions& options = ParseOptions{});
+template <typename T>
+T load_into(const std::string& jsonDoc, Conformance level);
+// binds into an existing value, options.engine and options.resource are
+// not consulted
+template <typename T>
+void load_into(const std::string& jsonDoc, T& value,
+               const ParseOptions& options = ParseOptions{});
+
+template <typename T>
+std::string dump_from(const T& value);
+
+template <>
+struct Binding<bool>
+{
+    template <typename Reader>
+    static void read(Reader& in, bool& v)
+    {
+        v = in.readBool();
+    }
+
+    static void write(std::string& out, bool v)
+    {
+        out += v ? "true" : "false";
+    }
+};
+
+template <typename T>
+struct Binding<T, typename std::enable_if<std::is_integral<T>::value &&
+                                          !std::is_same<T, bool>::value>::type>
+{
+    template <typename Reader>
+    static void read(Reader& in, T& v)
+    {
+        using Limits = std::numeric_limits<T>;
+        if (std::is_signed<T>::value) {
+            const int64_t n = in.readInteger();
+            if (n < static_cast<int64_t>(Limits::min()) ||
+                n > static_cast<int64_t>(Limits::max())) {
+                in.fail(DiagError::Int);
+            }
+            v = static_cast<T>(n);
+        } else {
+            const uint64_t n = in.readUnsigned();
+            if (n > static_cast<uint64_t>(Limits::max())) {
+                in.fail(DiagError::Int);
+            }
+            v = static_cast<T>(n);
+        }
+    }
+
+    static void write(std::string& out, T v)
+    {
+        if (std::is_signed<T>::value) {
+            appendInteger(out, static_cast<int64_t>(v));
+        } else {
+            appendUnsigned(out, static_cast<uint64_t>(v));
+        }
+    }
+};
+
+template <typename T>
+struct Binding<T, typename std::enable_if<
+                      std::is_floating_point<T>::value>::type>
+{
+    template <typename Reader>
+    static void read(Reader& in, T& v)
+    {
+        v = static_cast<T>(in.readDouble());
+    }
+
+    static void write(std::string& out, T v)
+    {
+        appendDouble(out, v);
+    }
+};
+
+template <>
+struct Binding<std::string>
+{
+    template <typename Reader>
+    static void read(Reader& in, std::string& v)
+    {
+        v = in.readString();
+    }
+
+    static void write(std::string& out, const std::string& v)
+    {
+        appendString(out, v);
+    }
+};
+
+template <typename T, typename Allocator>
+struct Binding<std::vector<T, Allocator>>
+{
+    template <typename Reader>
+    static void read(Reader& in, std::vector<T, Allocator>& v)
+    {
+        v.clear();
+        in.arrayBegin();
+        while (in.arrayNext()) {
+            // not emplace_back() and back(), which is a proxy for bool
+            T item{};
+            Binding<T>::read(in, item);
+            v.push_back(std::move(item));
+        }
+    }
+
+    static void write(std::string& out, const std::vector<T, Allocator>& v)
+    {
+        out += '[';
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            if (i > 0) {
+                out += ',';
+            }
+            Binding<T>::write(out, v[i]);
+        }
+        out += ']';
+    }
+};
+
+template <typename T>
+struct Binding<boost::optional<T>>
+{
+    template <typename Reader>
+    static void read(Reader& in, boost::optional<T>& v)
+    {
+        if (in.peek() == Reader::Token::Null) {
+            in.readNull();
+            v = boost::none;
+            return;
+        }
+        if (!v) {
+            v = T{};
+        }
+        Binding<T>::read(in, *v);
+    }
+
+    static void write(std::string& out, const boost::optional<T>& v)
+    {
+        if (v) {
+            Binding<T>::write(out, *v);
+        } else {
+            out += "null";
+        }
+    }
+};
+
+namespace details
+{
+
+template <typename T, int I>
+using MemberType = typename boost::fusion::result_of::value_at_c<T, I>::type;
+
+template <typename T, int I>
+const char* memberName()
+{
+    return boost::fusion::extension::struct_member_name<T, I>::call();
+}
+
+/*
+    Member names of an adapted struct, sorted by length and then by
+    contents, each with the function binding its member. A document
+    member is looked up by its length in a jump table, the switch that
+    fusion's run-time names allow, and then compared with the few names
+    of that length.
+ */
+template <typename Reader, typename T>
+class MemberTable
+{
+public:
+    using ReadMember = void (*)(Reader&, T&);
+
+    static const MemberTable& instance()
+    {
+        static const MemberTable table;
+        return table;
+    }
+
+    // nullptr for unknown members
+    ReadMember find(const std::string& name) const
+    {
+        if (name.size() + 1 >= m_byLength.size()) {
+            return nullptr;
+        }
+        const std::size_t end = m_byLength[name.size() + 1];
+        for (std::size_t i = m_byLength[name.size()]; i != end; ++i) {
+            if (std::memcmp(m_entries[i].name, name.data(), name.size()) == 0) {
+                return m_entries[i].read;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    static const int size = boost::fusion::result_of::size<T>::type::value;
+
+    struct Entry
+    {
+        const char* name;
+        std::size_t size;
+        ReadMember read;
+    };
+
+    template <int I>
+    static void readMember(Reader& in, T& object)
+    {
+        Binding<MemberType<T, I>>::read(in, boost::fusion::at_c<I>(object));
+    }
+
+    template <int I, bool = (I < size)>
+    struct Fill
+    {
+        static void apply(Entry* entries)
+        {
+            const char* name = memberName<T, I>();
+            entries[I] = Entry{name, std::strlen(name), &readMember<I>};
+            Fill<I + 1>::apply(entries);
+        }
+    };
+
+    template <int I>
+    struct Fill<I, false>
+    {
+        static void apply(Entry*)
+        {
+        }
+    };
+
+    MemberTable()
+    {
+        Fill<0>::apply(m_entries.data());
+        std::sort(m_entries.begin(), m_entries.end(),
+                  [](const Entry& lhs, const Entry& rhs) {
+                      return lhs.size != rhs.size
+                                 ? lhs.size < rhs.size
+                                 : std::strcmp(lhs.name, rhs.name) < 0;
+                  });
+        const std::size_t longest =
+            m_entries.empty() ? 0 : m_entries.back().size;
+        m_byLength.resize(longest + 2);
+        std::size_t entry = 0;
+        for (std::size_t length = 0; length != m_byLength.size(); ++length) {
+            while (entry != m_entries.size() &&
+                   m_entries[entry].size < length) {
+                ++entry;
+            }
+            m_byLength[length] = entry;
+        }
+    }
+
+    std::array<Entry, size> m_entries;
+    // first entry of at least the length, up to one past the longest name
+    std::vector<std::size_t> m_byLength;
+};
+
+template <typename T, int I, int N>
+struct WriteMembers
+{
+    static void apply(std::string& out, const T& object)
+    {
+        if (I > 0) {
+            out += ',';
+        }
+        appendString(out, memberName<T, I>());
+        out += ':';
+        Binding<MemberType<T, I>>::write(out, boost::fusion::at_c<I>(object));
+        WriteMembers<T, I + 1, N>::apply(out, object);
+    }
+};
+
+template <typename T, int N>
+struct WriteMembers<T, N, N>
+{
+    static void apply(std::string&, const T&)
+    {
+    }
+};
+
+template <Conformance Level, typename T>
+void loadInto(const std::string& jsonDoc, T& value,
+              const ParseOptions& options)
+{
+    BasicReader<Level> in(jsonDoc.data(), jsonDoc.data() + jsonDoc.size(),
+                          options.maxDepth, options.limits);
+    Binding<T>::read(in, value);
+    in.finish();
+}
+
+}  // namespace details
+
+template <typename T>
+struct Binding<T, typename std::enable_if<
+                      boost::fusion::traits::is_sequence<T>::value>::type>
+{
+    template <typename Reader>
+    static void read(Reader& in, T& object)
+    {
+        auto const& members = details::MemberTable<Reader, T>::instance();
+        in.objectBegin();
+        while (in.objectNext()) {
+            if (auto read = members.find(in.memberName())) {
+                read(in, object);
+            } else {
+                in.skipValue();
+            }
+        }
+    }
+
+    static void write(std::string& out, const T& object)
+    {
+        out += '{';
+        details::WriteMembers<
+            T, 0, boost::fusion::result_of::size<T>::type::value>::apply(out,
+                                                                        object);
+        out += '}';
+    }
+};
+
+template <typename T>
+T load_into(const std::string& jsonDoc, const ParseOptions& options)
+{
+    T value{};
+    load_into(jsonDoc, value, options);
+    return value;
+}
+
+template <typename T>
+T load_into(const std::string& jsonDoc, Conformance level)
+{
+    ParseOptions options;
+    options.level = level;
+    return load_into<T>(jsonDoc, options);
+}
+
+template <typename T>
+void load_into(const std::string& jsonDoc, T& value,
+               const ParseOptions& options)
+{
+    if (options.level == Conformance::Strict) {
+        details::loadInto<Conformance::Strict>(jsonDoc, value, options);
+    } else {
+        details::loadInto<Conformance::Relaxed>(jsonDoc, value, options);
+    }
+}
+
+template <typename T>
+std::string dump_from(const T& value)
+{
+    std::string out;
+    Binding<T>::write(out, value);
+    return out;
+}
+
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_BIND_HPP
@@ -0,0 +1,73 @@
+#ifndef INCLUDE_POLIP_JSON_CBOR_HPP
+#define INCLUDE_POLIP_JSON_CBOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "polip/json/parser.hpp"
+#include "polip/json/value.hpp"
+
+namespace polip
+{
+namespace json
+{
+
+class Nesting;
+
+/*
+    CBOR (RFC 8949) encoding of JSON documents. Decoding accepts the data
+    model of Value: text strings, arrays, maps with text keys, integers,
+    floats (half/single/double), simple values and tags (which are ignored).
+    Malformed or unsupported input is reported as
+    parse_error<const std::uint8_t*> with DiagError::InvalidEncoding.
+ */
+namespace cbor
+{
+
+using Bytes = std::vector<std::uint8_t>;
+using Error = parse_error<const std::uint8_t*>;
+
+Bytes dump(const Value& value);
+
+Value load(const Bytes& data, std::size_t maxDepth = defaultMaxDepth);
+Value load(const std::uint8_t* begin, const std::uint8_t* end,
+           std::size_t maxDepth = defaultMaxDepth);
+
+void parse(const std::uint8_t* begin, const std::uint8_t* end,
+           DispatchTarget& target,
+           std::size_t maxDepth = defaultMaxDepth);
+
+// Encodes parsing events, containers are written with indefinite length.
+class Encoder : public DispatchTarget
+{
+public:
+    Encoder();
+    ~Encoder();
+
+    const Bytes& bytes() const
+    {
+        return m_bytes;
+    }
+
+private:
+    void objectBeginImpl(const std::string& name) override;
+    void objectEndImpl() override;
+    void arrayBeginImpl() override;
+    void arrayEndImpl() override;
+    void nullValueImpl() override;
+    void boolValueImpl(bool v) override;
+    void integerValueImpl(int64_t v) override;
+    void doubleValueImpl(double v) override;
+    void stringValueImpl(const std::string& v) override;
+
+    Bytes m_bytes;
+    std::unique_ptr<Nesting> m_nesting;
+};
+
+}  // namespace cbor
+
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_CBOR_HPP
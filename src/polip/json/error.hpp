@@ -31,7 +31,15 @@ enum class DiagError
     Member,
     Array,
     Object,
-    Value
+    Value,
+    MaxDepthExceeded,
+    InvalidEncoding,
+    // beyond ParseLimits
+    DocumentTooLarge,
+    StringTooLong,
+    TooManyElements,
+    TooManyNodes,
+    NumberTooLong
 };
 
 struct error : std::exception {};
@@ -59,6 +67,25 @@ struct not_double : error {};
 struct not_string : error {};
 struct not_array : error {};
 struct not_object : error {};
+struct invalid_tape : error {};
+struct invalid_schema : error {};
+struct invalid_pointer : error {};
+struct invalid_patch : error {};
+struct patch_test_failed : error {};
+struct write_error : error {};
+// a BudgetResource would go beyond its limit
+struct budget_exceeded : error {};
+
+struct schema_violation : error
+{
+    schema_violation(const std::string& keyword_, const std::string& path_)
+        : keyword(keyword_), path(path_)
+    {
+    }
+
+    std::string keyword;  // of the failed assertion, e.g. "maxLength"
+    std::string path;     // JSON Pointer of the offending value
+};
 
 }
 }  // namespace polip::json
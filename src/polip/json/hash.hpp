@@ -0,0 +1,93 @@
+#ifndef INCLUDE_POLIP_JSON_HASH_HPP
+#define INCLUDE_POLIP_JSON_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include "polip/json/value.hpp"
+
+namespace polip
+{
+namespace json
+{
+
+/*
+    Structural hashes of a Value. They depend only on the contents, so they
+    are stable between runs and processes on platforms of the same byte
+    order. hash() follows operator== and is sensitive to the order of
+    object members. unorderedHash() ignores member order at every level,
+    array order still matters, and it follows unorderedEqual(). An int64_t
+    and a double never hash equal, as they never compare equal.
+ */
+std::uint64_t hash(const Value& value);
+std::uint64_t unorderedHash(const Value& value);
+
+// operator== where object members may come in any order, members sharing
+// a name have to keep their relative order
+bool unorderedEqual(const Value& lhs, const Value& rhs);
+
+/*
+    Immutable Value with its hash computed once. Equality rejects on a hash
+    mismatch in O(1), so it suits deduplication in hash tables.
+ */
+class HashedValue
+{
+public:
+    explicit HashedValue(Value value)
+        : m_value(std::move(value)), m_hash(json::hash(m_value))
+    {
+    }
+
+    const Value& value() const
+    {
+        return m_value;
+    }
+
+    std::uint64_t hash() const
+    {
+        return m_hash;
+    }
+
+private:
+    Value m_value;
+    std::uint64_t m_hash;
+};
+
+inline bool operator==(const HashedValue& lhs, const HashedValue& rhs)
+{
+    return lhs.hash() == rhs.hash() && lhs.value() == rhs.value();
+}
+
+inline bool operator!=(const HashedValue& lhs, const HashedValue& rhs)
+{
+    return !(lhs == rhs);
+}
+
+}
+}  // namespace polip::json
+
+namespace std
+{
+
+template <>
+struct hash<polip::json::Value>
+{
+    std::size_t operator()(const polip::json::Value& value) const
+    {
+        return static_cast<std::size_t>(polip::json::hash(value));
+    }
+};
+
+template <>
+struct hash<polip::json::HashedValue>
+{
+    std::size_t operator()(const polip::json::HashedValue& value) const
+    {
+        return static_cast<std::size_t>(value.hash());
+    }
+};
+
+}  // namespace std
+
+#endif  // INCLUDE_POLIP_JSON_HASH_HPP
@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "polip/json/batch.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+// chunks handed to each thread per batch, more of them balance uneven
+// document sizes better
+const std::size_t chunksPerThread = 16;
+
+struct Job
+{
+    const std::vector<std::string>* documents;
+    const pjson::ParseOptions* options;
+    std::vector<pjson::BatchResult>* results;
+    std::size_t chunk;
+    std::atomic<std::size_t> next;
+};
+
+void run(Job& job)
+{
+    const std::size_t size = job.documents->size();
+    for (;;) {
+        const std::size_t begin = job.next.fetch_add(job.chunk);
+        if (begin >= size) {
+            return;
+        }
+        const std::size_t end = std::min(size, begin + job.chunk);
+        for (std::size_t i = begin; i < end; ++i) {
+            pjson::BatchResult& result = (*job.results)[i];
+            try {
+                result.value = pjson::load((*job.documents)[i], *job.options);
+            } catch (...) {
+                result.error = std::current_exception();
+            }
+        }
+    }
+}
+
+}  // anonymous namespace
+
+struct pjson::BatchLoader::State
+{
+    std::vector<std::thread> workers;
+    // serializes load() calls
+    std::mutex batch;
+
+    std::mutex mutex;
+    std::condition_variable started;
+    std::condition_variable finished;
+    // guarded by mutex
+    Job* job = nullptr;
+    unsigned long generation = 0;
+    std::size_t active = 0;
+    bool stop = false;
+
+    void work()
+    {
+        unsigned long seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            started.wait(lock, [this, seen]() {
+                return stop || generation != seen;
+            });
+            if (stop) {
+                return;
+            }
+            seen = generation;
+            Job* current = job;
+            lock.unlock();
+            run(*current);
+            lock.lock();
+            if (--active == 0) {
+                finished.notify_one();
+            }
+        }
+    }
+};
+
+pjson::BatchLoader::BatchLoader(std::size_t threads) : m_state(new State)
+{
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (std::size_t i = 1; i < threads; ++i) {
+        m_state->workers.emplace_back(&State::work, m_state.get());
+    }
+}
+
+pjson::BatchLoader::~BatchLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->stop = true;
+    }
+    m_state->started.notify_all();
+    for (auto& worker : m_state->workers) {
+        worker.join();
+    }
+}
+
+std::size_t pjson::BatchLoader::threads() const
+{
+    return m_state->workers.size() + 1;
+}
+
+std::vector<pjson::BatchResult> pjson::BatchLoader::load(
+    const std::vector<std::string>& documents, const ParseOptions& options)
+{
+    std::vector<BatchResult> results(documents.size());
+    Job job;
+    job.documents = &documents;
+    job.options = &options;
+    job.results = &results;
+    job.chunk = std::max<std::size_t>(
+        1, documents.size() / (threads() * chunksPerThread));
+    job.next = 0;
+
+    std::lock_guard<std::mutex> batch(m_state->batch);
+    if (m_state->workers.empty() || documents.size() <= job.chunk) {
+        run(job);
+        return results;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->job = &job;
+        m_state->active = m_state->workers.size();
+        ++m_state->generation;
+    }
+    m_state->started.notify_all();
+    run(job);
+    std::unique_lock<std::mutex> lock(m_state->mutex);
+    m_state->finished.wait(lock, [this]() { return m_state->active == 0; });
+    m_state->job = nullptr;
+    return results;
+}
+
+std::vector<pjson::BatchResult> pjson::load_batch(
+    const std::vector<std::string>& documents, const ParseOptions& options,
+    std::size_t threads)
+{
+    return BatchLoader(threads).load(documents, options);
+}
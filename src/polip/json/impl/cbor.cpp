@@ -0,0 +1,480 @@
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "polip/json/cbor.hpp"
+#include "nesting.hpp"
+#include "value_builder.hpp"
+
+namespace pjson = polip::json;
+namespace cbor = polip::json::cbor;
+
+namespace
+{
+
+enum Major : std::uint8_t
+{
+    Unsigned = 0,
+    Negative = 1,
+    ByteString = 2,
+    TextString = 3,
+    ArrayItems = 4,
+    MapItems = 5,
+    Tag = 6,
+    Simple = 7
+};
+
+const std::uint8_t indefinite = 31;
+const std::uint8_t breakCode = 0xff;
+const std::uint8_t falseCode = 0xf4;
+const std::uint8_t trueCode = 0xf5;
+const std::uint8_t nullCode = 0xf6;
+const std::uint8_t undefinedCode = 0xf7;
+const std::uint8_t doubleCode = 0xfb;
+
+void writeHead(cbor::Bytes& out, Major major, std::uint64_t n)
+{
+    const std::uint8_t type = major << 5;
+    if (n < 24) {
+        out.push_back(type | static_cast<std::uint8_t>(n));
+        return;
+    }
+    unsigned size = 8;
+    if (n <= 0xff) {
+        out.push_back(type | 24);
+        size = 1;
+    } else if (n <= 0xffff) {
+        out.push_back(type | 25);
+        size = 2;
+    } else if (n <= 0xffffffff) {
+        out.push_back(type | 26);
+        size = 4;
+    } else {
+        out.push_back(type | 27);
+    }
+    while (size-- > 0) {
+        out.push_back(static_cast<std::uint8_t>(n >> (size * 8)));
+    }
+}
+
+void writeInteger(cbor::Bytes& out, int64_t v)
+{
+    if (v >= 0) {
+        writeHead(out, Unsigned, static_cast<std::uint64_t>(v));
+    } else {
+        // -1 - v, without overflowing for the minimal value
+        writeHead(out, Negative, ~static_cast<std::uint64_t>(v));
+    }
+}
+
+void writeDouble(cbor::Bytes& out, double v)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    out.push_back(doubleCode);
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<std::uint8_t>(bits >> shift));
+    }
+}
+
+void writeText(cbor::Bytes& out, const std::string& v)
+{
+    writeHead(out, TextString, v.size());
+    out.insert(out.end(), v.begin(), v.end());
+}
+
+class Writer : public boost::static_visitor<void>
+{
+public:
+    explicit Writer(cbor::Bytes& out) : m_out(out)
+    {
+    }
+
+    void operator()(const pjson::Null&) const
+    {
+        m_out.push_back(nullCode);
+    }
+
+    void operator()(bool v) const
+    {
+        m_out.push_back(v ? trueCode : falseCode);
+    }
+
+    void operator()(int64_t v) const
+    {
+        writeInteger(m_out, v);
+    }
+
+    void operator()(double v) const
+    {
+        writeDouble(m_out, v);
+    }
+
+    void operator()(const std::string& v) const
+    {
+        writeText(m_out, v);
+    }
+
+    void operator()(const pjson::Array& array) const
+    {
+        writeHead(m_out, ArrayItems, array.size());
+        for (auto const& item : array) {
+            boost::apply_visitor(*this, item);
+        }
+    }
+
+    void operator()(const pjson::Object& object) const
+    {
+        writeHead(m_out, MapItems, object.size());
+        for (auto const& pair : object) {
+            writeText(m_out, pair.first);
+            boost::apply_visitor(*this, pair.second);
+        }
+    }
+
+private:
+    cbor::Bytes& m_out;
+};
+
+double halfToDouble(std::uint16_t half)
+{
+    const int exponent = (half >> 10) & 0x1f;
+    const int mantissa = half & 0x3ff;
+    double v;
+    if (exponent == 0) {
+        v = std::ldexp(mantissa, -24);
+    } else if (exponent != 31) {
+        v = std::ldexp(mantissa + 1024, exponent - 25);
+    } else {
+        v = mantissa == 0 ? std::numeric_limits<double>::infinity()
+                          : std::numeric_limits<double>::quiet_NaN();
+    }
+    return (half & 0x8000) ? -v : v;
+}
+
+// Decodes with an explicit stack of open containers, like StackParser.
+class Decoder
+{
+public:
+    Decoder(const std::uint8_t* begin, const std::uint8_t* end,
+            std::size_t maxDepth)
+        : m_begin(begin), m_end(end), m_it(begin), m_maxDepth(maxDepth)
+    {
+    }
+
+    template <typename Target>
+    void parse(Target& target);
+
+private:
+    struct Frame
+    {
+        bool map;
+        bool indefinite;
+        std::uint64_t remaining;  // items, or members of a map
+    };
+
+    void fail(pjson::DiagError issue = pjson::DiagError::InvalidEncoding) const
+    {
+        throw cbor::Error{issue, m_begin, m_end, m_it, ""};
+    }
+
+    std::uint8_t byte()
+    {
+        if (m_it == m_end) {
+            fail();
+        }
+        return *m_it++;
+    }
+
+    std::uint64_t word(unsigned size)
+    {
+        if (static_cast<std::size_t>(m_end - m_it) < size) {
+            fail();
+        }
+        std::uint64_t n = 0;
+        while (size-- > 0) {
+            n = (n << 8) | *m_it++;
+        }
+        return n;
+    }
+
+    // the argument of a head, info < 28
+    std::uint64_t argument(std::uint8_t info)
+    {
+        if (info < 24) {
+            return info;
+        }
+        if (info > 27) {
+            fail();
+        }
+        return word(1u << (info - 24));
+    }
+
+    void readText(std::uint8_t initial, std::string& out);
+
+    template <typename Target>
+    void readItem(std::uint8_t initial, Target& target);
+
+    template <typename Target>
+    void close(Target& target);
+
+    const std::uint8_t* m_begin;
+    const std::uint8_t* m_end;
+    const std::uint8_t* m_it;
+    std::size_t m_maxDepth;
+    std::vector<Frame> m_stack;
+    std::string m_text;
+};
+
+void Decoder::readText(std::uint8_t initial, std::string& out)
+{
+    if ((initial >> 5) != TextString) {
+        fail();
+    }
+    const std::uint8_t info = initial & 0x1f;
+    if (info == indefinite) {
+        // concatenation of definite length chunks
+        for (std::uint8_t chunk = byte(); chunk != breakCode; chunk = byte()) {
+            if ((chunk & 0x1f) == indefinite) {
+                fail();
+            }
+            readText(chunk, out);
+        }
+        return;
+    }
+    const std::uint64_t size = argument(info);
+    if (size > static_cast<std::uint64_t>(m_end - m_it)) {
+        fail();
+    }
+    out.append(reinterpret_cast<const char*>(m_it), size);
+    m_it += size;
+}
+
+template <typename Target>
+void Decoder::readItem(std::uint8_t initial, Target& target)
+{
+    while ((initial >> 5) == Tag) {
+        argument(initial & 0x1f);
+        initial = byte();
+    }
+    const std::uint8_t info = initial & 0x1f;
+    switch (initial >> 5) {
+        case Unsigned: {
+            const std::uint64_t n = argument(info);
+            if (n > static_cast<std::uint64_t>(
+                        std::numeric_limits<int64_t>::max())) {
+                target.doubleValue(static_cast<double>(n));
+            } else {
+                target.integerValue(static_cast<int64_t>(n));
+            }
+            break;
+        }
+        case Negative: {
+            const std::uint64_t n = argument(info);
+            if (n > static_cast<std::uint64_t>(
+                        std::numeric_limits<int64_t>::max())) {
+                target.doubleValue(-1.0 - static_cast<double>(n));
+            } else {
+                target.integerValue(-1 - static_cast<int64_t>(n));
+            }
+            break;
+        }
+        case TextString:
+            m_text.clear();
+            readText(initial, m_text);
+            target.stringValue(m_text);
+            break;
+        case ArrayItems:
+        case MapItems: {
+            if (m_stack.size() >= m_maxDepth) {
+                fail(pjson::DiagError::MaxDepthExceeded);
+            }
+            const bool map = (initial >> 5) == MapItems;
+            const bool unbounded = info == indefinite;
+            m_stack.push_back(Frame{map, unbounded,
+                                    unbounded ? 0 : argument(info)});
+            if (!map) {
+                target.arrayBegin();
+            }
+            break;
+        }
+        case Simple:
+            switch (initial) {
+                case falseCode:
+                    target.boolValue(false);
+                    break;
+                case trueCode:
+                    target.boolValue(true);
+                    break;
+                case nullCode:
+                case undefinedCode:
+                    target.nullValue();
+                    break;
+                case 0xf9:
+                    target.doubleValue(
+                        halfToDouble(static_cast<std::uint16_t>(word(2))));
+                    break;
+                case 0xfa: {
+                    const std::uint32_t bits =
+                        static_cast<std::uint32_t>(word(4));
+                    float v;
+                    std::memcpy(&v, &bits, sizeof(v));
+                    target.doubleValue(v);
+                    break;
+                }
+                case doubleCode: {
+                    const std::uint64_t bits = word(8);
+                    double v;
+                    std::memcpy(&v, &bits, sizeof(v));
+                    target.doubleValue(v);
+                    break;
+                }
+                default:
+                    fail();
+            }
+            break;
+        default:
+            // byte strings have no JSON counterpart
+            fail();
+    }
+}
+
+template <typename Target>
+void Decoder::close(Target& target)
+{
+    const bool map = m_stack.back().map;
+    m_stack.pop_back();
+    if (map) {
+        target.objectEnd();
+    } else {
+        target.arrayEnd();
+    }
+}
+
+template <typename Target>
+void Decoder::parse(Target& target)
+{
+    readItem(byte(), target);
+    while (!m_stack.empty()) {
+        Frame& top = m_stack.back();
+        if (!top.indefinite && top.remaining == 0) {
+            close(target);
+            continue;
+        }
+        std::uint8_t initial = byte();
+        if (top.indefinite && initial == breakCode) {
+            close(target);
+            continue;
+        }
+        if (!top.indefinite) {
+            --top.remaining;
+        }
+        if (top.map) {
+            m_text.clear();
+            readText(initial, m_text);
+            target.objectBegin(m_text);
+            initial = byte();
+        }
+        if (initial == breakCode) {
+            fail();
+        }
+        readItem(initial, target);
+    }
+    if (m_it != m_end) {
+        fail();
+    }
+}
+
+}  // anonymous namespace
+
+cbor::Bytes cbor::dump(const Value& value)
+{
+    Bytes out;
+    boost::apply_visitor(Writer(out), value);
+    return out;
+}
+
+pjson::Value cbor::load(const Bytes& data, std::size_t maxDepth)
+{
+    return load(data.data(), data.data() + data.size(), maxDepth);
+}
+
+pjson::Value cbor::load(const std::uint8_t* begin, const std::uint8_t* end,
+                        std::size_t maxDepth)
+{
+    ValueBuilder builder;
+    Decoder(begin, end, maxDepth).parse(builder);
+    return std::move(builder.result());
+}
+
+void cbor::parse(const std::uint8_t* begin, const std::uint8_t* end,
+                 DispatchTarget& target, std::size_t maxDepth)
+{
+    Decoder(begin, end, maxDepth).parse(target);
+}
+
+cbor::Encoder::Encoder() : m_nesting(new Nesting)
+{
+}
+
+cbor::Encoder::~Encoder()
+{
+}
+
+void cbor::Encoder::objectBeginImpl(const std::string& name)
+{
+    if (m_nesting->member()) {
+        m_bytes.push_back((MapItems << 5) | indefinite);
+    }
+    writeText(m_bytes, name);
+}
+
+void cbor::Encoder::objectEndImpl()
+{
+    if (m_nesting->closeObject()) {
+        m_bytes.push_back(breakCode);
+    } else {
+        writeHead(m_bytes, MapItems, 0);
+    }
+}
+
+void cbor::Encoder::arrayBeginImpl()
+{
+    m_nesting->openArray();
+    m_bytes.push_back((ArrayItems << 5) | indefinite);
+}
+
+void cbor::Encoder::arrayEndImpl()
+{
+    m_nesting->closeArray();
+    m_bytes.push_back(breakCode);
+}
+
+void cbor::Encoder::nullValueImpl()
+{
+    m_nesting->value();
+    m_bytes.push_back(nullCode);
+}
+
+void cbor::Encoder::boolValueImpl(bool v)
+{
+    m_nesting->value();
+    m_bytes.push_back(v ? trueCode : falseCode);
+}
+
+void cbor::Encoder::integerValueImpl(int64_t v)
+{
+    m_nesting->value();
+    writeInteger(m_bytes, v);
+}
+
+void cbor::Encoder::doubleValueImpl(double v)
+{
+    m_nesting->value();
+    writeDouble(m_bytes, v);
+}
+
+void cbor::Encoder::stringValueImpl(const std::string& v)
+{
+    m_nesting->value();
+    writeText(m_bytes, v);
+}
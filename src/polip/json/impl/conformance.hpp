@@ -0,0 +1,97 @@
+#ifndef INCLUDE_POLIP_JSON_IMPL_CONFORMANCE_HPP
+#define INCLUDE_POLIP_JSON_IMPL_CONFORMANCE_HPP
+
+#include <boost/spirit/include/qi_real.hpp>
+#include "polip/json/parser.hpp"
+
+namespace polip
+{
+namespace json
+{
+
+// Number syntax of RFC 4627: digits are required on both sides of the
+// decimal point and there is no textual representation of NaN/infinity.
+template <typename T>
+struct RfcRealPolicies : boost::spirit::qi::real_policies<T>
+{
+    static bool const allow_leading_dot = false;
+    static bool const allow_trailing_dot = false;
+
+    template <typename Iterator, typename Attribute>
+    static bool parse_nan(Iterator&, Iterator const&, Attribute&)
+    {
+        return false;
+    }
+
+    template <typename Iterator, typename Attribute>
+    static bool parse_inf(Iterator&, Iterator const&, Attribute&)
+    {
+        return false;
+    }
+};
+
+/*
+    Conformance policies, the grammars are specialized on them at compile
+    time so each level gets a parser without the checks of the other one.
+ */
+
+struct StrictConformance
+{
+    static const Conformance level = Conformance::Strict;
+
+    // RFC 4627: JSON-text = object / array
+    static const bool anyValueDocument = false;
+    static const bool comments = false;
+    static const bool trailingCommas = false;
+    static const bool singleQuotes = false;
+
+    static const char* escapes()
+    {
+        return "\"\\/bfnrt";
+    }
+
+    using RealPolicies = RfcRealPolicies<double>;
+};
+
+struct RelaxedConformance
+{
+    static const Conformance level = Conformance::Relaxed;
+
+    static const bool anyValueDocument = true;
+    // // and /* */ comments wherever white space may be
+    static const bool comments = true;
+    // after the last item of an array or member of an object
+    static const bool trailingCommas = true;
+    // strings in '' as well, " needs no escape in them
+    static const bool singleQuotes = true;
+
+    // \v and \' are accepted on top of the RFC set
+    static const char* escapes()
+    {
+        return "\"\\/bfnrtv'";
+    }
+
+    // nan, inf and infinity in any case, so NaN and Infinity as written by
+    // Python as well
+    using RealPolicies = boost::spirit::qi::real_policies<double>;
+};
+
+template <Conformance Level>
+struct ConformancePolicy;
+
+template <>
+struct ConformancePolicy<Conformance::Strict>
+{
+    using type = StrictConformance;
+};
+
+template <>
+struct ConformancePolicy<Conformance::Relaxed>
+{
+    using type = RelaxedConformance;
+};
+
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_IMPL_CONFORMANCE_HPP
@@ -1,18 +1,54 @@
-#include <stdexcept>
+#include <cstddef>
 #include "diagnostics.hpp"
 
 namespace pjson = polip::json;
 
-void pjson::Diagnostics::add(const std::string& ruleName, DiagError issue)
+namespace
 {
-    if(!m_diags.insert(std::make_pair(ruleName, issue)).second)
-    {
-        throw std::runtime_error("diagnostic already added");
-    }
+
+struct RuleDiag
+{
+    const char* name;
+    pjson::DiagError issue;
+};
+
+// indexed by RuleId
+const RuleDiag rules[] = {
+    {"null-text", pjson::DiagError::Null},
+    {"[", pjson::DiagError::ExpectedArrayBegin},
+    {"]", pjson::DiagError::ExpectedArrayEnd},
+    {"{", pjson::DiagError::ExpectedObjectBegin},
+    {"}", pjson::DiagError::ExpectedObjectEnd},
+    {",", pjson::DiagError::Coma},
+    {":", pjson::DiagError::Colon},
+    {"depth", pjson::DiagError::MaxDepthExceeded},
+    {"null", pjson::DiagError::Null},
+    {"int", pjson::DiagError::Int},
+    {"double", pjson::DiagError::Double},
+    {"string", pjson::DiagError::String},
+    {"member", pjson::DiagError::Member},
+    {"array", pjson::DiagError::Array},
+    {"object", pjson::DiagError::Object},
+    {"value", pjson::DiagError::Value},
+    {"chars", pjson::DiagError::ExpectedUnicodeChar},
+    {"unescaped", pjson::DiagError::ExpectedString},
+    {"escaped", pjson::DiagError::ExpectedSpecialChar},
+    {"special-char", pjson::DiagError::InvalidSpecialChar},
+    {"\\", pjson::DiagError::ExpectedEscape},
+    {"\"", pjson::DiagError::ExpectedQuot}};
+
+static_assert(sizeof(rules) / sizeof(rules[0]) ==
+                  static_cast<std::size_t>(pjson::RuleId::Count),
+              "diagnostics table out of sync with RuleId");
+
+}  // anonymous namespace
+
+const char* pjson::Diagnostics::name(RuleId rule)
+{
+    return rules[static_cast<std::size_t>(rule)].name;
 }
 
-pjson::DiagError pjson::Diagnostics::get(const std::string& ruleName) const
+pjson::DiagError pjson::Diagnostics::issue(RuleId rule)
 {
-    auto it = m_diags.find(ruleName);
-    return it == m_diags.end() ? DiagError::Other : it->second;
+    return rules[static_cast<std::size_t>(rule)].issue;
 }
@@ -1,8 +1,6 @@
 #ifndef INCLUDE_POLIP_JSON_IMPL_DIAGNOSTICS_HPP
 #define INCLUDE_POLIP_JSON_IMPL_DIAGNOSTICS_HPP
 
-#include <map>
-#include <string>
 #include "polip/json/error.hpp"
 
 namespace polip
@@ -10,17 +8,43 @@ namespace polip
 namespace json
 {
 
+// Identifiers of all named grammar rules. The error handler of a rule that
+// may fail an expectation is bound to its id, which indexes a static
+// rule -> DiagError table, so grammars carry no diagnostics state and a
+// failure is classified without looking at rule names.
+enum class RuleId : unsigned char
+{
+    NullText,
+    ArrayBegin,
+    ArrayEnd,
+    ObjectBegin,
+    ObjectEnd,
+    Comma,
+    Colon,
+    Depth,
+    Null,
+    Int,
+    Double,
+    String,
+    Member,
+    Array,
+    Object,
+    Value,
+    // QuotedUnicodeStringGrammar internals
+    Chars,
+    Unescaped,
+    Escaped,
+    SpecialChar,
+    Escape,
+    Quot,
+    Count
+};
+
 class Diagnostics
 {
 public:
-    template<typename... T>
-    Diagnostics(T&&... init) : m_diags{ std::forward<T>(init)... } {}
-
-    void add(const std::string& ruleName, DiagError issue);
-    DiagError get(const std::string& ruleName) const;
-
-private:
-    std::map<std::string, DiagError> m_diags;
+    static const char* name(RuleId rule);
+    static DiagError issue(RuleId rule);
 };
 
 }
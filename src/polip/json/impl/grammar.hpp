@@ -1,8 +1,12 @@
 #ifndef INCLUDE_POLIP_JSON_IMPL_GRAMMAR_HPP
 #define INCLUDE_POLIP_JSON_IMPL_GRAMMAR_HPP
 
-#include <functional>
+#include <cstddef>
+#include <iterator>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <boost/spirit/include/qi.hpp>
 #include <boost/spirit/include/phoenix_function.hpp>
 #include <boost/spirit/include/phoenix_operator.hpp>
@@ -11,7 +15,10 @@
 #include "polip/json/error.hpp"
 #include "polip/json/parser.hpp"
 #include "polip/json/value.hpp"
+#include "conformance.hpp"
 #include "diagnostics.hpp"
+#include "scanner.hpp"
+#include "value_builder.hpp"
 
 namespace qi = boost::spirit::qi;
 namespace ascii = boost::spirit::ascii;
@@ -22,7 +29,88 @@ namespace polip
 {
 namespace json
 {
+namespace details
+{
+
+BOOST_SPIRIT_TERMINAL(space_or_comment)
+
+// Skipper of white space and comments, the same loop as in the scanner
+// rather than a rule, which would be called through a boost::function
+// between any two tokens.
+struct SpaceOrCommentParser : qi::primitive_parser<SpaceOrCommentParser>
+{
+    template <typename Context, typename Iterator>
+    struct attribute
+    {
+        typedef boost::spirit::unused_type type;
+    };
+
+    template <typename Iterator, typename Context, typename Skipper,
+              typename Attribute>
+    bool parse(Iterator& first, const Iterator& last, Context&,
+               const Skipper&, Attribute&) const
+    {
+        Scanner<Iterator, RelaxedConformance> in(first, last);
+        in.skipSpace();
+        if (in.position() == first) {
+            return false;
+        }
+        first = in.position();
+        return true;
+    }
+
+    template <typename Context>
+    boost::spirit::info what(Context&) const
+    {
+        return boost::spirit::info("space_or_comment");
+    }
+};
 
+}  // namespace details
+}
+}  // namespace polip::json
+
+namespace boost
+{
+namespace spirit
+{
+
+template <>
+struct use_terminal<qi::domain, polip::json::details::tag::space_or_comment>
+    : mpl::true_
+{
+};
+
+namespace qi
+{
+
+template <typename Modifiers>
+struct make_primitive<polip::json::details::tag::space_or_comment, Modifiers>
+{
+    typedef polip::json::details::SpaceOrCommentParser result_type;
+
+    result_type operator()(unused_type, unused_type) const
+    {
+        return result_type();
+    }
+};
+
+}
+}
+}  // namespace boost::spirit::qi
+
+namespace polip
+{
+namespace json
+{
+
+// what the grammars of a conformance level skip between tokens
+template <typename Policy>
+using SkipperOf = typename std::conditional<
+    Policy::comments, details::space_or_comment_type, ascii::space_type>::type;
+
+// Rules that may fail an expectation start with one, e.g. eps > lit(']'),
+// so their own handler sees the failure and knows the rule it is bound to.
 template<typename Iterator>
 struct ErrorHandler
 {
@@ -30,20 +118,19 @@ struct ErrorHandler
     {
         struct result { typedef void type; };
 
-        void operator()(const Diagnostics& diagnostics, Iterator begin, Iterator end, Iterator where, const boost::spirit::info& info) const
+        void operator()(Iterator begin, Iterator end, Iterator where, RuleId rule) const
         {
-            std::cout << info << std::endl;
-            throw parse_error<Iterator>{ diagnostics.get(info.tag), begin, end, where, "" };
+            throw parse_error<Iterator>{ Diagnostics::issue(rule), begin, end, where, "" };
         }
     };
 
     phx::function<Handle> handle;
 };
 
-template <typename Iterator>
-struct DecInt64Grammar : qi::grammar<Iterator, int64_t(), ascii::space_type>
+template <typename Iterator, typename Skipper = ascii::space_type>
+struct DecInt64Grammar : qi::grammar<Iterator, int64_t(), Skipper>
 {
-    explicit DecInt64Grammar(const std::string& name = "int") : DecInt64Grammar::base_type(value, name)
+    explicit DecInt64Grammar(const std::string& name = Diagnostics::name(RuleId::Int)) : DecInt64Grammar::base_type(value, name)
     {
         using qi::lexeme;
         using qi::lit;
@@ -58,22 +145,23 @@ struct DecInt64Grammar : qi::grammar<Iterator, int64_t(), ascii::space_type>
             // exclude floating point
             !char_(".eE")];
     }
-    qi::rule<Iterator, int64_t(), ascii::space_type> value;
+    qi::rule<Iterator, int64_t(), Skipper> value;
 };
 
-template <typename Iterator>
-struct DoubleGrammar : qi::grammar<Iterator, double(), ascii::space_type>
+template <typename Iterator, typename Policy = RelaxedConformance>
+struct DoubleGrammar : qi::grammar<Iterator, double(), SkipperOf<Policy>>
 {
-    explicit DoubleGrammar(const std::string& name = "double") : DoubleGrammar::base_type(value, name)
+    explicit DoubleGrammar(const std::string& name = Diagnostics::name(RuleId::Double)) : DoubleGrammar::base_type(value, name)
     {
         using qi::lexeme;
         using qi::lit;
         using ascii::digit;
-        using qi::double_;
+
+        qi::real_parser<double, typename Policy::RealPolicies> double_;
 
         value %= lexeme[!('+' | (-lit('-') >> '0' >> digit)) >> double_];
     }
-    qi::rule<Iterator, double(), ascii::space_type> value;
+    qi::rule<Iterator, double(), SkipperOf<Policy>> value;
 };
 
 struct AddSpecChar
@@ -98,7 +186,10 @@ struct AddSpecChar
                 s += '\r'; break;
             case 't':
                 s += '\t'; break;
+            case 'v':
+                s += '\v'; break;
             case '"':
+            case '\'':
             case '\\':
             case '/':
                 s += ch;
@@ -107,172 +198,265 @@ struct AddSpecChar
     }
 };
 
-template <typename Iterator>
+struct AddCodeUnit
+{
+    template <typename Sig>
+    struct result
+    {
+        typedef void type;
+    };
+
+    void operator()(std::string& s, unsigned unit) const
+    {
+        details::appendCodeUnit(s, unit);
+    }
+};
+
+template <typename Iterator, typename Policy = RelaxedConformance>
 struct QuotedUnicodeStringGrammar : qi::grammar<Iterator, std::string()>
 {
-    explicit QuotedUnicodeStringGrammar(const std::string& name = "string")
+    explicit QuotedUnicodeStringGrammar(const std::string& name = Diagnostics::name(RuleId::String))
         : QuotedUnicodeStringGrammar::base_type(value, name),
-          escape(qi::lit('\\'), "\\"),
-          quot(qi::lit('"'), "\"")
+          specialChar(qi::char_(Policy::escapes()), Diagnostics::name(RuleId::SpecialChar)),
+          escape(qi::lit('\\'), Diagnostics::name(RuleId::Escape)),
+          quot(qi::lit('"'), Diagnostics::name(RuleId::Quot)),
+          apostrophe(qi::lit('\''), Diagnostics::name(RuleId::Quot)),
+          closingQuot(qi::eps > qi::lit('"'), Diagnostics::name(RuleId::Quot)),
+          closingApostrophe(qi::eps > qi::lit('\''), Diagnostics::name(RuleId::Quot))
     {
-        value.name("value");
-        unescaped.name("unescaped");
-        escaped.name("escaped");
-
-        diags.add(value.name(), DiagError::ExpectedUnicodeChar);
-        diags.add(unescaped.name(), DiagError::ExpectedString);
-        diags.add(escaped.name(), DiagError::ExpectedSpecialChar);
-        diags.add(escape.name(), DiagError::ExpectedEscape); 
-        diags.add(quot.name(), DiagError::ExpectedQuot);
+        value.name(Diagnostics::name(RuleId::Chars));
+        unescaped.name(Diagnostics::name(RuleId::Unescaped));
+        escaped.name(Diagnostics::name(RuleId::Escaped));
+        escapedChar.name(Diagnostics::name(RuleId::SpecialChar));
 
         using qi::char_;
         using qi::_val;
 
         phx::function<AddSpecChar> addSpecChar;
-
-        /*
-            NOTE: TODO: support for unicode chars
-            Add support for \v special char (extended json)
-        */
-        escaped %= escape > char_("\"\\/bfnrt")[addSpecChar(qi::_r1, qi::_1)];
-        unescaped %= char_("\x20-\x21\x23-\x5b\x5d-\x7e");
-        value %= quot > *(escaped(_val) | unescaped) > quot;
+        phx::function<AddCodeUnit> addCodeUnit;
+        qi::uint_parser<unsigned, 16, 4, 4> hex4;
+
+        escaped %= escape > escapedChar(qi::_r1);
+        escapedChar = qi::eps > ((qi::lit('u') > hex4[addCodeUnit(qi::_r1, qi::_1)]) |
+                                 specialChar[addSpecChar(qi::_r1, qi::_1)]);
+        // any char but control chars, the quote and the backslash, bytes
+        // of UTF-8 sequences are taken as they are
+        unescaped %= ~char_("\x01-\x1f\"\\") - qi::lit('\0');
+        if (Policy::singleQuotes) {
+            // " instead of ' is unescaped in single quotes
+            apostrophed %= ~char_("\x01-\x1f'\\") - qi::lit('\0');
+            value %= (quot > *(escaped(_val) | unescaped) > closingQuot) |
+                     (apostrophe > *(escaped(_val) | apostrophed) >
+                      closingApostrophe);
+        } else {
+            value %= quot > *(escaped(_val) | unescaped) > closingQuot;
+        }
 
         using namespace boost::spirit::qi::labels;
-        qi::on_error<qi::fail>(value, failure.handle(phx::ref(diags), _1, _2, _3, _4));
-        qi::on_error<qi::fail>(unescaped, failure.handle(phx::ref(diags), _1, _2, _3, _4));
-        qi::on_error<qi::fail>(escaped, failure.handle(phx::ref(diags), _1, _2, _3, _4));
-        qi::on_error<qi::fail>(escape, failure.handle(phx::ref(diags), _1, _2, _3, _4));
-        qi::on_error<qi::fail>(quot, failure.handle(phx::ref(diags), _1, _2, _3, _4));
+        qi::on_error<qi::fail>(escapedChar, failure.handle(_1, _2, _3, RuleId::SpecialChar));
+        qi::on_error<qi::fail>(closingQuot, failure.handle(_1, _2, _3, RuleId::Quot));
+        qi::on_error<qi::fail>(closingApostrophe, failure.handle(_1, _2, _3, RuleId::Quot));
     }
 
     qi::rule<Iterator, std::string()> value;
     qi::rule<Iterator, std::string()> unescaped;
-    qi::rule<Iterator, void(std::string&)> escaped;
-    qi::rule<Iterator> escape, quot;
+    qi::rule<Iterator, std::string()> apostrophed;
+    qi::rule<Iterator, void(std::string&)> escaped, escapedChar;
+    qi::rule<Iterator, char()> specialChar;
+    qi::rule<Iterator> escape, quot, apostrophe, closingQuot, closingApostrophe;
 
     ErrorHandler<Iterator> failure;
-    Diagnostics diags;
 };
 
-template<typename Iterator>
+// Items and members of the containers open in one parse, as in
+// ValueBuilder: each container takes its own off the end with its exact
+// size when its closing bracket is seen, instead of growing a vector
+// attribute that the enclosing alternative then copies into a Value.
+struct ContainerScratch
+{
+    std::vector<pjson::Value> items;
+    std::vector<pjson::NameValue> members;
+};
+
+struct ScratchOps
+{
+    template <typename Sig>
+    struct result
+    {
+        typedef void type;
+    };
+
+    void operator()(ContainerScratch* scratch, pjson::Value& item) const
+    {
+        scratch->items.push_back(std::move(item));
+    }
+
+    void operator()(ContainerScratch* scratch, pjson::NameValue& member) const
+    {
+        scratch->members.push_back(std::move(member));
+    }
+};
+
+struct ScratchSize
+{
+    template <typename Sig>
+    struct result
+    {
+        typedef std::size_t type;
+    };
+
+    std::size_t operator()(ContainerScratch* scratch, bool object) const
+    {
+        return object ? scratch->members.size() : scratch->items.size();
+    }
+};
+
+struct CloseContainer
+{
+    template <typename Sig>
+    struct result
+    {
+        typedef void type;
+    };
+
+    void operator()(ContainerScratch* scratch, std::size_t start, bool object,
+                    pjson::Value& out) const
+    {
+        if (object) {
+            auto& members = scratch->members;
+            const auto first = members.begin() + start;
+            out = pjson::Object(std::make_move_iterator(first),
+                                std::make_move_iterator(members.end()));
+            members.erase(first, members.end());
+        } else {
+            auto& items = scratch->items;
+            const auto first = items.begin() + start;
+            out = pjson::Array(std::make_move_iterator(first),
+                               std::make_move_iterator(items.end()));
+            items.erase(first, items.end());
+        }
+        details::chargeStrings(out);
+    }
+};
+
+template<typename Iterator, typename Policy>
 struct Tokens
 {
     Tokens()
-        : nullText(qi::lit("null"), "null"),
-          arrayBegin(qi::lit("["), "["),
-          arrayEnd(qi::lit("]"), "]"),
-          objectBegin(qi::lit("{"), "{"),
-          objectEnd(qi::lit("}"), "}"),
-          comma(qi::lit(","), ","),
-          colon(qi::lit(":"), ":"),
-          null(std::string("null")),
-          int64(std::string("int")),
-          _double(std::string("double")),
-          string(std::string("string")),
-          member(std::string("member")),
-          array(std::string("array")),
-          object(std::string("object")),
-          value(std::string("value")),
-          diags(
-              std::initializer_list<std::pair<const std::string, DiagError>>{
-                  {"null", DiagError::Null},
-                  {"[", DiagError::ExpectedArrayBegin},
-                  {"]", DiagError::ExpectedArrayEnd},
-                  {"{", DiagError::ExpectedObjectBegin},
-                  {"}", DiagError::ExpectedObjectEnd},
-                  {",", DiagError::Coma},
-                  {":", DiagError::Colon},
-                  {"int", DiagError::Int},
-                  {"double", DiagError::Double},
-                  {"string", DiagError::String},
-                  {"member", DiagError::Member},
-                  {"array", DiagError::Array},
-                  {"object", DiagError::Object},
-                  {"value", DiagError::Value}})
+        : nullText(qi::lit("null"), Diagnostics::name(RuleId::NullText)),
+          arrayBegin(qi::lit("["), Diagnostics::name(RuleId::ArrayBegin)),
+          arrayEnd(qi::eps > qi::lit("]"), Diagnostics::name(RuleId::ArrayEnd)),
+          objectBegin(qi::lit("{"), Diagnostics::name(RuleId::ObjectBegin)),
+          objectEnd(qi::eps > qi::lit("}"), Diagnostics::name(RuleId::ObjectEnd)),
+          comma(qi::lit(","), Diagnostics::name(RuleId::Comma)),
+          colon(qi::eps > qi::lit(":"), Diagnostics::name(RuleId::Colon)),
+          depth(qi::eps > qi::eps(qi::_r1 > 0u), Diagnostics::name(RuleId::Depth)),
+          null(std::string(Diagnostics::name(RuleId::Null))),
+          member(std::string(Diagnostics::name(RuleId::Member))),
+          memberValue(std::string(Diagnostics::name(RuleId::Value))),
+          array(std::string(Diagnostics::name(RuleId::Array))),
+          object(std::string(Diagnostics::name(RuleId::Object))),
+          value(std::string(Diagnostics::name(RuleId::Value)))
     {
     }
 
     template<typename Attr>
-    using Rule = qi::rule<Iterator, Attr, ascii::space_type>;
+    using Rule = qi::rule<Iterator, Attr, SkipperOf<Policy>>;
+    // the local is where the items of the container start on the scratch
+    using ContainerRule = qi::rule<Iterator, pjson::Value(std::size_t, ContainerScratch*),
+                                   qi::locals<std::size_t>, SkipperOf<Policy>>;
 
     qi::rule<Iterator> nullText, arrayBegin, arrayEnd, objectBegin, objectEnd,
         comma, colon;
+    // passes while the remaining nesting budget is not exhausted
+    qi::rule<Iterator, void(std::size_t)> depth;
 
     Rule<pjson::Null()> null;
-    DecInt64Grammar<Iterator> int64;
-    DoubleGrammar<Iterator> _double;
-    QuotedUnicodeStringGrammar<Iterator> string;
-    Rule<pjson::NameValue()> member;
-    Rule<pjson::Array()> array;
-    Rule<pjson::Object()> object;
-    Rule<pjson::Value()> value;
+    DecInt64Grammar<Iterator, SkipperOf<Policy>> int64;
+    DoubleGrammar<Iterator, Policy> _double;
+    QuotedUnicodeStringGrammar<Iterator, Policy> string;
+    // the inherited attributes are the remaining nesting budget and the
+    // scratch stacks of the parse
+    Rule<pjson::NameValue(std::size_t, ContainerScratch*)> member;
+    Rule<pjson::Value(std::size_t, ContainerScratch*)> memberValue;
+    ContainerRule array;
+    ContainerRule object;
+    Rule<pjson::Value(std::size_t, ContainerScratch*)> value;
 
     ErrorHandler<Iterator> failure;
-    Diagnostics diags;
 };
 
-template <typename Iterator>
-class DispatchingExtendedGrammar : public qi::grammar<Iterator, ascii::space_type>
+template <typename Iterator, typename Policy = RelaxedConformance>
+struct ExtendedGrammar
+    : public qi::grammar<Iterator,
+                         pjson::Value(std::size_t, ContainerScratch*),
+                         SkipperOf<Policy>>
 {
-public:
-    DispatchingExtendedGrammar(DispatchTarget& target)
-        : DispatchingExtendedGrammar::base_type(json.value, "json"), m_target(target)
-    {
-        using ascii::char_;
-        using qi::lit;
-        namespace plc = std::placeholders;
-
-        json.null %= json.nullText;
-
-        json.array %=
-            json.arrayBegin[std::bind(&DispatchTarget::arrayBegin, &m_target)] >>
-            -(json.value % json.coma) >>
-            json.arrayEnd[std::bind(&DispatchTarget::arrayEnd, &m_target)];
-
-        json.object %=
-            json.objectBegin >>
-            -((json.string[std::bind(&DispatchTarget::objectBegin, &m_target, plc::_1)] >> json.colon >> json.value) % json.coma) >>
-            json.objectEnd[std::bind(&DispatchTarget::objectEnd, &m_target)];
-
-        json.value %=
-            (json.null[std::bind(&DispatchTarget::nullValue, &m_target)] |
-             qi::bool_[std::bind(&DispatchTarget::boolValue, &m_target, plc::_1)] |
-             json.int64[std::bind(&DispatchTarget::integerValue, &m_target, plc::_1)] |
-             json._double[std::bind(&DispatchTarget::doubleValue, &m_target, plc::_1)] |
-             json.string[std::bind(&DispatchTarget::stringValue, &m_target, plc::_1)] |
-             json.array | json.object);
-    }
+    using Error = parse_error<Iterator>;
 
-private:
-    DispatchTarget& m_target;
-    Tokens<Iterator> json;
+    ExtendedGrammar();
+
+    Tokens<Iterator, Policy> json;
+    typename Tokens<Iterator, Policy>::template Rule<pjson::Value(std::size_t, ContainerScratch*)> document;
 };
 
-template <typename Iterator>
-struct ExtendedGrammar
-    : public qi::grammar<Iterator, pjson::Value(), ascii::space_type>
+// defined out of the class, so that the extern declarations below keep the
+// rules from being built in every translation unit that uses the grammar
+template <typename Iterator, typename Policy>
+ExtendedGrammar<Iterator, Policy>::ExtendedGrammar()
+    : ExtendedGrammar::base_type(document, "json")
 {
-    using Error = parse_error<Iterator>;
-
-    ExtendedGrammar() : ExtendedGrammar::base_type(json.value, "json")
-    {
-        json.null %= json.nullText > qi::attr_type()(pjson::Null());
-        json.array %= json.arrayBegin >> -(json.value % json.comma) >> json.arrayEnd;
-        json.member %= json.string > json.colon > json.value;
-        json.object %= json.objectBegin > -(json.member % json.comma) > json.objectEnd;
-        json.value %= (json.null | qi::bool_ | json.int64 | json._double | json.string | json.array | json.object);
+    using qi::_r1;
+    using qi::_r2;
+    using qi::_a;
+    using qi::_1;
+    using qi::_val;
+
+    phx::function<ScratchOps> push;
+    phx::function<ScratchSize> size;
+    phx::function<CloseContainer> close;
+
+    if (Policy::anyValueDocument) {
+        document %= json.value(_r1, _r2);
+    } else {
+        document %= json.array(_r1, _r2) | json.object(_r1, _r2);
+    }
 
-        using namespace boost::spirit::qi::labels;
-        qi::on_error<qi::fail>(json.null, json.failure.handle(phx::ref(json.diags), _1, _2, _3, _4));
-        qi::on_error<qi::fail>(json.array, json.failure.handle(phx::ref(json.diags), _1, _2, _3, _4));
-        qi::on_error<qi::fail>(json.member, json.failure.handle(phx::ref(json.diags), _1, _2, _3, _4));
-        qi::on_error<qi::fail>(json.object, json.failure.handle(phx::ref(json.diags), _1, _2, _3, _4));
-        qi::on_error<qi::fail>(json.value, json.failure.handle(phx::ref(json.diags), _1, _2, _3, _4));
+    json.null %= json.nullText > qi::attr_type()(pjson::Null());
+    if (Policy::trailingCommas) {
+        json.array = json.arrayBegin > json.depth(_r1) > qi::eps[_a = size(_r2, false)] >
+                     -(json.value(_r1 - 1, _r2)[push(_r2, _1)] % json.comma >> -json.comma) >
+                     json.arrayEnd[close(_r2, _a, false, _val)];
+        json.object = json.objectBegin > json.depth(_r1) > qi::eps[_a = size(_r2, true)] >
+                      -(json.member(_r1 - 1, _r2)[push(_r2, _1)] % json.comma >> -json.comma) >
+                      json.objectEnd[close(_r2, _a, true, _val)];
+    } else {
+        json.array = json.arrayBegin > json.depth(_r1) > qi::eps[_a = size(_r2, false)] >
+                     -(json.value(_r1 - 1, _r2)[push(_r2, _1)] % json.comma) >
+                     json.arrayEnd[close(_r2, _a, false, _val)];
+        json.object = json.objectBegin > json.depth(_r1) > qi::eps[_a = size(_r2, true)] >
+                      -(json.member(_r1 - 1, _r2)[push(_r2, _1)] % json.comma) >
+                      json.objectEnd[close(_r2, _a, true, _val)];
     }
+    json.member %= json.string > json.colon > json.memberValue(_r1, _r2);
+    json.memberValue %= qi::eps > json.value(_r1, _r2);
+    json.value %= (json.null | qi::bool_ | json.int64 | json._double | json.string | json.array(_r1, _r2) | json.object(_r1, _r2));
+
+    using namespace boost::spirit::qi::labels;
+    qi::on_error<qi::fail>(json.arrayEnd, json.failure.handle(_1, _2, _3, RuleId::ArrayEnd));
+    qi::on_error<qi::fail>(json.objectEnd, json.failure.handle(_1, _2, _3, RuleId::ObjectEnd));
+    qi::on_error<qi::fail>(json.colon, json.failure.handle(_1, _2, _3, RuleId::Colon));
+    qi::on_error<qi::fail>(json.depth, json.failure.handle(_1, _2, _3, RuleId::Depth));
+    qi::on_error<qi::fail>(json.memberValue, json.failure.handle(_1, _2, _3, RuleId::Value));
+}
 
-    Tokens<Iterator> json;
-};
+// instantiated in parser_pointer.cpp and parser_string.cpp
+extern template struct ExtendedGrammar<const char*, RelaxedConformance>;
+extern template struct ExtendedGrammar<const char*, StrictConformance>;
+extern template struct ExtendedGrammar<std::string::const_iterator,
+                                       RelaxedConformance>;
+extern template struct ExtendedGrammar<std::string::const_iterator,
+                                       StrictConformance>;
 
 }
 }  // namespace polip::json
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "polip/json/hash.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+// finalizer of MurmurHash3
+std::uint64_t fmix(std::uint64_t k)
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdull;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ull;
+    k ^= k >> 33;
+    return k;
+}
+
+std::uint64_t combine(std::uint64_t h, std::uint64_t v)
+{
+    return fmix(h ^ (v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2)));
+}
+
+std::uint64_t hashString(const std::string& v)
+{
+    std::uint64_t h = fmix('s' ^ (v.size() << 8));
+    const char* it = v.data();
+    const char* end = it + v.size();
+    for (; end - it >= 8; it += 8) {
+        std::uint64_t chunk;
+        std::memcpy(&chunk, it, sizeof(chunk));
+        h = combine(h, chunk);
+    }
+    if (it != end) {
+        std::uint64_t chunk = 0;
+        std::memcpy(&chunk, it, end - it);
+        h = combine(h, chunk);
+    }
+    return h;
+}
+
+class Hasher : public boost::static_visitor<std::uint64_t>
+{
+public:
+    explicit Hasher(bool unordered) : m_unordered(unordered)
+    {
+    }
+
+    std::uint64_t operator()(const pjson::Null&) const
+    {
+        return fmix('n');
+    }
+
+    std::uint64_t operator()(bool v) const
+    {
+        return fmix(v ? 't' : 'f');
+    }
+
+    std::uint64_t operator()(int64_t v) const
+    {
+        return combine('l', static_cast<std::uint64_t>(v));
+    }
+
+    std::uint64_t operator()(double v) const
+    {
+        // -0.0 == 0.0
+        if (v == 0) {
+            v = 0;
+        }
+        std::uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        return combine('d', bits);
+    }
+
+    std::uint64_t operator()(const std::string& v) const
+    {
+        return hashString(v);
+    }
+
+    std::uint64_t operator()(const pjson::Array& array) const
+    {
+        std::uint64_t h = fmix('[' ^ (array.size() << 8));
+        for (auto const& item : array) {
+            h = combine(h, boost::apply_visitor(*this, item));
+        }
+        return h;
+    }
+
+    std::uint64_t operator()(const pjson::Object& object) const
+    {
+        std::uint64_t h = fmix('{' ^ (object.size() << 8));
+        if (!m_unordered) {
+            for (auto const& pair : object) {
+                h = combine(h, hashString(pair.first));
+                h = combine(h, boost::apply_visitor(*this, pair.second));
+            }
+            return h;
+        }
+        // a commutative sum of the members
+        std::uint64_t sum = 0;
+        for (auto const& pair : object) {
+            sum += combine(hashString(pair.first),
+                           boost::apply_visitor(*this, pair.second));
+        }
+        return combine(h, sum);
+    }
+
+private:
+    bool m_unordered;
+};
+
+bool lessName(const pjson::NameValue* lhs, const pjson::NameValue* rhs)
+{
+    return lhs->first < rhs->first;
+}
+
+struct UnorderedEqual : public boost::static_visitor<bool>
+{
+    template <typename T, typename U>
+    bool operator()(const T&, const U&) const
+    {
+        return false;
+    }
+
+    template <typename T>
+    bool operator()(const T& lhs, const T& rhs) const
+    {
+        return lhs == rhs;
+    }
+
+    bool operator()(const pjson::Array& lhs, const pjson::Array& rhs) const
+    {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < lhs.size(); ++i) {
+            if (!pjson::unorderedEqual(lhs[i], rhs[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator()(const pjson::Object& lhs, const pjson::Object& rhs) const
+    {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        // members of the same name keep their relative order
+        std::vector<const pjson::NameValue*> left;
+        std::vector<const pjson::NameValue*> right;
+        left.reserve(lhs.size());
+        right.reserve(rhs.size());
+        for (std::size_t i = 0; i < lhs.size(); ++i) {
+            left.push_back(&lhs[i]);
+            right.push_back(&rhs[i]);
+        }
+        std::stable_sort(left.begin(), left.end(), lessName);
+        std::stable_sort(right.begin(), right.end(), lessName);
+        for (std::size_t i = 0; i < left.size(); ++i) {
+            if (left[i]->first != right[i]->first ||
+                !pjson::unorderedEqual(left[i]->second, right[i]->second)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+}  // anonymous namespace
+
+std::uint64_t pjson::hash(const Value& value)
+{
+    return boost::apply_visitor(Hasher(false), value);
+}
+
+std::uint64_t pjson::unorderedHash(const Value& value)
+{
+    return boost::apply_visitor(Hasher(true), value);
+}
+
+bool pjson::unorderedEqual(const Value& lhs, const Value& rhs)
+{
+    return boost::apply_visitor(UnorderedEqual(), lhs.get(), rhs.get());
+}
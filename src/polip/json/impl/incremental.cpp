@@ -0,0 +1,551 @@
+#include <algorithm>
+#include <vector>
+#include "polip/json/incremental.hpp"
+#include "stack_parser.hpp"
+#include "value_builder.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+// chars that end a number or literal
+bool endsScalar(char c)
+{
+    switch (c) {
+        case ',':
+        case ':':
+        case '[':
+        case ']':
+        case '{':
+        case '}':
+        case '"':
+        case '\'':
+        case '/':
+            return true;
+    }
+    return pjson::Scanner<const char*,
+                          pjson::StrictConformance>::isSpace(c);
+}
+
+// the four hex digits of a \\u escape
+bool isHex(const char* digits)
+{
+    return std::all_of(digits, digits + 4, [](char c) {
+        return pjson::details::hexDigit(c) >= 0;
+    });
+}
+
+class ChunkReader
+{
+public:
+    virtual ~ChunkReader() {}
+
+    // reads the tokens that are complete in [begin, end), all of them when
+    // last; returns the length read, the rest is the start of a token to
+    // be passed again with more input
+    virtual std::size_t read(const char* begin, const char* end,
+                             bool last) = 0;
+
+    virtual bool done() const = 0;
+};
+
+/*
+    The states of StackParser made resumable: the parse stops before a
+    token that is not complete yet and carries on from there with the
+    next chunk. Only strings and scalars can be cut, the other tokens are
+    single chars and white space is passed over as it comes.
+ */
+template <typename Policy>
+class BasicChunkReader final : public ChunkReader
+{
+public:
+    BasicChunkReader(pjson::DispatchTarget& target,
+                     const pjson::ParseOptions& options)
+        : m_target(target), m_maxDepth(options.maxDepth),
+          m_limits(options.limits)
+    {
+    }
+
+    std::size_t read(const char* begin, const char* end, bool last) override;
+
+    bool done() const override
+    {
+        return m_state == State::Done;
+    }
+
+private:
+    using Input = pjson::Scanner<const char*, Policy>;
+
+    enum class State
+    {
+        Start,
+        Value,
+        FirstItem,    // array opened
+        FirstMember,  // object opened
+        Member,
+        Colon,
+        Next,
+        Skip,         // inside a skipped container
+        Done
+    };
+
+    enum class Scope : char
+    {
+        Array,
+        Object
+    };
+
+    // whether all of the string or scalar at is in [at, end)
+    bool complete(const char* at, const char* end, bool last);
+    void enter(Input& in, Scope scope);
+    void leave();
+    // the state after a value
+    State valueDone();
+    // see StackParser
+    void countValue(const Input& in);
+    void countElement(const Input& in);
+
+    pjson::DiagError invalidValue() const
+    {
+        if (m_scopes.empty()) {
+            return pjson::DiagError::Other;
+        }
+        return m_scopes.back() == Scope::Array
+                   ? pjson::DiagError::ExpectedArrayEnd
+                   : pjson::DiagError::Value;
+    }
+
+    pjson::DispatchTarget& m_target;
+    std::size_t m_maxDepth;
+    pjson::ParseLimits m_limits;
+    State m_state = State::Start;
+    std::vector<Scope> m_scopes;
+    std::vector<std::size_t> m_counts;
+    std::size_t m_elements = 0;
+    std::size_t m_nodes = 0;
+    bool m_counted = false;  // the value of the Value state
+    bool m_skipMember = false;  // the value belongs to a skipped member
+    char m_skipped = '\0';      // opening bracket of the skipped container
+    pjson::details::BracketCounter<Policy> m_counter;
+    // length of the cut token already searched for its end
+    std::size_t m_scanned = 0;
+    // escapes in it, if a string
+    std::size_t m_escapes = 0;
+    std::string m_name;
+    std::string m_text;
+};
+
+template <typename Policy>
+std::size_t BasicChunkReader<Policy>::read(const char* begin,
+                                           const char* end, bool last)
+{
+    Input in(begin, end);
+    // kept local in the loop, the target could alias a member
+    State state = m_state;
+    for (;;) {
+        if (state == State::Skip) {
+            const char* const it =
+                pjson::details::skipContainer(in.position(), end, m_counter);
+            if (m_counter.depth() != 0 || m_counter.inString()) {
+                if (!last) {
+                    m_state = state;
+                    return static_cast<std::size_t>(end - begin);
+                }
+                Input(begin, end, end).fail(
+                    m_counter.inString() ? pjson::DiagError::ExpectedQuot
+                    : m_skipped == '['   ? pjson::DiagError::ExpectedArrayEnd
+                                         : pjson::DiagError::ExpectedObjectEnd);
+            }
+            in = Input(begin, end, it);
+            if (!m_skipMember && m_skipped == '[') {
+                m_target.arrayBegin();
+                m_target.arrayEnd();
+            } else if (!m_skipMember) {
+                m_target.objectEnd();
+            }
+            state = valueDone();
+            continue;
+        }
+
+        in.skipSpace(last);
+        if (in.atEnd() && (!last || state == State::Done)) {
+            m_state = state;
+            return static_cast<std::size_t>(end - begin);
+        }
+        if (!last && in.atComment()) {
+            m_state = state;
+            return static_cast<std::size_t>(in.position() - begin);
+        }
+        switch (state) {
+            case State::Start:
+                if (!Policy::anyValueDocument && !in.at('[') &&
+                    !in.at('{')) {
+                    in.fail(pjson::DiagError::Other);
+                }
+                state = State::Value;
+                break;
+
+            case State::FirstItem:
+                if (in.at(']')) {
+                    in.advance();
+                    leave();
+                    m_target.arrayEnd();
+                    state = valueDone();
+                } else {
+                    state = State::Value;
+                }
+                break;
+
+            // the states of a member follow each other without going
+            // through the loop as long as the chunk lasts
+            case State::FirstMember:
+                if (in.at('}')) {
+                    in.advance();
+                    leave();
+                    m_target.objectEnd();
+                    state = valueDone();
+                    break;
+                }
+                state = State::Member;
+                // fall through
+            case State::Member:
+                if (Policy::trailingCommas && in.at('}')) {
+                    // after a trailing comma
+                    in.advance();
+                    leave();
+                    m_target.objectEnd();
+                    state = valueDone();
+                    break;
+                }
+                if (!in.atString()) {
+                    in.fail(pjson::DiagError::ExpectedObjectEnd);
+                }
+                if (!complete(in.position(), end, last)) {
+                    m_state = state;
+                    return static_cast<std::size_t>(in.position() - begin);
+                }
+                countElement(in);
+                m_name.clear();
+                in.readString(m_name, m_limits.maxStringLength);
+                state = State::Colon;
+                in.skipSpace(last);
+                if (in.atEnd() || in.atComment()) {
+                    break;
+                }
+                // fall through
+            case State::Colon:
+                if (!in.at(':')) {
+                    in.fail(pjson::DiagError::Colon);
+                }
+                in.advance();
+                m_skipMember = m_target.skipMember(m_name);
+                if (!m_skipMember) {
+                    m_target.objectBegin(m_name);
+                }
+                state = State::Value;
+                in.skipSpace(last);
+                if (in.atEnd() || in.atComment()) {
+                    break;
+                }
+                // fall through
+            case State::Value: {
+                const char c = in.peek();
+                if (Policy::trailingCommas && c == ']' && !m_scopes.empty() &&
+                    m_scopes.back() == Scope::Array) {
+                    // after a trailing comma
+                    in.advance();
+                    leave();
+                    m_target.arrayEnd();
+                    state = valueDone();
+                    break;
+                }
+                if (!m_counted && !m_skipMember) {
+                    countValue(in);
+                    m_counted = true;
+                }
+                if (c == '[' || c == '{') {
+                    const bool skip =
+                        m_skipMember || (c == '[' ? m_target.skipArray()
+                                                  : m_target.skipObject());
+                    if (skip) {
+                        m_skipped = c;
+                        m_counter = pjson::details::BracketCounter<Policy>();
+                        state = State::Skip;
+                    } else if (c == '[') {
+                        enter(in, Scope::Array);
+                        m_target.arrayBegin();
+                        state = State::FirstItem;
+                    } else {
+                        enter(in, Scope::Object);
+                        state = State::FirstMember;
+                    }
+                    break;
+                }
+                if (!in.atEnd() && !complete(in.position(), end, last)) {
+                    m_state = state;
+                    return static_cast<std::size_t>(in.position() - begin);
+                }
+                if (m_skipMember) {
+                    in.skipValue();
+                } else if (!pjson::details::readScalar(in, m_text, m_target,
+                                                       m_limits)) {
+                    in.fail(invalidValue());
+                }
+                state = valueDone();
+                break;
+            }
+
+            case State::Next:
+                if (in.at(',')) {
+                    in.advance();
+                    state = m_scopes.back() == Scope::Array ? State::Value
+                                                              : State::Member;
+                } else if (m_scopes.back() == Scope::Array && in.at(']')) {
+                    in.advance();
+                    leave();
+                    m_target.arrayEnd();
+                    state = valueDone();
+                } else if (m_scopes.back() == Scope::Object && in.at('}')) {
+                    in.advance();
+                    leave();
+                    m_target.objectEnd();
+                    state = valueDone();
+                } else {
+                    in.fail(m_scopes.back() == Scope::Array
+                                ? pjson::DiagError::ExpectedArrayEnd
+                                : pjson::DiagError::ExpectedObjectEnd);
+                }
+                break;
+
+            case State::Skip:
+                break;
+
+            case State::Done:
+                in.fail(pjson::DiagError::Other);
+        }
+    }
+}
+
+template <typename Policy>
+bool BasicChunkReader<Policy>::complete(const char* at, const char* end,
+                                        bool last)
+{
+    if (last) {
+        return true;
+    }
+    // the search goes on where the previous chunk ended
+    const char* it = at + m_scanned;
+    if (*at == '"' || (Policy::singleQuotes && *at == '\'')) {
+        if (it == at) {
+            ++it;  // opening quote
+        }
+        for (;;) {
+            it = pjson::details::findQuote(it, end, *at);
+            if (it == end || (*it == '\\' && end - it < 2)) {
+                break;
+            }
+            if (*it == *at) {
+                m_scanned = 0;
+                m_escapes = 0;
+                return true;
+            }
+            if (it[1] == 'u' && end - it < 6) {
+                break;
+            }
+            if (it[1] == 'u' && isHex(it + 2)) {
+                // one byte at least for the six chars
+                it += 6;
+                m_escapes += 5;
+            } else {
+                it += 2;  // backslash and the escaped char
+                ++m_escapes;
+            }
+        }
+        // too long already, it is not held any longer
+        const std::size_t length =
+            static_cast<std::size_t>(it - at - 1) - m_escapes;
+        if (length > m_limits.maxStringLength) {
+            Input(at, end, at).fail(pjson::DiagError::StringTooLong);
+        }
+    } else {
+        // a number is not searched further than one char beyond the limit
+        const std::size_t limit = *at == '-' || (*at >= '0' && *at <= '9')
+                                      ? m_limits.maxNumberLength
+                                      : pjson::noLimit;
+        while (it != end && !endsScalar(*it)) {
+            ++it;
+            if (static_cast<std::size_t>(it - at) > limit) {
+                Input(at, end, at).fail(pjson::DiagError::NumberTooLong);
+            }
+        }
+        if (it != end) {
+            m_scanned = 0;
+            return true;
+        }
+    }
+    m_scanned = static_cast<std::size_t>(it - at);
+    return false;
+}
+
+template <typename Policy>
+void BasicChunkReader<Policy>::enter(Input& in, Scope scope)
+{
+    if (m_scopes.size() >= m_maxDepth) {
+        in.fail(pjson::DiagError::MaxDepthExceeded);
+    }
+    m_scopes.push_back(scope);
+    m_counts.push_back(m_elements);
+    m_elements = 0;
+    m_counted = false;
+    in.advance();
+}
+
+template <typename Policy>
+void BasicChunkReader<Policy>::leave()
+{
+    m_scopes.pop_back();
+    m_elements = m_counts.back();
+    m_counts.pop_back();
+}
+
+template <typename Policy>
+void BasicChunkReader<Policy>::countValue(const Input& in)
+{
+    if (++m_nodes > m_limits.maxNodes) {
+        in.fail(pjson::DiagError::TooManyNodes);
+    }
+    if (!m_scopes.empty() && m_scopes.back() == Scope::Array) {
+        countElement(in);
+    }
+}
+
+template <typename Policy>
+void BasicChunkReader<Policy>::countElement(const Input& in)
+{
+    if (++m_elements > m_limits.maxContainerElements) {
+        in.fail(pjson::DiagError::TooManyElements);
+    }
+}
+
+template <typename Policy>
+typename BasicChunkReader<Policy>::State BasicChunkReader<Policy>::valueDone()
+{
+    m_skipMember = false;
+    m_counted = false;
+    return m_scopes.empty() ? State::Done : State::Next;
+}
+
+std::unique_ptr<ChunkReader> makeReader(pjson::DispatchTarget& target,
+                                        const pjson::ParseOptions& options)
+{
+    if (options.level == pjson::Conformance::Strict) {
+        return std::unique_ptr<ChunkReader>(
+            new BasicChunkReader<pjson::StrictConformance>(target,
+                                                           options));
+    }
+    return std::unique_ptr<ChunkReader>(
+        new BasicChunkReader<pjson::RelaxedConformance>(target, options));
+}
+
+}  // anonymous namespace
+
+struct pjson::IncrementalParser::State
+{
+    // reads from [begin, end), the data of pending or of a chunk
+    void read(const char* begin, const char* end, bool last)
+    {
+        const ResourceScope scope(resource ? resource : currentResource());
+        std::size_t length = 0;
+        try {
+            length = reader->read(begin, end, last);
+        } catch (const parse_error<const char*>& e) {
+            throw Error{e.issue, 0, offset + (e.end - begin),
+                        offset + (e.where - begin), e.info};
+        }
+        offset += length;
+        if (pending.empty()) {
+            pending.assign(begin + length, end);
+        } else {
+            pending.erase(0, length);
+        }
+    }
+
+    // a chunk of size bytes arrives
+    void count(std::size_t size)
+    {
+        fed += size;
+        if (fed > maxBytes) {
+            throw Error{DiagError::DocumentTooLarge, 0, fed, maxBytes, ""};
+        }
+    }
+
+    ValueBuilder values;
+    std::unique_ptr<ChunkReader> reader;
+    MemoryResource* resource = nullptr;
+    std::size_t maxBytes = noLimit;
+    std::size_t fed = 0;
+    // start of a token cut by the end of the last chunk
+    std::string pending;
+    // in the document of the first byte not read yet
+    std::size_t offset = 0;
+};
+
+pjson::IncrementalParser::IncrementalParser(DispatchTarget& target,
+                                            const ParseOptions& options)
+    : m_state(new State)
+{
+    m_state->reader = makeReader(target, options);
+    m_state->resource = options.resource;
+    m_state->maxBytes = options.limits.maxDocumentBytes;
+}
+
+pjson::IncrementalParser::IncrementalParser(const ParseOptions& options)
+    : m_state(new State)
+{
+    m_state->reader = makeReader(m_state->values, options);
+    m_state->resource = options.resource;
+    m_state->maxBytes = options.limits.maxDocumentBytes;
+}
+
+pjson::IncrementalParser::~IncrementalParser() = default;
+
+bool pjson::IncrementalParser::feed(const char* begin, const char* end)
+{
+    m_state->count(static_cast<std::size_t>(end - begin));
+    if (m_state->pending.empty()) {
+        m_state->read(begin, end, false);
+    } else {
+        std::string& pending = m_state->pending;
+        pending.append(begin, end);
+        m_state->read(pending.data(), pending.data() + pending.size(),
+                      false);
+    }
+    return done();
+}
+
+bool pjson::IncrementalParser::feed(const std::string& chunk)
+{
+    return feed(chunk.data(), chunk.data() + chunk.size());
+}
+
+void pjson::IncrementalParser::finish()
+{
+    const std::string& pending = m_state->pending;
+    m_state->read(pending.data(), pending.data() + pending.size(), true);
+}
+
+bool pjson::IncrementalParser::done() const
+{
+    return m_state->reader->done();
+}
+
+std::size_t pjson::IncrementalParser::buffered() const
+{
+    return m_state->pending.size();
+}
+
+pjson::Value& pjson::IncrementalParser::value()
+{
+    return m_state->values.result();
+}
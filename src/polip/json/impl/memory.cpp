@@ -0,0 +1,157 @@
+#include <limits>
+#include <new>
+#include <string>
+#include "polip/json/error.hpp"
+#include "polip/json/memory.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+thread_local pjson::MemoryResource* current = nullptr;
+
+// a block starts with the resource it came from and the bytes of strings
+// charged to it on behalf of the block, the header keeps the data after it
+// aligned for any type
+struct BlockHeader
+{
+    pjson::MemoryResource* resource;
+    std::size_t charged;
+};
+
+const std::size_t header = alignof(std::max_align_t);
+
+static_assert(sizeof(BlockHeader) <= header,
+              "the block header does not fit in front of the data");
+
+BlockHeader* headerOf(void* p)
+{
+    return static_cast<BlockHeader*>(
+        static_cast<void*>(static_cast<char*>(p) - header));
+}
+
+}  // anonymous namespace
+
+pjson::MemoryResource* pjson::currentResource()
+{
+    return current;
+}
+
+pjson::ResourceScope::ResourceScope(MemoryResource* resource)
+    : m_previous(current)
+{
+    current = resource;
+}
+
+pjson::ResourceScope::~ResourceScope()
+{
+    current = m_previous;
+}
+
+pjson::BudgetResource::BudgetResource(std::size_t limit,
+                                      MemoryResource* upstream)
+    : m_limit(limit), m_upstream(upstream)
+{
+}
+
+void pjson::BudgetResource::charge(std::size_t bytes)
+{
+    // committed only if it fits, so a charge going beyond the limit never
+    // shows in used() and makes others fail
+    std::size_t used = m_used;
+    do {
+        if (bytes > m_limit || used > m_limit - bytes) {
+            throw budget_exceeded{};
+        }
+    } while (!m_used.compare_exchange_weak(used, used + bytes));
+    used += bytes;
+    std::size_t peak = m_peak;
+    while (peak < used && !m_peak.compare_exchange_weak(peak, used)) {
+    }
+}
+
+void pjson::BudgetResource::release(std::size_t bytes) noexcept
+{
+    m_used -= bytes;
+}
+
+void* pjson::BudgetResource::do_allocate(std::size_t bytes,
+                                         std::size_t alignment)
+{
+    charge(bytes);
+    try {
+        return m_upstream ? m_upstream->allocate(bytes, alignment)
+                          : ::operator new(bytes);
+    } catch (...) {
+        release(bytes);
+        throw;
+    }
+}
+
+void pjson::BudgetResource::do_deallocate(void* p, std::size_t bytes,
+                                          std::size_t alignment)
+{
+    if (m_upstream) {
+        m_upstream->deallocate(p, bytes, alignment);
+    } else {
+        ::operator delete(p);
+    }
+    release(bytes);
+}
+
+bool pjson::BudgetResource::do_is_equal(
+    const MemoryResource& other) const noexcept
+{
+    return this == &other;
+}
+
+void* pjson::details::allocate(std::size_t bytes)
+{
+    if (bytes > std::numeric_limits<std::size_t>::max() - header) {
+        throw std::bad_alloc{};
+    }
+    MemoryResource* const resource = current;
+    void* const block = resource
+                            ? resource->allocate(bytes + header, header)
+                            : ::operator new(bytes + header);
+    new (block) BlockHeader{resource, 0};
+    return static_cast<char*>(block) + header;
+}
+
+void pjson::details::deallocate(void* p, std::size_t bytes) noexcept
+{
+    BlockHeader* const block = headerOf(p);
+    if (MemoryResource* const resource = block->resource) {
+        if (block->charged != 0) {
+            // only a BudgetResource takes charges, see attachCharge()
+            static_cast<BudgetResource*>(resource)->release(block->charged);
+        }
+        resource->deallocate(block, bytes + header, header);
+    } else {
+        ::operator delete(block);
+    }
+}
+
+pjson::BudgetResource* pjson::details::currentBudget()
+{
+    return current ? dynamic_cast<BudgetResource*>(current) : nullptr;
+}
+
+std::size_t pjson::details::stringBytes(std::size_t length)
+{
+    // the capacity of the buffer inside std::string
+    static const std::size_t local = std::string().capacity();
+    return length > local ? length + 1 : 0;
+}
+
+void pjson::details::attachCharge(void* p, BudgetResource* budget,
+                                  std::size_t bytes) noexcept
+{
+    BlockHeader* const block = headerOf(p);
+    if (block->resource == budget) {
+        block->charged += bytes;
+    } else {
+        budget->release(bytes);
+    }
+}
@@ -0,0 +1,53 @@
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include "polip/json/batch.hpp"
+#include "bench.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+std::string makeDocument(unsigned i)
+{
+    std::ostringstream os;
+    os << R"({"id": )" << i << R"(, "name": "sub-document )" << i
+       << R"(", "items": [)";
+    for (unsigned j = 0; j < 20; ++j) {
+        os << (j ? "," : "") << R"({"sku": )" << i * 100 + j
+           << R"(, "price": )" << j * 1.25 << R"(, "tags": ["a", "b"]})";
+    }
+    os << "]}";
+    return os.str();
+}
+
+}  // anonymous namespace
+
+int main(int, char**)
+{
+    const unsigned iterations = 10;
+    std::vector<std::string> documents;
+    for (unsigned i = 0; i < 5000; ++i) {
+        documents.push_back(makeDocument(i));
+    }
+
+    const double serial = measure(iterations, [&documents]() {
+        for (auto const& document : documents) {
+            pjson::load(document);
+        }
+    });
+    std::cout << "serial load(): " << serial << " ms\n";
+
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= std::max(cores, 4u); threads *= 2) {
+        pjson::BatchLoader loader(threads);
+        const double batch = measure(iterations, [&loader, &documents]() {
+            loader.load(documents);
+        });
+        std::cout << threads << " thread(s): " << batch << " ms, speedup "
+                  << serial / batch << "\n";
+    }
+    return 0;
+}
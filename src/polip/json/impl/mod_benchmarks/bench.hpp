@@ -0,0 +1,48 @@
+#ifndef INCLUDE_POLIP_JSON_IMPL_MOD_BENCHMARKS_BENCH_HPP
+#define INCLUDE_POLIP_JSON_IMPL_MOD_BENCHMARKS_BENCH_HPP
+
+#include <chrono>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+// the average time of one call to f, in milliseconds
+template <typename F>
+double measure(unsigned iterations, F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < iterations; ++i) {
+        f();
+    }
+    const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+// an array of records, the i-th written by write(os, i)
+template <typename Write>
+std::string makeRecords(unsigned records, Write write,
+                        const char* separator = ",")
+{
+    std::ostringstream os;
+    os << '[';
+    for (unsigned i = 0; i < records; ++i) {
+        if (i) {
+            os << separator;
+        }
+        write(os, i);
+    }
+    os << ']';
+    return os.str();
+}
+
+// a record with a value of every kind
+inline void writeRecord(std::ostream& os, unsigned i)
+{
+    os << R"({"id": )" << i << R"(, "name": "record number )" << i
+       << R"(", "score": )" << i * 0.25
+       << R"(, "active": )" << (i % 2 ? "true" : "false")
+       << R"(, "tags": ["alpha", "beta", "gamma"], "parent": null})";
+}
+
+#endif  // INCLUDE_POLIP_JSON_IMPL_MOD_BENCHMARKS_BENCH_HPP
@@ -0,0 +1,80 @@
+#include <iostream>
+#include <string>
+#include "polip/json/value.hpp"
+#include "bench.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+const unsigned records = 10000;
+
+// wraps every level by copying it, as Value(const T&) used to
+pjson::Value buildCopying()
+{
+    pjson::Array items;
+    for (unsigned i = 0; i < records; ++i) {
+        pjson::Array tags;
+        tags.push_back(pjson::Value("alpha"));
+        tags.push_back(pjson::Value("beta"));
+        pjson::Object record;
+        record.emplace_back("id", pjson::Value(int64_t{i}));
+        record.emplace_back("name",
+                            pjson::Value("record number " + std::to_string(i)));
+        const pjson::Array& tagsRef = tags;
+        record.emplace_back("tags", pjson::Value(tagsRef));
+        const pjson::Object& recordRef = record;
+        items.push_back(pjson::Value(recordRef));
+    }
+    const pjson::Array& itemsRef = items;
+    pjson::Object response;
+    response.emplace_back("items", pjson::Value(itemsRef));
+    const pjson::Object& responseRef = response;
+    return pjson::Value(responseRef);
+}
+
+pjson::Value buildMoving()
+{
+    pjson::Array items;
+    items.reserve(records);
+    for (unsigned i = 0; i < records; ++i) {
+        pjson::Array tags{"alpha", "beta"};
+        pjson::Object record;
+        record.emplace_back("id", int64_t{i});
+        record.emplace_back("name", "record number " + std::to_string(i));
+        record.emplace_back("tags", std::move(tags));
+        items.push_back(std::move(record));
+    }
+    pjson::Object response;
+    response.emplace_back("items", std::move(items));
+    return pjson::Value(std::move(response));
+}
+
+pjson::Value buildInPlace()
+{
+    pjson::Value response = pjson::Object{};
+    pjson::Value& items = response.append("items", pjson::Array{});
+    items.reserve(records);
+    for (unsigned i = 0; i < records; ++i) {
+        pjson::Value& record = items.pushBack(pjson::Object{});
+        record.reserve(3);
+        record.append("id", int64_t{i});
+        record.append("name", "record number " + std::to_string(i));
+        pjson::Value& tags = record.append("tags", pjson::Array{});
+        tags.pushBack("alpha");
+        tags.pushBack("beta");
+    }
+    return response;
+}
+
+}  // anonymous namespace
+
+int main(int, char**)
+{
+    const unsigned iterations = 20;
+    std::cout << "copying:  " << measure(iterations, buildCopying) << " ms\n";
+    std::cout << "moving:   " << measure(iterations, buildMoving) << " ms\n";
+    std::cout << "in place: " << measure(iterations, buildInPlace) << " ms\n";
+    return 0;
+}
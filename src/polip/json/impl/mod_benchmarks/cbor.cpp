@@ -0,0 +1,37 @@
+#include <iostream>
+#include "polip/json/cbor.hpp"
+#include "polip/json/parser.hpp"
+#include "bench.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+}  // anonymous namespace
+
+int main(int, char**)
+{
+    const unsigned iterations = 20;
+    const std::string text = makeRecords(10000, writeRecord);
+    const pjson::Value value = pjson::load(text);
+    const pjson::cbor::Bytes binary = pjson::cbor::dump(value);
+
+    pjson::ParseOptions iterative;
+    iterative.engine = pjson::Engine::Iterative;
+
+    std::cout << "text: " << text.size() << " bytes, cbor: " << binary.size()
+              << " bytes\n";
+    std::cout << "load (recursive):  "
+              << measure(iterations, [&] { pjson::load(text); }) << " ms\n";
+    std::cout << "load (iterative):  "
+              << measure(iterations, [&] { pjson::load(text, iterative); })
+              << " ms\n";
+    std::cout << "cbor::load:        "
+              << measure(iterations, [&] { pjson::cbor::load(binary); })
+              << " ms\n";
+    std::cout << "cbor::dump:        "
+              << measure(iterations, [&] { pjson::cbor::dump(value); })
+              << " ms\n";
+    return 0;
+}
@@ -0,0 +1,46 @@
+#include <iostream>
+#include "polip/json/parser.hpp"
+#include "bench.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+// plain JSON, valid at both levels
+void writeItem(std::ostream& os, unsigned i)
+{
+    os << R"({"id": )" << i << R"(, "path": "/a/b/)"
+       << i << R"(", "price": )" << i * 0.25 << R"(, "tags": ["x", "y"])"
+       << R"(, "stock": {"count": )" << i % 100 << "}}";
+}
+
+}  // anonymous namespace
+
+int main(int, char**)
+{
+    const unsigned iterations = 5;
+    const std::string records = makeRecords(100000, writeItem, ",\n");
+    const char* const begin = records.data();
+    const char* const end = begin + records.size();
+
+    std::cout << "MB of text: " << records.size() / 1e6 << "\n";
+    for (pjson::Engine engine :
+         {pjson::Engine::Recursive, pjson::Engine::Iterative}) {
+        for (pjson::Conformance level :
+             {pjson::Conformance::Strict, pjson::Conformance::Relaxed}) {
+            pjson::ParseOptions options;
+            options.engine = engine;
+            options.level = level;
+            std::cout << (engine == pjson::Engine::Recursive ? "recursive "
+                                                             : "iterative ")
+                      << (level == pjson::Conformance::Strict ? "strict:  "
+                                                              : "relaxed: ")
+                      << measure(iterations, [&]() {
+                             pjson::load(begin, end, options);
+                         })
+                      << " ms\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+#include "polip/json/parser.hpp"
+#include "bench.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+std::size_t allocations = 0;
+
+// small objects and arrays, as in typical API traffic
+void writeEvent(std::ostream& os, unsigned i)
+{
+    os << R"({"id": )" << i << R"(, "kind": "event")"
+       << R"(, "point": [)" << i % 13 << ", " << i % 17 << "]"
+       << R"(, "flags": {"seen": true, "pinned": false}, "tags": [)"
+       << (i % 3 ? R"("a", "b", "c")" : "") << "]}";
+}
+
+const std::size_t blockSize = 1 << 20;
+
+// hands out consecutive bytes of large blocks and frees them all at once,
+// as a per-request pool does
+class ArenaResource : public pjson::MemoryResource
+{
+public:
+    ~ArenaResource()
+    {
+        for (void* block : m_blocks) {
+            std::free(block);
+        }
+    }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        m_used = (m_used + alignment - 1) / alignment * alignment;
+        if (m_blocks.empty() || m_used + bytes > blockSize) {
+            const std::size_t size = std::max(bytes, blockSize);
+            m_blocks.push_back(std::malloc(size));
+            m_used = 0;
+        }
+        void* p = static_cast<char*>(m_blocks.back()) + m_used;
+        m_used += bytes;
+        return p;
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override
+    {
+    }
+
+    bool do_is_equal(const pjson::MemoryResource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    std::vector<void*> m_blocks;
+    std::size_t m_used = 0;
+};
+
+void report(const char* name, const std::string& document,
+            pjson::ParseOptions options, bool arena = false)
+{
+    std::size_t count = 0;
+    const double ms = measure(10, [&]() {
+        ArenaResource resource;
+        options.resource = arena ? &resource : nullptr;
+        const std::size_t before = allocations;
+        pjson::load(document, options);
+        count = allocations - before;
+    });
+    std::cout << name << ms << " ms, " << count << " allocations\n";
+}
+
+}  // anonymous namespace
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if (void* p = std::malloc(size)) {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+int main(int, char**)
+{
+    const std::string document = makeRecords(100000, writeEvent);
+    pjson::ParseOptions options;
+    report("recursive: ", document, options);
+    options.engine = pjson::Engine::Iterative;
+    report("iterative: ", document, options);
+    // containers from a pool, strings still from operator new
+    options.engine = pjson::Engine::Recursive;
+    report("recursive, arena: ", document, options, true);
+    options.engine = pjson::Engine::Iterative;
+    report("iterative, arena: ", document, options, true);
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <iostream>
+#include <unordered_set>
+#include "polip/json/hash.hpp"
+#include "polip/json/parser.hpp"
+#include "bench.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+// the records and a last one named lastName
+std::string makeDocument(unsigned records, const std::string& lastName)
+{
+    std::string text = makeRecords(records, writeRecord);
+    text.insert(text.size() - 1, R"(, {"name": ")" + lastName + R"("})");
+    return text;
+}
+
+}  // anonymous namespace
+
+int main(int, char**)
+{
+    const unsigned iterations = 20;
+    const pjson::Value value = pjson::load(makeDocument(10000, "last"));
+    const pjson::Value identical = pjson::load(makeDocument(10000, "last"));
+    // differs in the very last leaf
+    const pjson::Value near = pjson::load(makeDocument(10000, "lass"));
+
+    const pjson::HashedValue hashed(value);
+    const pjson::HashedValue hashedIdentical(identical);
+    const pjson::HashedValue hashedNear(near);
+
+    volatile bool sink = false;
+    std::cout << "hash:                   "
+              << measure(iterations, [&] { sink = pjson::hash(value) != 0; })
+              << " ms\n";
+    std::cout << "unorderedHash:          " << measure(iterations, [&] {
+        sink = pjson::unorderedHash(value) != 0;
+    }) << " ms\n";
+    std::cout << "== identical:           "
+              << measure(iterations, [&] { sink = value == identical; })
+              << " ms\n";
+    std::cout << "== near-identical:      "
+              << measure(iterations, [&] { sink = value == near; }) << " ms\n";
+    std::cout << "hashed == identical:    "
+              << measure(iterations, [&] { sink = hashed == hashedIdentical; })
+              << " ms\n";
+    std::cout << "hashed == near:         "
+              << measure(iterations, [&] { sink = hashed == hashedNear; })
+              << " ms\n";
+
+    // deduplication of 1000 small documents, half of them repeated
+    std::vector<pjson::Value> documents;
+    for (unsigned i = 0; i < 1000; ++i) {
+        documents.push_back(pjson::load(makeDocument(10, i % 2 ? "a" : "b")));
+        documents.push_back(pjson::load(makeDocument(10, std::to_string(i))));
+    }
+    std::cout << "dedup " << documents.size() << " documents: "
+              << measure(iterations, [&] {
+                     std::unordered_set<pjson::HashedValue> unique;
+                     for (auto const& document : documents) {
+                         unique.emplace(document);
+                     }
+                     sink = unique.size() == 1002;
+                 })
+              << " ms\n";
+    (void)sink;
+    return 0;
+}
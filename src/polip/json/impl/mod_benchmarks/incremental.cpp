@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <iostream>
+#include "polip/json/incremental.hpp"
+#include "bench.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+void writeItem(std::ostream& os, unsigned i)
+{
+    os << R"({"id": )" << i << R"(, "name": "item )"
+       << i << R"(", "price": )" << i * 0.25 << R"(, "tags": ["a", "b"])"
+       << R"(, "stock": {"count": )" << i % 100 << ", \"open\": "
+       << (i % 2 ? "true" : "false") << "}}";
+}
+
+// counts the values
+class Counter final : public pjson::DispatchTarget
+{
+public:
+    std::size_t values = 0;
+
+private:
+    void objectBeginImpl(const std::string&) override {}
+    void objectEndImpl() override {}
+    void arrayBeginImpl() override {}
+    void arrayEndImpl() override {}
+    void nullValueImpl() override { ++values; }
+    void boolValueImpl(bool) override { ++values; }
+    void integerValueImpl(int64_t) override { ++values; }
+    void doubleValueImpl(double) override { ++values; }
+    void stringValueImpl(const std::string&) override { ++values; }
+};
+
+// as if received in chunks of size bytes
+std::size_t parseChunked(const std::string& text, std::size_t size)
+{
+    Counter counter;
+    pjson::IncrementalParser parser(counter);
+    const char* const end = text.data() + text.size();
+    for (const char* it = text.data(); it != end;) {
+        const char* const next = it + std::min<std::size_t>(size, end - it);
+        parser.feed(it, next);
+        it = next;
+    }
+    parser.finish();
+    return counter.values;
+}
+
+}  // anonymous namespace
+
+int main(int, char**)
+{
+    const unsigned iterations = 10;
+    const std::string records = makeRecords(100000, writeItem);
+    std::size_t values = 0;
+
+    std::cout << "MB of text:      " << records.size() / 1e6 << "\n";
+    std::cout << "parse at once:   " << measure(iterations, [&]() {
+        Counter counter;
+        pjson::parse(records.data(), records.data() + records.size(),
+                     counter);
+        values = counter.values;
+    }) << " ms\n";
+    for (std::size_t size : {65536, 4096, 256, 16}) {
+        std::cout << "chunks of " << size << ": " << measure(iterations, [&]() {
+            if (parseChunked(records, size) != values) {
+                std::abort();
+            }
+        }) << " ms\n";
+    }
+    return 0;
+}
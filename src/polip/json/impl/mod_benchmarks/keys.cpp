@@ -0,0 +1,73 @@
+#include <iostream>
+#include "polip/json/tape.hpp"
+#include "bench.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+void writeAccount(std::ostream& os, unsigned i)
+{
+    os << R"({"identifier": )" << i
+       << R"(, "display_name": "record )" << i
+       << R"(", "created_timestamp": )" << 1600000000 + i
+       << R"(, "is_active": true, "owner_account_id": )" << i % 97
+       << R"(, "score": )" << i * 0.25 << "}";
+}
+
+std::size_t bytes(const pjson::Tape& tape)
+{
+    return tape.size() * sizeof(std::uint64_t) + tape.stringBytes();
+}
+
+template <typename Key>
+int64_t sum(const pjson::Tape& tape, const Key& key)
+{
+    int64_t total = 0;
+    const pjson::TapeValue root = tape.root();
+    for (auto it = root.arrayBegin(); it != root.arrayEnd(); ++it) {
+        total += it->find(key)->second.template as<int64_t>();
+    }
+    return total;
+}
+
+}  // anonymous namespace
+
+int main(int, char**)
+{
+    const unsigned iterations = 10;
+    const std::string records = makeRecords(100000, writeAccount);
+    const pjson::KeyTable none;
+    const pjson::KeyTable table({"identifier", "display_name",
+                                 "created_timestamp", "is_active",
+                                 "owner_account_id", "score"});
+    const pjson::ParseOptions options;
+
+    pjson::Tape plain = pjson::Tape::load(records);
+    pjson::Tape interned = pjson::Tape::load(records, options, none);
+    pjson::Tape shared = pjson::Tape::load(records, options, table);
+    std::cout << "tape bytes: plain " << bytes(plain) << ", interned "
+              << bytes(interned) << ", shared table " << bytes(shared)
+              << "\n";
+
+    std::cout << "load plain:    " << measure(iterations, [&]() {
+        pjson::Tape::load(records);
+    }) << " ms\n";
+    std::cout << "load interned: " << measure(iterations, [&]() {
+        pjson::Tape::load(records, options, none);
+    }) << " ms\n";
+    std::cout << "load shared:   " << measure(iterations, [&]() {
+        pjson::Tape::load(records, options, table);
+    }) << " ms\n";
+
+    const pjson::TapeKey owner = table.find("owner_account_id");
+    int64_t total = 0;
+    std::cout << "scan by name:  " << measure(iterations, [&]() {
+        total += sum(shared, boost::string_view("owner_account_id"));
+    }) << " ms\n";
+    std::cout << "scan by key:   " << measure(iterations, [&]() {
+        total += sum(shared, owner);
+    }) << " ms\n";
+    return total == 0;
+}
@@ -0,0 +1,52 @@
+#include <iostream>
+#include "polip/json/parser.hpp"
+#include "bench.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+void writeItem(std::ostream& os, unsigned i)
+{
+    os << R"({"id": )" << i << R"(, "name": "item )"
+       << i << R"(", "price": )" << i * 0.25 << R"(, "tags": ["x", "y"])"
+       << R"(, "stock": {"count": )" << i % 100 << "}}";
+}
+
+}  // anonymous namespace
+
+int main(int, char**)
+{
+    const std::string records = makeRecords(100000, writeItem, ",\n");
+    const char* const begin = records.data();
+    const char* const end = begin + records.size();
+
+    pjson::ParseOptions options;
+    options.engine = pjson::Engine::Iterative;
+    std::cout << "MB of text: " << records.size() / 1e6 << "\n"
+              << "no limits:  "
+              << measure(5, [&]() { pjson::load(begin, end, options); })
+              << " ms\n";
+
+    // all set, none reached
+    options.limits.maxDocumentBytes = 64 << 20;
+    options.limits.maxStringLength = 1 << 20;
+    options.limits.maxContainerElements = 1 << 20;
+    options.limits.maxNodes = 1 << 24;
+    options.limits.maxNumberLength = 64;
+    std::cout << "all limits: "
+              << measure(5, [&]() { pjson::load(begin, end, options); })
+              << " ms\n";
+
+    // a hostile array refused early
+    options.limits.maxContainerElements = 1000;
+    const double refused = measure(5, [&]() {
+        try {
+            pjson::load(begin, end, options);
+        } catch (const pjson::parse_error<const char*>&) {
+        }
+    });
+    std::cout << "refused:    " << refused << " ms\n";
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include "polip/json/source.hpp"
+#include "bench.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+// a pretty printed record of five lines
+void writeIndented(std::ostream& os, unsigned i)
+{
+    os << "\n    {\n        \"id\": " << i << ",\n        \"name\": \"record "
+       << i << "\",\n        \"tags\": [\"a\", \"b\"]\n    }";
+}
+
+// what locating without an index costs
+pjson::Location rescan(const std::string& text, std::size_t offset)
+{
+    const auto end = text.begin() + offset;
+    const auto lineStart = std::find(std::string::const_reverse_iterator(end),
+                                     text.rend(), '\n');
+    return pjson::Location{
+        static_cast<std::size_t>(std::count(text.begin(), end, '\n')) + 1,
+        static_cast<std::size_t>(lineStart - text.rbegin()) -
+            (text.end() - end) + 1};
+}
+
+}  // anonymous namespace
+
+int main(int, char**)
+{
+    // about 75 MB
+    const std::string document = makeRecords(800000, writeIndented);
+    std::mt19937 random(7);
+    std::uniform_int_distribution<std::size_t> offsets(0, document.size());
+    std::vector<std::size_t> lookups(10000);
+    for (auto& offset : lookups) {
+        offset = offsets(random);
+    }
+    const std::size_t rescans = 100;
+
+    std::size_t total = 0;
+    std::cout << "MB of text: " << document.size() / 1e6 << "\n";
+    std::cout << "rescanning, " << rescans << " lookups: " << measure(1, [&]() {
+        for (std::size_t i = 0; i < rescans; ++i) {
+            total += rescan(document, lookups[i]).line;
+        }
+    }) << " ms\n";
+    std::cout << "index, " << lookups.size() << " lookups: "
+              << measure(1, [&]() {
+        const pjson::LineIndex index(document);
+        for (std::size_t offset : lookups) {
+            total += index.locate(offset).line;
+        }
+    }) << " ms\n";
+
+    pjson::ParseOptions options;
+    options.engine = pjson::Engine::Iterative;
+    pjson::Value plain;
+    std::cout << "load: " << measure(1, [&]() {
+        plain = pjson::load(document, options);
+    }) << " ms\n";
+    pjson::Value located;
+    for (std::size_t depth : {std::size_t{1}, std::size_t{2}}) {
+        pjson::SourceMap sources(depth);
+        located = pjson::Value{};
+        std::cout << "load with sources to depth " << depth << ": "
+                  << measure(1, [&]() {
+            pjson::load(document, located, sources, options);
+        }) << " ms\n";
+        total += sources.offset(located);
+    }
+    return total == 0;
+}
@@ -0,0 +1,67 @@
+#include <iostream>
+#include "polip/json/parser.hpp"
+#include "polip/json/schema.hpp"
+#include "bench.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+const char* recordSchema = R"({
+    "type": "array",
+    "items": {
+        "type": "object",
+        "required": ["id", "name"],
+        "properties": {
+            "id": {"type": "integer", "minimum": 0},
+            "name": {"type": "string", "maxLength": 64},
+            "score": {"type": "number"},
+            "active": {"type": "boolean"},
+            "tags": {"type": "array", "maxItems": 8,
+                     "items": {"enum": ["alpha", "beta", "gamma"]}},
+            "parent": {"type": ["integer", "null"]}
+        },
+        "additionalProperties": false
+    }
+})";
+
+class NullTarget final : public pjson::DispatchTarget
+{
+    void objectBeginImpl(const std::string&) override {}
+    void objectEndImpl() override {}
+    void arrayBeginImpl() override {}
+    void arrayEndImpl() override {}
+    void nullValueImpl() override {}
+    void boolValueImpl(bool) override {}
+    void integerValueImpl(int64_t) override {}
+    void doubleValueImpl(double) override {}
+    void stringValueImpl(const std::string&) override {}
+};
+
+}  // anonymous namespace
+
+int main(int, char**)
+{
+    const unsigned iterations = 20;
+    const std::string text = makeRecords(10000, writeRecord);
+    const pjson::Schema schema(pjson::load(recordSchema));
+
+    pjson::ParseOptions iterative;
+    iterative.engine = pjson::Engine::Iterative;
+
+    std::cout << "text: " << text.size() << " bytes\n";
+    std::cout << "parse (no target):  " << measure(iterations, [&] {
+        NullTarget target;
+        pjson::parse(text, target);
+    }) << " ms\n";
+    std::cout << "schema.validate:    "
+              << measure(iterations, [&] { schema.validate(text); })
+              << " ms\n";
+    std::cout << "load (iterative):   "
+              << measure(iterations, [&] { pjson::load(text, iterative); })
+              << " ms\n";
+    std::cout << "schema.load:        "
+              << measure(iterations, [&] { schema.load(text); }) << " ms\n";
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "polip/json/parser.hpp"
+#include "polip/json/shared.hpp"
+#include "bench.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+std::string makeConfig(unsigned services)
+{
+    std::ostringstream os;
+    os << R"({"version": 1, "services": {)";
+    for (unsigned i = 0; i < services; ++i) {
+        os << (i ? "," : "") << R"("service)" << i
+           << R"(": {"port": )" << 8000 + i
+           << R"(, "hosts": ["a.example", "b.example", "c.example"])"
+           << R"(, "limits": {"cpu": 2, "memory": 1024}, "enabled": true})";
+    }
+    os << "}}";
+    return os.str();
+}
+
+// every reader takes a snapshot of the document and reads one port
+template <typename Read>
+double readers(unsigned threads, unsigned snapshots, Read read)
+{
+    return measure(1, [threads, snapshots, &read]() {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([snapshots, &read]() {
+                for (unsigned i = 0; i < snapshots; ++i) {
+                    read();
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    });
+}
+
+}  // anonymous namespace
+
+int main(int, char**)
+{
+    const unsigned threads = 8;
+    const unsigned snapshots = 100;
+    const pjson::Value value = pjson::load(makeConfig(2000));
+    const pjson::SharedValue shared(value);
+
+    std::cout << "deep copy snapshots:   "
+              << readers(threads, snapshots, [&value]() {
+                     const pjson::Value copy = value;
+                     copy.as<pjson::Object>()[1].second.as<pjson::Object>()[0]
+                         .second.as<pjson::Object>()[0].second.as<int64_t>();
+                 })
+              << " ms\n";
+    std::cout << "shared snapshots:      "
+              << readers(threads, snapshots, [&shared]() {
+                     const pjson::SharedValue copy = shared;
+                     copy.find("services")->at(0).find("port")->as<int64_t>();
+                 })
+              << " ms\n";
+
+    const unsigned iterations = 1000;
+    std::cout << "deep copy update:      " << measure(10, [&value]() {
+        pjson::Value copy = value;
+        copy.find("services")->find("service7")->set("enabled", false);
+    }) << " ms\n";
+    std::cout << "copy-on-write update:  " << measure(iterations, [&shared]() {
+        shared.withValueAt("/services/service7/enabled", false);
+    }) << " ms\n";
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <iostream>
+#include "polip/json/parser.hpp"
+#include "bench.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+// log records whose payload makes up most of the text
+void writeLogRecord(std::ostream& os, unsigned i)
+{
+    os << R"({"level": )" << i % 5
+       << R"(, "payload": {"request": {"path": "/api/v1/items/)" << i
+       << R"(", "headers": ["accept: */*", "user-agent: \"bench\""]},)"
+       << R"( "timings": [)" << i * 0.5 << ", " << i + 0.25 << ", "
+       << i % 1000 << R"(], "message": "processed item )" << i
+       << R"( of the batch without any errors or warnings"}})";
+}
+
+// sums the levels, other members are skipped when asked to
+class LevelSum final : public pjson::DispatchTarget
+{
+public:
+    explicit LevelSum(bool skip) : m_skip(skip)
+    {
+    }
+
+    int64_t total = 0;
+
+private:
+    bool skipMemberImpl(const std::string& name) override
+    {
+        return m_skip && name != "level";
+    }
+
+    void objectBeginImpl(const std::string&) override {}
+    void objectEndImpl() override {}
+    void arrayBeginImpl() override {}
+    void arrayEndImpl() override {}
+    void nullValueImpl() override {}
+    void boolValueImpl(bool) override {}
+    void integerValueImpl(int64_t v) override { total += v; }
+    void doubleValueImpl(double) override {}
+    void stringValueImpl(const std::string&) override {}
+
+    bool m_skip;
+};
+
+}  // anonymous namespace
+
+int main(int, char**)
+{
+    const unsigned iterations = 10;
+    const std::string records = makeRecords(100000, writeLogRecord);
+    const char* const begin = records.data();
+    const char* const end = begin + records.size();
+    LevelSum all(false);
+    LevelSum skipping(true);
+
+    std::cout << "MB of text:      " << records.size() / 1e6 << "\n";
+    std::cout << "parse all:       " << measure(iterations, [&]() {
+        pjson::parse(begin, end, all);
+    }) << " ms\n";
+    std::cout << "skip, iterators: " << measure(iterations, [&]() {
+        pjson::parse(records, skipping);
+    }) << " ms\n";
+    std::cout << "skip, pointers:  " << measure(iterations, [&]() {
+        pjson::parse(begin, end, skipping);
+    }) << " ms\n";
+    return skipping.total == 0;
+}
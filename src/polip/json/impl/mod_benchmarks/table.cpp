@@ -0,0 +1,49 @@
+#include <iostream>
+#include "polip/json/table.hpp"
+#include "bench.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+void writeAccount(std::ostream& os, unsigned i)
+{
+    os << R"({"identifier": )" << i
+       << R"(, "display_name": "record )" << i
+       << R"(", "created_timestamp": )" << 1600000000 + i
+       << R"(, "is_active": true, "owner_account_id": )" << i % 97
+       << R"(, "score": )" << i + 0.5 << "}";
+}
+
+}  // anonymous namespace
+
+int main(int, char**)
+{
+    const unsigned iterations = 10;
+    const std::string records = makeRecords(100000, writeAccount);
+    pjson::ParseOptions options;
+    options.engine = pjson::Engine::Iterative;
+
+    std::cout << "load value: " << measure(iterations, [&]() {
+        pjson::load(records, options);
+    }) << " ms\n";
+    std::cout << "load table: " << measure(iterations, [&]() {
+        pjson::Table::load(records, options);
+    }) << " ms\n";
+
+    const pjson::Value value = pjson::load(records, options);
+    const pjson::Table table = *pjson::Table::load(records, options);
+    double total = 0;
+    std::cout << "scan value: " << measure(iterations, [&]() {
+        for (auto it = value.arrayBegin(); it != value.arrayEnd(); ++it) {
+            total += it->find("score")->as<double>();
+        }
+    }) << " ms\n";
+    std::cout << "scan table: " << measure(iterations, [&]() {
+        for (double score : table.column("score")->doubles()) {
+            total += score;
+        }
+    }) << " ms\n";
+    return total == 0;
+}
@@ -0,0 +1,97 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "polip/json/io.hpp"
+#include "polip/json/writer.hpp"
+#include "bench.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+const unsigned records = 10000;
+
+pjson::Value buildResponse()
+{
+    pjson::Value response = pjson::Object{};
+    pjson::Value& items = response.append("items", pjson::Array{});
+    items.reserve(records);
+    for (unsigned i = 0; i < records; ++i) {
+        pjson::Value& record = items.pushBack(pjson::Object{});
+        record.append("id", int64_t{i});
+        record.append("name", "record number " + std::to_string(i));
+        record.append("score", i * 0.25);
+        record.append("tags", pjson::Array{"alpha", "beta"});
+    }
+    return response;
+}
+
+void writeResponse(pjson::Writer& writer)
+{
+    writer.objectBegin("items");
+    writer.arrayBegin();
+    for (unsigned i = 0; i < records; ++i) {
+        writer.objectBegin("id");
+        writer.integerValue(i);
+        writer.objectBegin("name");
+        writer.stringValue("record number " + std::to_string(i));
+        writer.objectBegin("score");
+        writer.doubleValue(i * 0.25);
+        writer.objectBegin("tags");
+        writer.arrayBegin();
+        writer.stringValue("alpha");
+        writer.stringValue("beta");
+        writer.arrayEnd();
+        writer.objectEnd();
+    }
+    writer.arrayEnd();
+    writer.objectEnd();
+}
+
+}  // anonymous namespace
+
+int main(int, char**)
+{
+    const unsigned iterations = 20;
+    std::cout << "Value + operator<<:  " << measure(iterations, []() {
+        std::ostringstream os;
+        os << buildResponse();
+    }) << " ms\n";
+    std::cout << "Value + Writer:      " << measure(iterations, []() {
+        std::string out;
+        pjson::StringSink sink(out);
+        pjson::Writer writer(sink);
+        writer.value(buildResponse());
+    }) << " ms\n";
+    std::cout << "Writer events:       " << measure(iterations, []() {
+        std::string out;
+        pjson::StringSink sink(out);
+        pjson::Writer writer(sink);
+        writeResponse(writer);
+    }) << " ms\n";
+
+    std::string text;
+    {
+        pjson::StringSink sink(text);
+        pjson::Writer writer(sink);
+        writeResponse(writer);
+    }
+    std::cout << "reformat via load(): " << measure(iterations, [&text]() {
+        std::string out;
+        pjson::StringSink sink(out);
+        pjson::WriterOptions options;
+        options.indent = 2;
+        pjson::Writer writer(sink, options);
+        writer.value(pjson::load(text));
+    }) << " ms\n";
+    std::cout << "reformat via parse(): " << measure(iterations, [&text]() {
+        std::string out;
+        pjson::StringSink sink(out);
+        pjson::WriterOptions options;
+        options.indent = 2;
+        pjson::Writer writer(sink, options);
+        pjson::parse(text, writer);
+    }) << " ms\n";
+    return 0;
+}
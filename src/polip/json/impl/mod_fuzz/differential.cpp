@@ -0,0 +1,101 @@
+#include "polip/json/source.hpp"
+#include "polip/json/table.hpp"
+#include "polip/json/tape.hpp"
+#include "fuzz.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+void compareTable(const std::string& input, const pjson::Value& loaded)
+{
+    const auto table = pjson::Table::load(input);
+    if (!table) {
+        return;
+    }
+    const pjson::Array* rows = boost::get<pjson::Array>(&loaded.get());
+    pjson::fuzz::check(rows != nullptr && rows->size() == table->rows(),
+                       "a table has the rows of the array", input);
+    for (std::size_t i = 0; i < rows->size(); ++i) {
+        const pjson::Value& row = (*rows)[i];
+        pjson::fuzz::check(row.size() == table->columns().size(),
+                           "a table row has the members of the object", input);
+        for (auto const& column : table->columns()) {
+            const pjson::Value* member = row.find(column.name());
+            pjson::fuzz::check(member != nullptr &&
+                                   pjson::fuzz::same(*member, column.at(i)),
+                               "a table row has the members of the object",
+                               input);
+        }
+    }
+}
+
+}  // anonymous namespace
+
+/*
+    The Spirit grammar behind the recursive engine is the reference: every
+    other way of reading a document has to accept exactly the inputs it
+    accepts, at the same level, and produce the same value.
+ */
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data,
+                                      std::size_t size)
+{
+    const char* const begin = reinterpret_cast<const char*>(data);
+    const std::string input(begin, size);
+    for (pjson::Conformance level :
+         {pjson::Conformance::Relaxed, pjson::Conformance::Strict}) {
+        pjson::ParseOptions options;
+        options.level = level;
+        const auto reference = pjson::fuzz::tryLoad(input, options);
+
+        options.engine = pjson::Engine::Iterative;
+        const auto iterative = pjson::fuzz::tryLoad(input, options);
+        pjson::fuzz::check(
+            static_cast<bool>(reference) == static_cast<bool>(iterative),
+            "the iterative engine accepts what the grammar accepts", input);
+        if (reference) {
+            pjson::fuzz::check(pjson::fuzz::same(*reference, *iterative),
+                               "the iterative engine reads the same value",
+                               input);
+        }
+
+        boost::optional<pjson::Value> pointer;
+        try {
+            pointer = pjson::load(begin, begin + size, options);
+        } catch (const pjson::parse_error<const char*>&) {
+        }
+        pjson::fuzz::check(
+            static_cast<bool>(reference) == static_cast<bool>(pointer) &&
+                (!reference || pjson::fuzz::same(*reference, *pointer)),
+            "const char* input reads the same value", input);
+
+        boost::optional<pjson::Value> taped;
+        try {
+            taped = pjson::Tape::load(input, options).root().toValue();
+        } catch (const pjson::parse_error<std::string::const_iterator>&) {
+        }
+        pjson::fuzz::check(
+            static_cast<bool>(reference) == static_cast<bool>(taped) &&
+                (!reference || pjson::fuzz::same(*reference, *taped)),
+            "a tape holds the same value", input);
+
+        boost::optional<pjson::Value> located;
+        try {
+            pjson::Value value;
+            pjson::SourceMap sources;
+            pjson::load(input, value, sources, options);
+            located = std::move(value);
+        } catch (const pjson::parse_error<const char*>&) {
+        }
+        pjson::fuzz::check(
+            static_cast<bool>(reference) == static_cast<bool>(located) &&
+                (!reference || pjson::fuzz::same(*reference, *located)),
+            "loading with sources reads the same value", input);
+
+        if (reference && level == pjson::Conformance::Relaxed) {
+            compareTable(input, *reference);
+        }
+    }
+    return 0;
+}
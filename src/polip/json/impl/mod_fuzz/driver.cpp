@@ -0,0 +1,73 @@
+#include <dirent.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include "fuzz.hpp"
+
+/*
+    Runs a fuzz target without libFuzzer, e.g. over the checked in corpus
+    by ctest or under AFL:
+        json_fuzz_load file|directory...
+        json_fuzz_load < input
+        afl-fuzz -i corpus -o findings -- json_fuzz_load @@
+    Directories are read one level deep, a failing input aborts the run.
+ */
+
+namespace
+{
+
+void collect(const std::string& path, std::vector<std::string>& files)
+{
+    struct stat info;
+    if (::stat(path.c_str(), &info) != 0) {
+        std::cerr << "cannot read " << path << "\n";
+        std::exit(2);
+    }
+    if (!S_ISDIR(info.st_mode)) {
+        files.push_back(path);
+        return;
+    }
+    DIR* dir = ::opendir(path.c_str());
+    if (dir == nullptr) {
+        std::cerr << "cannot read " << path << "\n";
+        std::exit(2);
+    }
+    while (const dirent* entry = ::readdir(dir)) {
+        const std::string name = entry->d_name;
+        if (name != "." && name != "..") {
+            files.push_back(path + "/" + name);
+        }
+    }
+    ::closedir(dir);
+}
+
+void run(const std::string& input)
+{
+    LLVMFuzzerTestOneInput(reinterpret_cast<const std::uint8_t*>(input.data()),
+                           input.size());
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        run(std::string(std::istreambuf_iterator<char>(std::cin),
+                        std::istreambuf_iterator<char>()));
+        return 0;
+    }
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        collect(argv[i], files);
+    }
+    for (auto const& file : files) {
+        std::ifstream in(file, std::ios::binary);
+        run(std::string(std::istreambuf_iterator<char>(in),
+                        std::istreambuf_iterator<char>()));
+    }
+    std::cout << files.size() << " inputs passed\n";
+    return 0;
+}
@@ -0,0 +1,109 @@
+#ifndef INCLUDE_POLIP_JSON_IMPL_MOD_FUZZ_FUZZ_HPP
+#define INCLUDE_POLIP_JSON_IMPL_MOD_FUZZ_FUZZ_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <boost/optional.hpp>
+#include "polip/json/parser.hpp"
+
+// Shared by the fuzz targets. A target checks properties of one input and
+// aborts when one of them does not hold, which libFuzzer, AFL and the
+// corpus driver all report as a crash of that input.
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data,
+                                      std::size_t size);
+
+namespace polip
+{
+namespace json
+{
+namespace fuzz
+{
+
+[[noreturn]] inline void fail(const char* property, const std::string& input)
+{
+    std::fprintf(stderr, "property violated: %s\ninput (%zu bytes): %s\n",
+                 property, input.size(), input.c_str());
+    std::abort();
+}
+
+inline void check(bool holds, const char* property, const std::string& input)
+{
+    if (!holds) {
+        fail(property, input);
+    }
+}
+
+// operator== but with NaN equal to NaN
+inline bool same(const Value& lhs, const Value& rhs)
+{
+    const double* l = boost::get<double>(&lhs.get());
+    const double* r = boost::get<double>(&rhs.get());
+    if (l != nullptr && r != nullptr) {
+        return *l == *r || (std::isnan(*l) && std::isnan(*r));
+    }
+    const Array* la = boost::get<Array>(&lhs.get());
+    const Array* ra = boost::get<Array>(&rhs.get());
+    if (la != nullptr && ra != nullptr) {
+        if (la->size() != ra->size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < la->size(); ++i) {
+            if (!same((*la)[i], (*ra)[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+    const Object* lo = boost::get<Object>(&lhs.get());
+    const Object* ro = boost::get<Object>(&rhs.get());
+    if (lo != nullptr && ro != nullptr) {
+        if (lo->size() != ro->size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < lo->size(); ++i) {
+            if ((*lo)[i].first != (*ro)[i].first ||
+                !same((*lo)[i].second, (*ro)[i].second)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return lhs == rhs;
+}
+
+// both engines at both conformance levels
+inline std::vector<ParseOptions> allOptions()
+{
+    std::vector<ParseOptions> all;
+    for (Engine engine : {Engine::Recursive, Engine::Iterative}) {
+        for (Conformance level : {Conformance::Relaxed, Conformance::Strict}) {
+            ParseOptions options;
+            options.engine = engine;
+            options.level = level;
+            all.push_back(options);
+        }
+    }
+    return all;
+}
+
+// none if the input is rejected, any error but parse_error escapes
+inline boost::optional<Value> tryLoad(const std::string& input,
+                                      const ParseOptions& options)
+{
+    try {
+        return load(input, options);
+    } catch (const parse_error<std::string::const_iterator>&) {
+        return boost::none;
+    }
+}
+
+}  // namespace fuzz
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_IMPL_MOD_FUZZ_FUZZ_HPP
@@ -0,0 +1,29 @@
+#include "fuzz.hpp"
+
+namespace pjson = polip::json;
+
+// load() either returns a value or throws parse_error with a position
+// inside the input, whatever the input, engine and level
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data,
+                                      std::size_t size)
+{
+    const char* const begin = reinterpret_cast<const char*>(data);
+    const std::string input(begin, size);
+    for (const pjson::ParseOptions& options : pjson::fuzz::allOptions()) {
+        try {
+            pjson::load(input, options);
+        } catch (const pjson::parse_error<std::string::const_iterator>& e) {
+            pjson::fuzz::check(e.begin == input.begin() &&
+                                   e.end == input.end() && e.where >= e.begin &&
+                                   e.where <= e.end,
+                               "error position within the input", input);
+        }
+        try {
+            pjson::load(begin, begin + size, options);
+        } catch (const pjson::parse_error<const char*>& e) {
+            pjson::fuzz::check(e.where >= begin && e.where <= begin + size,
+                               "error position within the input", input);
+        }
+    }
+    return 0;
+}
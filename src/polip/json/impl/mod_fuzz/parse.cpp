@@ -0,0 +1,107 @@
+#include "polip/json/writer.hpp"
+#include "fuzz.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+// writes what it is given, skips every second member and all arrays
+class SkippingWriter final : public pjson::DispatchTarget
+{
+public:
+    explicit SkippingWriter(std::string& out) : m_sink(out), m_writer(m_sink)
+    {
+    }
+
+    void flush()
+    {
+        m_writer.flush();
+    }
+
+private:
+    bool skipMemberImpl(const std::string&) override
+    {
+        return (m_members++ & 1) != 0;
+    }
+
+    bool skipArrayImpl() override
+    {
+        return true;
+    }
+
+    void objectBeginImpl(const std::string& name) override
+    {
+        m_writer.objectBegin(name);
+    }
+    void objectEndImpl() override { m_writer.objectEnd(); }
+    void arrayBeginImpl() override { m_writer.arrayBegin(); }
+    void arrayEndImpl() override { m_writer.arrayEnd(); }
+    void nullValueImpl() override { m_writer.nullValue(); }
+    void boolValueImpl(bool v) override { m_writer.boolValue(v); }
+    void integerValueImpl(int64_t v) override { m_writer.integerValue(v); }
+    void doubleValueImpl(double v) override { m_writer.doubleValue(v); }
+    void stringValueImpl(const std::string& v) override
+    {
+        m_writer.stringValue(v);
+    }
+
+    pjson::StringSink m_sink;
+    pjson::Writer m_writer;
+    std::size_t m_members = 0;
+};
+
+}  // anonymous namespace
+
+// parse() accepts what the iterative load() accepts and its events
+// describe the same value; skipping only ever accepts more
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data,
+                                      std::size_t size)
+{
+    const std::string input(reinterpret_cast<const char*>(data), size);
+    for (const pjson::ParseOptions& options : pjson::fuzz::allOptions()) {
+        if (options.engine != pjson::Engine::Iterative) {
+            continue;
+        }
+        const auto loaded = pjson::fuzz::tryLoad(input, options);
+
+        std::string text;
+        bool accepted = true;
+        try {
+            pjson::StringSink sink(text);
+            // relaxed input may hold NaN and infinities
+            pjson::WriterOptions writerOptions;
+            writerOptions.nonFinite = true;
+            pjson::Writer writer(sink, writerOptions);
+            pjson::parse(input, writer, options);
+            writer.flush();
+        } catch (const pjson::parse_error<std::string::const_iterator>&) {
+            accepted = false;
+        }
+        pjson::fuzz::check(accepted == static_cast<bool>(loaded),
+                           "parse() accepts what load() accepts", input);
+        if (loaded) {
+            // the written text is always read back at the relaxed level
+            pjson::ParseOptions relaxed = options;
+            relaxed.level = pjson::Conformance::Relaxed;
+            const auto written = pjson::fuzz::tryLoad(text, relaxed);
+            pjson::fuzz::check(written && pjson::fuzz::same(*loaded, *written),
+                               "parse() events describe the loaded value",
+                               input);
+        }
+
+        std::string skipped;
+        try {
+            SkippingWriter writer(skipped);
+            pjson::parse(input, writer, options);
+            writer.flush();
+        } catch (const pjson::parse_error<std::string::const_iterator>&) {
+            pjson::fuzz::check(!loaded, "skipping accepts valid input", input);
+            continue;
+        }
+        pjson::fuzz::check(static_cast<bool>(pjson::fuzz::tryLoad(
+                               skipped, pjson::ParseOptions{})),
+                           "skipping reports well formed events", input);
+    }
+    return 0;
+}
@@ -0,0 +1,47 @@
+#include "polip/json/cbor.hpp"
+#include "polip/json/writer.hpp"
+#include "fuzz.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+std::string write(const pjson::Value& value, std::size_t indent)
+{
+    std::string text;
+    pjson::StringSink sink(text);
+    pjson::WriterOptions options;
+    options.indent = indent;
+    // relaxed input may hold NaN and infinities
+    options.nonFinite = true;
+    pjson::Writer writer(sink, options);
+    writer.value(value);
+    writer.flush();
+    return text;
+}
+
+}  // anonymous namespace
+
+// values written as text or CBOR read back the same
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data,
+                                      std::size_t size)
+{
+    const std::string input(reinterpret_cast<const char*>(data), size);
+    const auto loaded = pjson::fuzz::tryLoad(input, pjson::ParseOptions{});
+    if (!loaded) {
+        return 0;
+    }
+
+    for (std::size_t indent : {0, 4}) {
+        const auto read = pjson::fuzz::tryLoad(write(*loaded, indent),
+                                               pjson::ParseOptions{});
+        pjson::fuzz::check(read && pjson::fuzz::same(*loaded, *read),
+                           "written text reads back", input);
+    }
+
+    const pjson::cbor::Bytes bytes = pjson::cbor::dump(*loaded);
+    pjson::fuzz::check(pjson::fuzz::same(*loaded, pjson::cbor::load(bytes)),
+                       "CBOR reads back", input);
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "polip/json/batch.hpp"
+
+using namespace polip::json;
+
+namespace
+{
+
+std::vector<std::string> makeDocuments(std::size_t size)
+{
+    std::vector<std::string> documents;
+    for (std::size_t i = 0; i < size; ++i) {
+        documents.push_back(i % 7 == 3 ? "[" + std::to_string(i)
+                                       : R"({"id": )" + std::to_string(i) +
+                                             "}");
+    }
+    return documents;
+}
+
+void check(const std::vector<std::string>& documents,
+           const std::vector<BatchResult>& results)
+{
+    ASSERT_EQ(documents.size(), results.size());
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        if (i % 7 == 3) {
+            ASSERT_TRUE(results[i].error != nullptr);
+            EXPECT_THROW(std::rethrow_exception(results[i].error), error);
+        } else {
+            ASSERT_TRUE(results[i].error == nullptr);
+            EXPECT_EQ(load(documents[i]), results[i].value);
+        }
+    }
+}
+
+}  // anonymous namespace
+
+TEST(json_batch, test_results_in_order)
+{
+    const std::vector<std::string> documents = makeDocuments(1000);
+    for (std::size_t threads : {1, 2, 5}) {
+        check(documents, load_batch(documents, ParseOptions{}, threads));
+    }
+}
+
+TEST(json_batch, test_loader_reuse)
+{
+    BatchLoader loader(4);
+    EXPECT_EQ(4u, loader.threads());
+    EXPECT_TRUE(loader.load({}).empty());
+    for (std::size_t size : {1, 2, 3, 100, 2000}) {
+        const std::vector<std::string> documents = makeDocuments(size);
+        check(documents, loader.load(documents));
+    }
+}
+
+TEST(json_batch, test_options)
+{
+    ParseOptions options;
+    options.level = Conformance::Strict;
+    options.engine = Engine::Iterative;
+    const std::vector<BatchResult> results =
+        load_batch({"[1]", "1", "{}"}, options, 2);
+    EXPECT_TRUE(results[0].error == nullptr);
+    EXPECT_TRUE(results[1].error != nullptr);
+    EXPECT_EQ(Value(Object{}), results[2].value);
+}
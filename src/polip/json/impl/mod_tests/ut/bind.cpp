@@ -0,0 +1,208 @@
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "polip/json/bind.hpp"
+
+namespace test_bind
+{
+
+struct Address
+{
+    std::string city;
+    boost::optional<std::string> street;
+};
+
+struct Person
+{
+    int64_t id = 0;
+    std::string name;
+    double score = 0;
+    bool active = false;
+    std::vector<std::string> tags;
+    Address address;
+    std::vector<Address> previous;
+    boost::optional<int> age;
+};
+
+struct Narrow
+{
+    uint8_t small = 0;
+    float ratio = 0;
+    std::vector<bool> flags;
+};
+
+}  // namespace test_bind
+
+BOOST_FUSION_ADAPT_STRUCT(test_bind::Address, city, street)
+BOOST_FUSION_ADAPT_STRUCT(test_bind::Person, id, name, score, active, tags,
+                          address, previous, age)
+BOOST_FUSION_ADAPT_STRUCT(test_bind::Narrow, small, ratio, flags)
+
+using namespace polip::json;
+using namespace test_bind;
+
+namespace
+{
+
+const char* ascii = R"({
+    "id": 7, "name": "Ala", "score": 2.5, "active": true,
+    "tags": ["a", "b"],
+    "address": {"city": "Krakow", "street": null},
+    "previous": [{"city": "Gdansk", "street": "Dluga"}],
+    "age": 30
+})";
+
+template <typename T>
+DiagError bindError(const std::string& jsonDoc)
+{
+    try {
+        load_into<T>(jsonDoc);
+    } catch (const parse_error<const char*>& e) {
+        return e.issue;
+    }
+    return DiagError::Other;
+}
+
+}  // anonymous namespace
+
+TEST(json_bind, test_load_into)
+{
+    Person p = load_into<Person>(ascii);
+    EXPECT_EQ(7, p.id);
+    EXPECT_EQ("Ala", p.name);
+    EXPECT_DOUBLE_EQ(2.5, p.score);
+    EXPECT_TRUE(p.active);
+    EXPECT_EQ((std::vector<std::string>{"a", "b"}), p.tags);
+    EXPECT_EQ("Krakow", p.address.city);
+    EXPECT_FALSE(p.address.street);
+    ASSERT_EQ(1u, p.previous.size());
+    EXPECT_EQ("Gdansk", p.previous[0].city);
+    EXPECT_EQ(std::string("Dluga"), *p.previous[0].street);
+    EXPECT_EQ(30, *p.age);
+}
+
+TEST(json_bind, test_unknown_and_missing_members)
+{
+    Person p;
+    p.name = "kept";
+    load_into(R"({"extra": {"a": [1, {"b": []}], "c": null}, "id": 3,
+                  "more": [[], [1.5, "x"]], "z": "zz"})",
+              p);
+    EXPECT_EQ(3, p.id);
+    EXPECT_EQ("kept", p.name);
+    EXPECT_FALSE(p.age);
+
+    // the lengths of members and none
+    load_into(R"({"": 1, "nmae": "x", "tag": [], "addresses": {},
+                  "previously_known": 1, "name": "other"})",
+              p);
+    EXPECT_EQ("other", p.name);
+    EXPECT_TRUE(p.tags.empty());
+
+    EXPECT_EQ(1, load_into<Person>(R"({"id": 2, "id": 1})").id);
+    EXPECT_EQ(0, load_into<Person>("{}").id);
+}
+
+TEST(json_bind, test_conversions)
+{
+    Narrow n = load_into<Narrow>(
+        R"({"small": 255, "ratio": 1, "flags": [true, false, true]})");
+    EXPECT_EQ(255, n.small);
+    EXPECT_FLOAT_EQ(1.0f, n.ratio);
+    EXPECT_EQ((std::vector<bool>{true, false, true}), n.flags);
+}
+
+TEST(json_bind, test_unsigned)
+{
+    using Numbers = std::vector<uint64_t>;
+    const Numbers big{0, uint64_t{INT64_MAX} + 1, UINT64_MAX};
+    EXPECT_EQ("[0,9223372036854775808,18446744073709551615]",
+              dump_from(big));
+    EXPECT_EQ(big, load_into<Numbers>(dump_from(big)));
+    EXPECT_EQ(DiagError::Int, bindError<Numbers>("[18446744073709551616]"));
+    EXPECT_EQ(DiagError::Int, bindError<Numbers>("[-1]"));
+    EXPECT_EQ(DiagError::Int, bindError<Numbers>("[1e19]"));
+    EXPECT_EQ(DiagError::Int, bindError<Numbers>("[1.0]"));
+    EXPECT_EQ(DiagError::Int,
+              bindError<std::vector<uint32_t>>("[4294967296]"));
+}
+
+TEST(json_bind, test_type_mismatch)
+{
+    EXPECT_EQ(DiagError::Int, bindError<Person>(R"({"id": "7"})"));
+    EXPECT_EQ(DiagError::Int, bindError<Person>(R"({"id": 1.5})"));
+    EXPECT_EQ(DiagError::Int, bindError<Narrow>(R"({"small": 256})"));
+    EXPECT_EQ(DiagError::Int, bindError<Narrow>(R"({"small": -1})"));
+    EXPECT_EQ(DiagError::String, bindError<Person>(R"({"name": 1})"));
+    EXPECT_EQ(DiagError::Double, bindError<Person>(R"({"score": null})"));
+    EXPECT_EQ(DiagError::Value, bindError<Person>(R"({"active": 1})"));
+    EXPECT_EQ(DiagError::Array, bindError<Person>(R"({"tags": "a"})"));
+    EXPECT_EQ(DiagError::Object, bindError<Person>(R"({"address": []})"));
+    EXPECT_EQ(DiagError::Object, bindError<Person>("[]"));
+    EXPECT_EQ(DiagError::Colon, bindError<Person>(R"({"id" 1})"));
+    EXPECT_EQ(DiagError::ExpectedObjectEnd,
+              bindError<Person>(R"({"id": 1 "name": "a"})"));
+    EXPECT_EQ(DiagError::ExpectedArrayEnd,
+              bindError<Person>(R"({"tags": ["a" "b"]})"));
+    EXPECT_EQ(DiagError::Other, bindError<Person>(R"({"id": 1} 2)"));
+    EXPECT_EQ(DiagError::Value, bindError<Person>(R"({"x": [1, ?]})"));
+}
+
+TEST(json_bind, test_strict_and_depth)
+{
+    EXPECT_THROW(load_into<Person>(R"({"score": .5})", Conformance::Strict),
+                 parse_error<const char*>);
+    EXPECT_DOUBLE_EQ(0.5, load_into<Person>(R"({"score": .5})").score);
+
+    ParseOptions options;
+    options.maxDepth = 2;
+    EXPECT_NO_THROW(load_into<Person>(R"({"tags": []})", options));
+    try {
+        load_into<Person>(R"({"x": [[1]]})", options);
+        FAIL();
+    } catch (const parse_error<const char*>& e) {
+        EXPECT_EQ(DiagError::MaxDepthExceeded, e.issue);
+    }
+}
+
+TEST(json_bind, test_dump_from)
+{
+    Person p = load_into<Person>(ascii);
+    const std::string text = dump_from(p);
+    EXPECT_EQ(R"({"id":7,"name":"Ala","score":2.5,"active":true,)"
+              R"("tags":["a","b"],"address":{"city":"Krakow","street":null},)"
+              R"("previous":[{"city":"Gdansk","street":"Dluga"}],"age":30})",
+              text);
+    EXPECT_EQ(text, dump_from(load_into<Person>(text)));
+    EXPECT_EQ(load(ascii), load(text));
+
+    Narrow n;
+    n.ratio = 0.1f;
+    EXPECT_EQ(R"({"small":0,"ratio":0.10000000149011612,"flags":[]})",
+              dump_from(n));
+
+    Address a;
+    a.city = "\"\\\n\t";
+    EXPECT_EQ(R"({"city":"\"\\\n\t","street":null})", dump_from(a));
+    EXPECT_EQ(a.city, load_into<Address>(dump_from(a)).city);
+}
+
+TEST(json_bind, test_text)
+{
+    std::string out;
+    appendDouble(out, 1);
+    out += ' ';
+    appendDouble(out, 0.1);
+    out += ' ';
+    appendDouble(out, -1e300);
+    out += ' ';
+    appendDouble(out, -INFINITY);
+    out += ' ';
+    appendDouble(out, -INFINITY, true);
+    out += ' ';
+    appendInteger(out, INT64_MIN);
+    EXPECT_EQ("1.0 0.1 -1e+300 null -inf -9223372036854775808",
+              out);
+}
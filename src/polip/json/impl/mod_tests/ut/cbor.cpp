@@ -0,0 +1,137 @@
+#include <cmath>
+#include <gtest/gtest.h>
+#include "polip/json/cbor.hpp"
+#include "polip/json/parser.hpp"
+
+using namespace polip::json;
+
+namespace
+{
+
+Value decode(std::initializer_list<std::uint8_t> bytes)
+{
+    return cbor::load(cbor::Bytes(bytes));
+}
+
+DiagError decodeError(std::initializer_list<std::uint8_t> bytes)
+{
+    try {
+        decode(bytes);
+    } catch (const cbor::Error& e) {
+        return e.issue;
+    }
+    return DiagError::Other;
+}
+
+const char* documents[] = {
+    "null", "true", "false", "0", "23", "24", "-1", "-25", "1000000",
+    "-9223372036854775808", "9223372036854775807", "1.5", "-2e300",
+    R"("")", R"("ala ma kota")", "[]", "{}", "[[], {}, [[]]]",
+    R"({"a": 1, "b": [2, 3], "c": {"d": {}, "e": "f"}, "g": null})",
+    R"([{"id": 1, "tags": ["x", "y"]}, {"id": 2, "tags": []}])"};
+
+}  // anonymous namespace
+
+TEST(json_cbor, test_decode_rfc_examples)
+{
+    EXPECT_EQ(Value{int64_t{0}}, decode({0x00}));
+    EXPECT_EQ(Value{int64_t{-1}}, decode({0x20}));
+    EXPECT_EQ(Value{int64_t{1000}}, decode({0x19, 0x03, 0xe8}));
+    EXPECT_EQ(Value{int64_t{-1000}}, decode({0x39, 0x03, 0xe7}));
+    EXPECT_DOUBLE_EQ(1.0, decode({0xf9, 0x3c, 0x00}).as<double>());
+    EXPECT_DOUBLE_EQ(-4.0, decode({0xf9, 0xc4, 0x00}).as<double>());
+    EXPECT_DOUBLE_EQ(5.960464477539063e-8, decode({0xf9, 0x00, 0x01}).as<double>());
+    EXPECT_DOUBLE_EQ(100000.0, decode({0xfa, 0x47, 0xc3, 0x50, 0x00}).as<double>());
+    EXPECT_DOUBLE_EQ(1.1, decode({0xfb, 0x3f, 0xf1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a}).as<double>());
+    EXPECT_TRUE(std::isinf(decode({0xf9, 0x7c, 0x00}).as<double>()));
+    EXPECT_DOUBLE_EQ(18446744073709551615.0,
+                     decode({0x1b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}).as<double>());
+    EXPECT_EQ(Value{false}, decode({0xf4}));
+    EXPECT_EQ(Value{Null{}}, decode({0xf6}));
+    EXPECT_EQ(Value{Null{}}, decode({0xf7}));
+    EXPECT_EQ(Value{"IETF"}, decode({0x64, 0x49, 0x45, 0x54, 0x46}));
+    EXPECT_EQ(Value{"streaming"},
+              decode({0x7f, 0x65, 0x73, 0x74, 0x72, 0x65, 0x61, 0x64, 0x6d,
+                      0x69, 0x6e, 0x67, 0xff}));
+    EXPECT_EQ(load("[1, 2, 3]"), decode({0x83, 0x01, 0x02, 0x03}));
+    EXPECT_EQ(load(R"({"a": 1, "b": [2, 3]})"),
+              decode({0xa2, 0x61, 0x61, 0x01, 0x61, 0x62, 0x82, 0x02, 0x03}));
+    EXPECT_EQ(load("[1, [2, 3], [4, 5]]"),
+              decode({0x9f, 0x01, 0x82, 0x02, 0x03, 0x9f, 0x04, 0x05, 0xff, 0xff}));
+    EXPECT_EQ(load(R"({"Fun": true, "Amt": -2})"),
+              decode({0xbf, 0x63, 0x46, 0x75, 0x6e, 0xf5, 0x63, 0x41, 0x6d,
+                      0x74, 0x21, 0xff}));
+    // tagged epoch time
+    EXPECT_EQ(Value{int64_t{1363896240}},
+              decode({0xc1, 0x1a, 0x51, 0x4b, 0x67, 0xb0}));
+}
+
+TEST(json_cbor, test_encode_rfc_examples)
+{
+    EXPECT_EQ(cbor::Bytes({0x17}), cbor::dump(Value{int64_t{23}}));
+    EXPECT_EQ(cbor::Bytes({0x18, 0x18}), cbor::dump(Value{int64_t{24}}));
+    EXPECT_EQ(cbor::Bytes({0x38, 0x63}), cbor::dump(Value{int64_t{-100}}));
+    EXPECT_EQ(cbor::Bytes({0x1a, 0x00, 0x0f, 0x42, 0x40}),
+              cbor::dump(Value{int64_t{1000000}}));
+    EXPECT_EQ(cbor::Bytes({0x3b, 0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}),
+              cbor::dump(Value{std::numeric_limits<int64_t>::min()}));
+    EXPECT_EQ(cbor::Bytes({0xa2, 0x61, 0x61, 0x01, 0x61, 0x62, 0x82, 0x02, 0x03}),
+              cbor::dump(load(R"({"a": 1, "b": [2, 3]})")));
+}
+
+TEST(json_cbor, test_round_trip)
+{
+    for (const char* document : documents) {
+        const Value value = load(document);
+        EXPECT_EQ(value, cbor::load(cbor::dump(value))) << document;
+    }
+}
+
+TEST(json_cbor, test_encoder_round_trip)
+{
+    for (const char* document : documents) {
+        cbor::Encoder encoder;
+        parse(document, encoder);
+        EXPECT_EQ(load(document), cbor::load(encoder.bytes())) << document;
+
+        // and back to events
+        cbor::Encoder reencoder;
+        const cbor::Bytes& bytes = encoder.bytes();
+        cbor::parse(bytes.data(), bytes.data() + bytes.size(), reencoder);
+        EXPECT_EQ(bytes, reencoder.bytes()) << document;
+    }
+}
+
+TEST(json_cbor, test_decode_invalid)
+{
+    EXPECT_EQ(DiagError::InvalidEncoding, decodeError({}));
+    EXPECT_EQ(DiagError::InvalidEncoding, decodeError({0x19, 0x03}));
+    EXPECT_EQ(DiagError::InvalidEncoding, decodeError({0x64, 0x49, 0x45}));
+    EXPECT_EQ(DiagError::InvalidEncoding, decodeError({0x83, 0x01, 0x02}));
+    EXPECT_EQ(DiagError::InvalidEncoding, decodeError({0x9f, 0x01}));
+    EXPECT_EQ(DiagError::InvalidEncoding, decodeError({0x01, 0x02}));
+    // byte string, non-text key, stray break, reserved info
+    EXPECT_EQ(DiagError::InvalidEncoding, decodeError({0x41, 0x00}));
+    EXPECT_EQ(DiagError::InvalidEncoding, decodeError({0xa1, 0x01, 0x02}));
+    EXPECT_EQ(DiagError::InvalidEncoding, decodeError({0xff}));
+    EXPECT_EQ(DiagError::InvalidEncoding, decodeError({0xbf, 0x61, 0x61, 0xff}));
+    EXPECT_EQ(DiagError::InvalidEncoding, decodeError({0x1c}));
+    // length beyond the input
+    EXPECT_EQ(DiagError::InvalidEncoding,
+              decodeError({0x7b, 0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}));
+}
+
+TEST(json_cbor, test_decode_max_depth)
+{
+    const cbor::Bytes nested(1000, 0x81);
+    EXPECT_THROW(cbor::load(nested), cbor::Error);
+    try {
+        cbor::load(cbor::Bytes(200, 0x81));
+        FAIL();
+    } catch (const cbor::Error& e) {
+        EXPECT_EQ(DiagError::MaxDepthExceeded, e.issue);
+    }
+    cbor::Bytes balanced(50, 0x81);
+    balanced.push_back(0x80);
+    EXPECT_NO_THROW(cbor::load(balanced));
+}
@@ -0,0 +1,22 @@
+#ifndef INCLUDE_POLIP_JSON_IMPL_MOD_TESTS_UT_FIXTURES_HPP
+#define INCLUDE_POLIP_JSON_IMPL_MOD_TESTS_UT_FIXTURES_HPP
+
+#include <string>
+
+// a small document with every kind of value, laid out over several lines
+const std::string config = R"({
+    "name": "service",
+    "limits": {"cpu": 2, "memory": [512, 1024]},
+    "tags": ["a", "b"],
+    "enabled": true,
+    "ratio": 0.5,
+    "owner": null,
+    "ports": [
+        80,
+        443
+    ],
+    "nested": [[[]], [{}], {"x": [1]}]
+}
+)";
+
+#endif  // INCLUDE_POLIP_JSON_IMPL_MOD_TESTS_UT_FIXTURES_HPP
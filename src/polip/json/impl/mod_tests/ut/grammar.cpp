@@ -113,7 +113,7 @@ TEST(json_string_grammar, test_invalid_special_chars)
 {
     const std::string input = "\"x\\yz\"";
     ParseError e = expectStringParsingError(input);
-    EXPECT_EQ(DiagError::ExpectedQuot, e.issue);
+    EXPECT_EQ(DiagError::InvalidSpecialChar, e.issue);
     EXPECT_EQ(input.begin() + 3, e.where);
 }
 
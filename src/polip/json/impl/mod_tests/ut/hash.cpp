@@ -0,0 +1,75 @@
+#include <limits>
+#include <unordered_set>
+#include <gtest/gtest.h>
+#include "polip/json/hash.hpp"
+#include "polip/json/parser.hpp"
+
+using namespace polip::json;
+
+TEST(json_hash, test_equal_values_hash_equal)
+{
+    const char* document = R"({"a": [1, 2.5, "x", null, true], "b": {}})";
+    EXPECT_EQ(hash(load(document)), hash(load(document)));
+    EXPECT_EQ(hash(Value(0.0)), hash(Value(-0.0)));
+    EXPECT_EQ(unorderedHash(load(document)), unorderedHash(load(document)));
+}
+
+TEST(json_hash, test_distinct_values)
+{
+    const char* documents[] = {
+        "null", "true", "false", "0", "1", "0.0", "1.0", R"("")", R"("1")",
+        R"("abcdefgh")", R"("abcdefgi")", "[]", "{}", "[[]]", "[{}]",
+        "[null]", R"({"a": null})", R"({"": null})", "[1, 2]", "[2, 1]",
+        R"({"a": 1, "b": 2})", R"({"a": 2, "b": 1})", R"(["a", "b"])",
+        R"(["ab"])"};
+    std::unordered_set<std::uint64_t> hashes;
+    for (const char* document : documents) {
+        EXPECT_TRUE(hashes.insert(hash(load(document))).second) << document;
+    }
+}
+
+TEST(json_hash, test_member_order)
+{
+    const Value lhs = load(R"({"a": 1, "b": {"c": [1, 2], "d": null}})");
+    const Value rhs = load(R"({"b": {"d": null, "c": [1, 2]}, "a": 1})");
+    EXPECT_NE(lhs, rhs);
+    EXPECT_NE(hash(lhs), hash(rhs));
+    EXPECT_TRUE(unorderedEqual(lhs, rhs));
+    EXPECT_EQ(unorderedHash(lhs), unorderedHash(rhs));
+
+    const Value arrays = load(R"({"b": {"d": null, "c": [2, 1]}, "a": 1})");
+    EXPECT_FALSE(unorderedEqual(lhs, arrays));
+    EXPECT_NE(unorderedHash(lhs), unorderedHash(arrays));
+    EXPECT_FALSE(unorderedEqual(lhs, load(R"({"a": 1})")));
+    EXPECT_FALSE(unorderedEqual(load(R"({"a": 1})"), load(R"({"b": 1})")));
+}
+
+TEST(json_hash, test_nan_not_equal_to_itself)
+{
+    Value nan = Object{};
+    nan.set("x", std::numeric_limits<double>::quiet_NaN());
+    EXPECT_FALSE(unorderedEqual(nan, nan));
+    const HashedValue hashed(nan);
+    EXPECT_NE(hashed, hashed);
+}
+
+TEST(json_hash, test_stable)
+{
+    // pinned for little-endian platforms, hashes may be persisted
+    EXPECT_EQ(3267336054076652700ull, hash(load(R"({"a": [1, 2.5, "xyz", null]})")));
+}
+
+TEST(json_hash, test_hashed_value)
+{
+    const HashedValue lhs(load(R"([1, {"a": "b"}])"));
+    const HashedValue same(load(R"([1, {"a": "b"}])"));
+    const HashedValue other(load(R"([1, {"a": "c"}])"));
+    EXPECT_EQ(hash(lhs.value()), lhs.hash());
+    EXPECT_EQ(lhs, same);
+    EXPECT_NE(lhs, other);
+
+    std::unordered_set<HashedValue> unique{lhs, same, other};
+    EXPECT_EQ(2u, unique.size());
+    std::unordered_set<Value> values{lhs.value(), same.value()};
+    EXPECT_EQ(1u, values.size());
+}
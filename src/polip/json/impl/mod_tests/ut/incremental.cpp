@@ -0,0 +1,268 @@
+#include <gtest/gtest.h>
+#include "polip/json/incremental.hpp"
+
+using namespace polip::json;
+
+namespace
+{
+
+const char* const documents[] = {
+    "null", "true", " false ", "0", "-12", "1.5", "-2e3", ".5", "inf",
+    R"("")", R"("a\"b\\c\/\b\f\n\r\t\v")",
+    "[]", "{}", " [ 1 , [ ] , { } , null ] ",
+    R"({"a": {"b": [true, {"c": "d"}]}, "e": {}, "f": [[], [1.25]]})",
+    R"(["\\", "\"", "x\\\"y", 123456789, -0.125e-3, false])",
+    "// comment\n[1, /* two */ 2, // end\n]",
+    R"({'a': ['it\'s', "\"", Infinity, -Infinity,], 'b': {/*}*/},})",
+    R"(["\u0041\u00e9\ud83d\ude00", "\u001f\\u0041", )" "\"za\xc5\xbc\"]",
+    "99999999999999999999"};
+
+ParseOptions iterative(Conformance level = Conformance::Relaxed)
+{
+    ParseOptions options;
+    options.engine = Engine::Iterative;
+    options.level = level;
+    return options;
+}
+
+// feeds the document in chunks of size bytes
+void feed(IncrementalParser& parser, const std::string& input,
+          std::size_t size)
+{
+    for (std::size_t at = 0; at < input.size(); at += size) {
+        parser.feed(input.substr(at, size));
+    }
+    parser.finish();
+}
+
+class EventRecorder : public DispatchTarget
+{
+public:
+    std::string events;
+    std::string skippedMember;
+    bool skipArrays = false;
+
+private:
+    void objectBeginImpl(const std::string& name) override
+    {
+        events += "{" + name + ":";
+    }
+    void objectEndImpl() override { events += "}"; }
+    void arrayBeginImpl() override { events += "["; }
+    void arrayEndImpl() override { events += "]"; }
+    void nullValueImpl() override { events += "n "; }
+    void boolValueImpl(bool v) override { events += v ? "t " : "f "; }
+    void integerValueImpl(int64_t v) override
+    {
+        events += std::to_string(v) + " ";
+    }
+    void doubleValueImpl(double v) override
+    {
+        events += std::to_string(v) + " ";
+    }
+    void stringValueImpl(const std::string& v) override
+    {
+        events += "'" + v + "' ";
+    }
+
+    bool skipMemberImpl(const std::string& name) override
+    {
+        return name == skippedMember;
+    }
+    bool skipArrayImpl() override { return skipArrays; }
+};
+
+// issue and offset of the error of parsing input at once
+std::pair<DiagError, std::size_t> wholeError(const std::string& input,
+                                             const ParseOptions& options)
+{
+    EventRecorder recorder;
+    try {
+        parse(input.data(), input.data() + input.size(), recorder, options);
+    } catch (const parse_error<const char*>& e) {
+        return {e.issue, static_cast<std::size_t>(e.where - input.data())};
+    }
+    return {DiagError::Other, std::string::npos};
+}
+
+std::pair<DiagError, std::size_t> chunkedError(const std::string& input,
+                                               std::size_t size,
+                                               const ParseOptions& options)
+{
+    EventRecorder recorder;
+    IncrementalParser parser(recorder, options);
+    try {
+        feed(parser, input, size);
+    } catch (const IncrementalParser::Error& e) {
+        EXPECT_EQ(0, e.begin);
+        EXPECT_LE(e.where, e.end);
+        return {e.issue, e.where};
+    }
+    return {DiagError::Other, std::string::npos};
+}
+
+}  // anonymous namespace
+
+TEST(json_incremental, test_incremental_load)
+{
+    for (const std::string input : documents) {
+        const Value expected = load(input, iterative());
+        for (std::size_t size = 1; size <= input.size(); ++size) {
+            IncrementalParser parser(iterative());
+            feed(parser, input, size);
+            EXPECT_TRUE(parser.done());
+            EXPECT_EQ(expected, parser.value()) << input << " " << size;
+        }
+    }
+}
+
+TEST(json_incremental, test_incremental_cut_everywhere)
+{
+    const std::string input =
+        R"({"name": "a \"quoted\" \\ name", "n": [1, -2.5e10, true, null],)"
+        R"( "nested": {"x": {"y": []}, "z": "\/"}})";
+    const Value expected = load(input);
+    for (std::size_t cut = 0; cut <= input.size(); ++cut) {
+        IncrementalParser parser;
+        parser.feed(input.substr(0, cut));
+        EXPECT_TRUE(parser.feed(input.substr(cut)));
+        parser.finish();
+        EXPECT_EQ(expected, parser.value()) << cut;
+    }
+}
+
+TEST(json_incremental, test_incremental_events)
+{
+    const std::string input =
+        R"({"a": {}, "skip": [1, "]", {"b": "\"]"}, '[', /* ] */],)"
+        R"( "c": [1, "x", null],)"
+        R"( "d": {"e": true}, "f": [[2], "y"]})";
+    EventRecorder whole;
+    whole.skippedMember = "skip";
+    whole.skipArrays = true;
+    parse(input, whole);
+    EXPECT_EQ("{a:}{c:[]{d:{e:t }{f:[]}", whole.events);
+
+    EventRecorder members;
+    members.skippedMember = "skip";
+    parse(input, members);
+    for (std::size_t size = 1; size <= input.size(); ++size) {
+        EventRecorder recorder;
+        recorder.skippedMember = "skip";
+        recorder.skipArrays = true;
+        IncrementalParser parser(recorder);
+        feed(parser, input, size);
+        EXPECT_EQ(whole.events, recorder.events) << size;
+
+        EventRecorder memberRecorder;
+        memberRecorder.skippedMember = "skip";
+        IncrementalParser memberParser(memberRecorder);
+        feed(memberParser, input, size);
+        EXPECT_EQ(members.events, memberRecorder.events) << size;
+    }
+}
+
+TEST(json_incremental, test_incremental_done)
+{
+    IncrementalParser parser;
+    EXPECT_FALSE(parser.feed("[1, "));
+    EXPECT_FALSE(parser.done());
+    EXPECT_TRUE(parser.feed("2] "));
+    EXPECT_TRUE(parser.feed(" \n"));
+    parser.finish();
+    EXPECT_EQ(load("[1, 2]"), parser.value());
+    EXPECT_THROW(parser.feed("x"), IncrementalParser::Error);
+
+    // a number may go on in the next chunk
+    IncrementalParser number;
+    EXPECT_FALSE(number.feed("12"));
+    EXPECT_FALSE(number.feed("34"));
+    number.finish();
+    EXPECT_TRUE(number.done());
+    EXPECT_EQ(int64_t{1234}, number.value().as<int64_t>());
+}
+
+TEST(json_incremental, test_incremental_buffered)
+{
+    IncrementalParser parser;
+    parser.feed(R"([1, "abc)");
+    EXPECT_EQ(4, parser.buffered());
+    parser.feed(R"(def", 12)");
+    EXPECT_EQ(2, parser.buffered());
+    parser.feed(R"(3, {"k)");
+    EXPECT_EQ(2, parser.buffered());
+    parser.feed(R"(ey": [)");
+    EXPECT_EQ(0, parser.buffered());
+    parser.feed("]}]");
+    parser.finish();
+    EXPECT_EQ(load(R"([1, "abcdef", 123, {"key": []}])"), parser.value());
+
+    // skipped containers are not held
+    EventRecorder recorder;
+    recorder.skipArrays = true;
+    IncrementalParser skipping(recorder);
+    skipping.feed(R"({"a": [1, "long )");
+    EXPECT_EQ(0, skipping.buffered());
+    skipping.feed(R"(string \"]"], "b": 2})");
+    skipping.finish();
+    EXPECT_EQ("{a:[]{b:2 }", recorder.events);
+}
+
+TEST(json_incremental, test_incremental_errors)
+{
+    const char* inputs[] = {"", "+1", "01", "-01", "1a2", "e1", "Null",
+                            "[", "[1,", "[1,,]", "[1 2]", "{", R"({"a")",
+                            R"({"a":})", R"({"a" 1})", R"({1: 2})",
+                            R"("abc)", R"("a\yb")", "[] []", "truex",
+                            R"({"a": 1 "b": 2})", R"({"a": x})", "[1}",
+                            R"({"a": 1])", "[,]", "{,}", "/* x", "[1 /",
+                            "[1 // x"};
+    for (const std::string input : inputs) {
+        const auto expected = wholeError(input, iterative());
+        EXPECT_NE(std::string::npos, expected.second) << input;
+        for (std::size_t size = 1; size <= input.size() + 1; ++size) {
+            EXPECT_EQ(expected, chunkedError(input, size, iterative()))
+                << input << " " << size;
+        }
+    }
+
+    const ParseOptions strict = iterative(Conformance::Strict);
+    EXPECT_EQ(wholeError("1", strict), chunkedError("1", 1, strict));
+    EXPECT_EQ(wholeError("[.5]", strict), chunkedError("[.5]", 1, strict));
+    EXPECT_EQ(wholeError(R"(["\v"])", strict),
+              chunkedError(R"(["\v"])", 2, strict));
+
+    EventRecorder recorder;
+    recorder.skipArrays = true;
+    IncrementalParser skipping(recorder);
+    skipping.feed(R"({"a": ["x)");
+    try {
+        skipping.finish();
+        FAIL();
+    } catch (const IncrementalParser::Error& e) {
+        EXPECT_EQ(DiagError::ExpectedQuot, e.issue);
+        EXPECT_EQ(9, e.where);
+    }
+}
+
+TEST(json_incremental, test_incremental_max_depth)
+{
+    ParseOptions options = iterative();
+    options.maxDepth = 3;
+    IncrementalParser parser(options);
+    parser.feed("[[[");
+    EXPECT_THROW(parser.feed("["), IncrementalParser::Error);
+
+    const std::size_t depth = 100000;
+    options.maxDepth = depth;
+    EventRecorder recorder;
+    IncrementalParser deep(recorder, options);
+    for (std::size_t i = 0; i < depth; ++i) {
+        deep.feed("[");
+    }
+    for (std::size_t i = 0; i < depth; ++i) {
+        deep.feed("]");
+    }
+    deep.finish();
+    EXPECT_EQ(2 * depth, recorder.events.size());
+}
@@ -0,0 +1,406 @@
+#include <list>
+#include <gtest/gtest.h>
+#include "polip/json/bind.hpp"
+#include "polip/json/incremental.hpp"
+#include "polip/json/parser_templates.hpp"
+
+namespace test_limits
+{
+
+struct Record
+{
+    std::string name;
+    std::vector<int64_t> values;
+};
+
+}  // namespace test_limits
+
+BOOST_FUSION_ADAPT_STRUCT(test_limits::Record, name, values)
+
+using namespace polip::json;
+using test_limits::Record;
+
+namespace
+{
+
+// issue and offset of an error
+using Failure = std::pair<DiagError, std::size_t>;
+
+const Failure none{DiagError::Other, std::string::npos};
+
+Failure loadFailure(const std::string& input, const ParseOptions& options)
+{
+    try {
+        load(input.data(), input.data() + input.size(), options);
+    } catch (const parse_error<const char*>& e) {
+        return {e.issue, static_cast<std::size_t>(e.where - input.data())};
+    }
+    return none;
+}
+
+// input that is not random access
+Failure listFailure(const std::string& input, const ParseOptions& options)
+{
+    const std::list<char> chars(input.begin(), input.end());
+    try {
+        load(chars.begin(), chars.end(), options);
+    } catch (const parse_error<std::list<char>::const_iterator>& e) {
+        return {e.issue, static_cast<std::size_t>(
+                             std::distance(chars.begin(), e.where))};
+    }
+    return none;
+}
+
+Failure chunkedFailure(const std::string& input, std::size_t size,
+                       const ParseOptions& options)
+{
+    IncrementalParser parser(options);
+    try {
+        for (std::size_t at = 0; at < input.size(); at += size) {
+            parser.feed(input.substr(at, size));
+        }
+        parser.finish();
+    } catch (const IncrementalParser::Error& e) {
+        return {e.issue, e.where};
+    }
+    return none;
+}
+
+// the same failure from every engine and input
+void expectFailure(const Failure& expected, const std::string& input,
+                   const ParseLimits& limits)
+{
+    ParseOptions options;
+    options.limits = limits;
+    for (Engine engine : {Engine::Recursive, Engine::Iterative}) {
+        options.engine = engine;
+        EXPECT_EQ(expected, loadFailure(input, options)) << input;
+        EXPECT_EQ(expected, listFailure(input, options)) << input;
+    }
+    for (std::size_t size = 1; size <= input.size(); ++size) {
+        EXPECT_EQ(expected, chunkedFailure(input, size, options))
+            << input << " " << size;
+    }
+}
+
+// forward iterator over chars remembering the farthest one read
+class Probe
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = char;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const char*;
+    using reference = const char&;
+
+    Probe() = default;
+
+    Probe(const char* it, const char** farthest)
+        : m_it(it), m_farthest(farthest)
+    {
+    }
+
+    reference operator*() const
+    {
+        if (m_it > *m_farthest) {
+            *m_farthest = m_it;
+        }
+        return *m_it;
+    }
+
+    Probe& operator++()
+    {
+        ++m_it;
+        return *this;
+    }
+
+    Probe operator++(int)
+    {
+        Probe old = *this;
+        ++m_it;
+        return old;
+    }
+
+    bool operator==(const Probe& rhs) const
+    {
+        return m_it == rhs.m_it;
+    }
+
+    bool operator!=(const Probe& rhs) const
+    {
+        return m_it != rhs.m_it;
+    }
+
+private:
+    const char* m_it = nullptr;
+    const char** m_farthest = nullptr;
+};
+
+template <typename T>
+Failure bindFailure(const std::string& input, const ParseOptions& options)
+{
+    try {
+        load_into<T>(input, options);
+    } catch (const parse_error<const char*>& e) {
+        return {e.issue, static_cast<std::size_t>(e.where - input.data())};
+    }
+    return none;
+}
+
+// the same failure from load_into() as from load()
+template <typename T>
+void expectBindFailure(const Failure& expected, const std::string& input,
+                       const ParseLimits& limits)
+{
+    ParseOptions options;
+    options.limits = limits;
+    EXPECT_EQ(expected, bindFailure<T>(input, options)) << input;
+    EXPECT_EQ(expected, loadFailure(input, options)) << input;
+}
+
+ParseLimits documentBytes(std::size_t n)
+{
+    ParseLimits limits;
+    limits.maxDocumentBytes = n;
+    return limits;
+}
+
+ParseLimits stringLength(std::size_t n)
+{
+    ParseLimits limits;
+    limits.maxStringLength = n;
+    return limits;
+}
+
+ParseLimits containerElements(std::size_t n)
+{
+    ParseLimits limits;
+    limits.maxContainerElements = n;
+    return limits;
+}
+
+ParseLimits nodes(std::size_t n)
+{
+    ParseLimits limits;
+    limits.maxNodes = n;
+    return limits;
+}
+
+ParseLimits numberLength(std::size_t n)
+{
+    ParseLimits limits;
+    limits.maxNumberLength = n;
+    return limits;
+}
+
+}  // anonymous namespace
+
+TEST(json_limits, test_document_bytes)
+{
+    expectFailure(none, "[1, 2]", documentBytes(6));
+    expectFailure({DiagError::DocumentTooLarge, 6}, "[1, 2] ",
+                  documentBytes(6));
+    expectFailure({DiagError::DocumentTooLarge, 0}, "1", documentBytes(0));
+
+    // refused before anything else is looked at
+    ParseOptions options;
+    options.limits = documentBytes(3);
+    EXPECT_EQ(Failure(DiagError::DocumentTooLarge, 3),
+              loadFailure("[1,,]", options));
+}
+
+TEST(json_limits, test_string_length)
+{
+    expectFailure(none, R"(["abc", "a\"\\"])", stringLength(3));
+    expectFailure({DiagError::StringTooLong, 8}, R"(["abc", "abcd"])",
+                  stringLength(3));
+    expectFailure({DiagError::StringTooLong, 1}, R"(["a\n\t\\"])",
+                  stringLength(3));
+    expectFailure({DiagError::StringTooLong, 1}, R"({"abcd": 1})",
+                  stringLength(3));
+    expectFailure({DiagError::StringTooLong, 2}, "[ 'abcd']",
+                  stringLength(3));
+    expectFailure(none, R"("")", stringLength(0));
+    expectFailure({DiagError::StringTooLong, 0}, R"("a")", stringLength(0));
+}
+
+TEST(json_limits, test_container_elements)
+{
+    expectFailure(none, R"([[1, 2], {"a": 1, "b": [3, 4]}])",
+                  containerElements(2));
+    // counted per container
+    expectFailure({DiagError::TooManyElements, 12}, "[1, [2, 3], 4]",
+                  containerElements(2));
+    expectFailure({DiagError::TooManyElements, 17},
+                  R"({"a": 1, "b": 2, "c": 3})", containerElements(2));
+    expectFailure({DiagError::TooManyElements, 1}, "[1]",
+                  containerElements(0));
+    expectFailure(none, "[1, 2,]", containerElements(2));
+}
+
+TEST(json_limits, test_nodes)
+{
+    // the array, 1, the object and "b"
+    expectFailure(none, R"([1, {"a": "b"}])", nodes(4));
+    expectFailure({DiagError::TooManyNodes, 10}, R"([1, {"a": [2]}])",
+                  nodes(3));
+    expectFailure({DiagError::TooManyNodes, 11}, R"([1, {"a": [2]}])",
+                  nodes(4));
+    expectFailure(none, "[1, 2,]", nodes(3));
+}
+
+TEST(json_limits, test_number_length)
+{
+    expectFailure(none, "[-1.5e+10, 12345678, true, null]", numberLength(8));
+    expectFailure({DiagError::NumberTooLong, 4}, "[1, 123456789]",
+                  numberLength(8));
+    expectFailure({DiagError::NumberTooLong, 1},
+                  "[" + std::string(100, '9') + "]", numberLength(20));
+    expectFailure({DiagError::NumberTooLong, 0}, "-0.5", numberLength(3));
+}
+
+TEST(json_limits, test_number_not_read_beyond)
+{
+    const std::string input = "[" + std::string(1000000, '9') + "]";
+    ParseOptions options;
+    options.limits = numberLength(20);
+    const char* farthest = input.data();
+    try {
+        load(Probe(input.data(), &farthest),
+             Probe(input.data() + input.size(), &farthest), options);
+        FAIL();
+    } catch (const parse_error<Probe>& e) {
+        EXPECT_EQ(DiagError::NumberTooLong, e.issue);
+    }
+    EXPECT_GE(22, farthest - input.data());
+
+    for (std::size_t size : {std::size_t{64}, input.size()}) {
+        EXPECT_EQ(Failure(DiagError::NumberTooLong, 1),
+                  chunkedFailure(input, size, options));
+    }
+    EXPECT_EQ(Failure(DiagError::NumberTooLong, 1),
+              bindFailure<std::vector<double>>(input, options));
+}
+
+TEST(json_limits, test_incremental_holds_no_more)
+{
+    ParseOptions options;
+    options.limits = stringLength(100);
+    IncrementalParser strings(options);
+    strings.feed(R"(["ok", ")");
+    strings.feed(std::string(50, 'x'));
+    // 25 escaped backslashes
+    strings.feed(std::string(50, '\\'));
+    EXPECT_EQ(101, strings.buffered());
+    try {
+        strings.feed(std::string(26, 'y'));
+        FAIL();
+    } catch (const IncrementalParser::Error& e) {
+        EXPECT_EQ(DiagError::StringTooLong, e.issue);
+        EXPECT_EQ(7, e.where);
+    }
+
+    options.limits = numberLength(10);
+    IncrementalParser numbers(options);
+    numbers.feed("[1, 12345");
+    EXPECT_THROW(numbers.feed("678901"), IncrementalParser::Error);
+
+    options.limits = documentBytes(10);
+    IncrementalParser document(options);
+    document.feed("[1, 2, ");
+    try {
+        document.feed("3, 4]");
+        FAIL();
+    } catch (const IncrementalParser::Error& e) {
+        EXPECT_EQ(DiagError::DocumentTooLarge, e.issue);
+        EXPECT_EQ(10, e.where);
+        EXPECT_EQ(12, e.end);
+    }
+}
+
+TEST(json_limits, test_skipped_values)
+{
+    class Skipping : public DispatchTarget
+    {
+        void objectBeginImpl(const std::string&) override {}
+        void objectEndImpl() override {}
+        void arrayBeginImpl() override {}
+        void arrayEndImpl() override {}
+        void nullValueImpl() override {}
+        void boolValueImpl(bool) override {}
+        void integerValueImpl(int64_t) override {}
+        void doubleValueImpl(double) override {}
+        void stringValueImpl(const std::string&) override {}
+        bool skipMemberImpl(const std::string& name) override
+        {
+            return name == "skip";
+        }
+    };
+
+    // the skipped member counts as a member, its value not at all
+    const std::string input = R"({"skip": [1, 2, 3, "long string"], "a": 1})";
+    ParseOptions options;
+    options.limits = nodes(2);
+    options.limits.maxStringLength = 4;
+    options.limits.maxContainerElements = 2;
+    Skipping target;
+    EXPECT_NO_THROW(parse(input, target, options));
+    Skipping chunked;
+    IncrementalParser parser(chunked, options);
+    parser.feed(input);
+    parser.finish();
+    EXPECT_TRUE(parser.done());
+}
+
+TEST(json_limits, test_load_into)
+{
+    using Integers = std::vector<int64_t>;
+    using Strings = std::vector<std::string>;
+    using Nested = std::vector<Integers>;
+
+    expectBindFailure<Integers>(none, "[1, 2]", documentBytes(6));
+    expectBindFailure<Integers>({DiagError::DocumentTooLarge, 6}, "[1, 2] ",
+                                documentBytes(6));
+
+    expectBindFailure<Strings>(none, R"(["abc", "a\"\\"])",
+                               stringLength(3));
+    expectBindFailure<Strings>({DiagError::StringTooLong, 8},
+                               R"(["abc", "abcd"])", stringLength(3));
+    // member names, also those of skipped members
+    expectBindFailure<Record>({DiagError::StringTooLong, 1},
+                              R"({"abcd": 1})", stringLength(3));
+
+    expectBindFailure<Nested>(none, "[[1, 2], [3], []]",
+                              containerElements(3));
+    expectBindFailure<Nested>({DiagError::TooManyElements, 8}, "[[1, 2, 3]]",
+                              containerElements(2));
+    expectBindFailure<Nested>({DiagError::TooManyElements, 14},
+                              "[[1], [2, 3], [4]]", containerElements(2));
+    expectBindFailure<Record>({DiagError::TooManyElements, 28},
+                              R"({"name": "a", "values": [], "x": 1})",
+                              containerElements(2));
+    expectBindFailure<Integers>(none, "[1, 2,]", containerElements(2));
+
+    // the object, "a", the array and 1
+    expectBindFailure<Record>(none, R"({"name": "a", "values": [1]})",
+                              nodes(4));
+    expectBindFailure<Record>({DiagError::TooManyNodes, 28},
+                              R"({"name": "a", "values": [1, 2]})", nodes(4));
+
+    expectBindFailure<Integers>({DiagError::NumberTooLong, 4},
+                                "[1, 123456789]", numberLength(8));
+    expectBindFailure<std::vector<double>>({DiagError::NumberTooLong, 1},
+                                           "[-1.5e+100]", numberLength(8));
+    expectBindFailure<std::vector<uint64_t>>(
+        {DiagError::NumberTooLong, 1}, "[18446744073709551615]",
+        numberLength(19));
+
+    // skipped members are not counted, as in test_skipped_values
+    ParseOptions options;
+    options.limits = nodes(2);
+    options.limits.maxStringLength = 4;
+    options.limits.maxContainerElements = 2;
+    EXPECT_EQ(none, bindFailure<Record>(
+                        R"({"skip": [1, 2, 3, "long string"], "name": "a"})",
+                        options));
+}
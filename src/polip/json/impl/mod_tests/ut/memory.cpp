@@ -0,0 +1,253 @@
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <gtest/gtest.h>
+#include "polip/json/incremental.hpp"
+#include "polip/json/memory.hpp"
+#include "polip/json/parser.hpp"
+#include "polip/json/source.hpp"
+#include "fixtures.hpp"
+
+using namespace polip::json;
+
+namespace
+{
+
+// counts the blocks taken from it and not given back
+class CountingResource : public MemoryResource
+{
+public:
+    std::size_t blocks = 0;
+    std::size_t allocations = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t) override
+    {
+        ++blocks;
+        ++allocations;
+        return std::malloc(bytes);
+    }
+
+    void do_deallocate(void* p, std::size_t, std::size_t) override
+    {
+        --blocks;
+        std::free(p);
+    }
+
+    bool do_is_equal(const MemoryResource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+ParseOptions withResource(MemoryResource& resource, Engine engine)
+{
+    ParseOptions options;
+    options.engine = engine;
+    options.resource = &resource;
+    return options;
+}
+
+// a large array of small objects
+std::string makeRecords(unsigned records)
+{
+    std::string document = "[";
+    for (unsigned i = 0; i < records; ++i) {
+        document += (i ? "," : "");
+        document += R"({"id": )" + std::to_string(i) + R"(, "v": [1, 2]})";
+    }
+    return document + "]";
+}
+
+}  // anonymous namespace
+
+TEST(json_memory, test_load_from_resource)
+{
+    const Value expected = load(config);
+    for (Engine engine : {Engine::Recursive, Engine::Iterative}) {
+        CountingResource resource;
+        {
+            const Value value = load(config, withResource(resource, engine));
+            EXPECT_EQ(expected, value);
+            // all containers but the empty ones
+            EXPECT_LE(8u, resource.blocks);
+            EXPECT_EQ(nullptr, currentResource());
+        }
+        EXPECT_EQ(0u, resource.blocks);
+        EXPECT_LT(0u, resource.allocations);
+    }
+
+    CountingResource resource;
+    {
+        IncrementalParser parser(withResource(resource, Engine::Iterative));
+        const std::string input = config;
+        for (char c : input) {
+            parser.feed(&c, &c + 1);
+        }
+        parser.finish();
+        EXPECT_EQ(expected, parser.value());
+        EXPECT_LE(8u, resource.blocks);
+    }
+    EXPECT_EQ(0u, resource.blocks);
+}
+
+TEST(json_memory, test_source_map_from_resource)
+{
+    CountingResource resource;
+    {
+        Value value;
+        SourceMap sources;
+        load(config, value, sources,
+             withResource(resource, Engine::Iterative));
+        EXPECT_EQ(load(config), value);
+        EXPECT_LE(8u, resource.blocks);
+        EXPECT_EQ(nullptr, currentResource());
+    }
+    EXPECT_EQ(0u, resource.blocks);
+
+    BudgetResource budget(100);
+    Value value;
+    SourceMap sources;
+    EXPECT_THROW(load(config, value, sources,
+                      withResource(budget, Engine::Iterative)),
+                 budget_exceeded);
+    EXPECT_EQ(0u, budget.used());
+}
+
+TEST(json_memory, test_resource_scope)
+{
+    CountingResource outer;
+    CountingResource inner;
+    {
+        const ResourceScope outerScope(&outer);
+        EXPECT_EQ(&outer, currentResource());
+        Value array = Array{};
+        array.pushBack(int64_t{1});
+        {
+            const ResourceScope innerScope(&inner);
+            EXPECT_EQ(&inner, currentResource());
+            // load() without a resource keeps the current one
+            Value loaded = load("[1, 2]");
+            EXPECT_EQ(1u, inner.blocks);
+            // a block is given back to its own resource
+            array = std::move(loaded);
+            EXPECT_EQ(0u, outer.blocks);
+            EXPECT_EQ(1u, inner.blocks);
+            {
+                const ResourceScope none(nullptr);
+                EXPECT_EQ(nullptr, currentResource());
+                array.pushBack(int64_t{3});
+            }
+            EXPECT_EQ(0u, inner.blocks);
+        }
+        EXPECT_EQ(&outer, currentResource());
+        EXPECT_EQ(load("[1, 2, 3]"), array);
+    }
+    EXPECT_EQ(nullptr, currentResource());
+    EXPECT_EQ(0u, outer.blocks);
+    EXPECT_EQ(0u, inner.blocks);
+}
+
+TEST(json_memory, test_budget)
+{
+    const std::string document = makeRecords(1000);
+    for (Engine engine : {Engine::Recursive, Engine::Iterative}) {
+        BudgetResource unlimited(std::size_t(-1));
+        {
+            const Value value =
+                load(document, withResource(unlimited, engine));
+            EXPECT_EQ(1000u, value.size());
+            EXPECT_LT(0u, unlimited.used());
+            EXPECT_LE(unlimited.used(), unlimited.peak());
+        }
+        EXPECT_EQ(0u, unlimited.used());
+
+        // fails cleanly half way through
+        BudgetResource budget(unlimited.peak() / 2);
+        EXPECT_THROW(load(document, withResource(budget, engine)),
+                     budget_exceeded);
+        EXPECT_EQ(0u, budget.used());
+        EXPECT_LE(budget.peak(), budget.limit());
+        EXPECT_EQ(nullptr, currentResource());
+    }
+
+    BudgetResource budget(1000);
+    IncrementalParser parser(withResource(budget, Engine::Iterative));
+    EXPECT_THROW(parser.feed(document), budget_exceeded);
+}
+
+TEST(json_memory, test_budget_strings)
+{
+    const std::string text(1000, 'x');
+    const std::string documents[] = {"[\"" + text + "\"]",
+                                     "{\"" + text + "\": 1}",
+                                     "{\"a\": [\"" + text + "\"]}",
+                                     "\"" + text + "\""};
+    for (Engine engine : {Engine::Recursive, Engine::Iterative}) {
+        for (const std::string& document : documents) {
+            BudgetResource budget(500);
+            EXPECT_THROW(load(document, withResource(budget, engine)),
+                         budget_exceeded)
+                << document.substr(0, 10);
+            EXPECT_EQ(0u, budget.used());
+        }
+
+        // held while the container is
+        BudgetResource unlimited(std::size_t(-1));
+        {
+            const Value value =
+                load(documents[2], withResource(unlimited, engine));
+            EXPECT_LT(text.size(), unlimited.used());
+        }
+        EXPECT_EQ(0u, unlimited.used());
+
+        // short strings are kept inline, not charged
+        BudgetResource strings(std::size_t(-1));
+        BudgetResource numbers(std::size_t(-1));
+        const Value a =
+            load(R"(["a", {"b": "c"}])", withResource(strings, engine));
+        const Value b =
+            load(R"([1, {"b": 2}])", withResource(numbers, engine));
+        EXPECT_EQ(numbers.used(), strings.used());
+    }
+
+    BudgetResource budget(500);
+    IncrementalParser parser(withResource(budget, Engine::Iterative));
+    EXPECT_THROW(parser.feed(documents[0]), budget_exceeded);
+}
+
+TEST(json_memory, test_budget_shared_by_threads)
+{
+    // a charge that can never fit must not make one that fits fail
+    BudgetResource budget(100);
+    std::atomic<bool> done{false};
+    std::thread greedy([&budget, &done] {
+        while (!done) {
+            EXPECT_THROW(budget.charge(1000), budget_exceeded);
+            EXPECT_THROW(budget.charge(std::size_t(-1)), budget_exceeded);
+        }
+    });
+    for (int i = 0; i < 100000; ++i) {
+        budget.charge(100);
+        budget.release(100);
+    }
+    done = true;
+    greedy.join();
+    EXPECT_EQ(0u, budget.used());
+    EXPECT_EQ(100u, budget.peak());
+}
+
+TEST(json_memory, test_budget_upstream)
+{
+    CountingResource upstream;
+    BudgetResource budget(std::size_t(-1), &upstream);
+    {
+        const Value value =
+            load(config, withResource(budget, Engine::Iterative));
+        EXPECT_LT(0u, upstream.blocks);
+        EXPECT_LT(0u, budget.used());
+    }
+    EXPECT_EQ(0u, upstream.blocks);
+    EXPECT_EQ(0u, budget.used());
+}
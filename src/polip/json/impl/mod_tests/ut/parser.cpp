@@ -1,5 +1,6 @@
 
 #include <algorithm>
+#include <cmath>
 #include <gtest/gtest.h>
 #include "polip/json/parser.hpp"
 
@@ -105,6 +106,67 @@ TEST(json_parser, test_relaxed_load_string_embedded_quot)
     EXPECT_EQ("a\"la", load("\"a\\\"la\"").as<std::string>());
 }
 
+TEST(json_parser, test_relaxed_load_extended_double)
+{
+    EXPECT_DOUBLE_EQ(0.5, load(".5").as<double>());
+    EXPECT_DOUBLE_EQ(1., load("1.").as<double>());
+    EXPECT_TRUE(std::isnan(load("nan").as<double>()));
+    EXPECT_TRUE(std::isinf(load("inf").as<double>()));
+}
+
+TEST(json_parser, test_relaxed_load_extended_escape)
+{
+    EXPECT_EQ("a\vb", load(R"("a\vb")").as<std::string>());
+}
+
+TEST(json_parser, test_strict_load_document)
+{
+    EXPECT_EQ(Value{Array{}}, load("[]", Conformance::Strict));
+    EXPECT_EQ(Value{Object{}}, load("{}", Conformance::Strict));
+    const Value expected = Array{int64_t{1}, Null{}, "x"};
+    EXPECT_EQ(expected, load(R"([1, null, "x"])", Conformance::Strict));
+}
+
+TEST(json_parser, test_strict_load_scalar_document)
+{
+    EXPECT_THROW(load("null", Conformance::Strict), str_parse_error);
+    EXPECT_THROW(load("true", Conformance::Strict), str_parse_error);
+    EXPECT_THROW(load("1", Conformance::Strict), str_parse_error);
+    EXPECT_THROW(load("1.5", Conformance::Strict), str_parse_error);
+    EXPECT_THROW(load(R"("ala")", Conformance::Strict), str_parse_error);
+}
+
+TEST(json_parser, test_strict_load_double)
+{
+    const Value v = load("[0.1, -2.13, 1E-2, 1.2E+1]", Conformance::Strict);
+    ASSERT_EQ(4, v.as<Array>().size());
+    EXPECT_DOUBLE_EQ(0.1, v.as<Array>()[0].as<double>());
+    EXPECT_DOUBLE_EQ(-2.13, v.as<Array>()[1].as<double>());
+    EXPECT_DOUBLE_EQ(0.01, v.as<Array>()[2].as<double>());
+    EXPECT_DOUBLE_EQ(12, v.as<Array>()[3].as<double>());
+}
+
+TEST(json_parser, test_strict_load_invalid_double)
+{
+    EXPECT_THROW(load("[.5]", Conformance::Strict), str_parse_error);
+    EXPECT_THROW(load("[1.]", Conformance::Strict), str_parse_error);
+    EXPECT_THROW(load("[nan]", Conformance::Strict), str_parse_error);
+    EXPECT_THROW(load("[inf]", Conformance::Strict), str_parse_error);
+    EXPECT_THROW(load("[01.2]", Conformance::Strict), str_parse_error);
+}
+
+TEST(json_parser, test_strict_load_invalid_escape)
+{
+    EXPECT_EQ("a\tb", load(R"(["a\tb"])", Conformance::Strict)
+                          .as<Array>()[0].as<std::string>());
+    try {
+        load(R"(["a\vb"])", Conformance::Strict);
+        FAIL() << "escaped v accepted in strict mode";
+    } catch (const str_parse_error& e) {
+        EXPECT_EQ(DiagError::InvalidSpecialChar, e.issue);
+    }
+}
+
 TEST(json_parser, test_more)
 {
     const std::string input = R"(
@@ -133,3 +195,319 @@ TEST(json_parser, test_more)
 )";
     //std::cout << load(input) << std::endl;
 }
+
+namespace
+{
+
+ParseOptions options(Engine engine, std::size_t maxDepth = 128,
+                     Conformance level = Conformance::Relaxed)
+{
+    ParseOptions opts;
+    opts.engine = engine;
+    opts.maxDepth = maxDepth;
+    opts.level = level;
+    return opts;
+}
+
+DiagError loadError(const std::string& input, const ParseOptions& opts)
+{
+    try {
+        load(input, opts);
+    } catch (const str_parse_error& e) {
+        return e.issue;
+    }
+    return DiagError::Other;
+}
+
+class EventRecorder : public DispatchTarget
+{
+public:
+    std::string events;
+
+private:
+    void objectBeginImpl(const std::string& name) { events += "{" + name + ":"; }
+    void objectEndImpl() { events += "}"; }
+    void arrayBeginImpl() { events += "["; }
+    void arrayEndImpl() { events += "]"; }
+    void nullValueImpl() { events += "n "; }
+    void boolValueImpl(bool v) { events += v ? "t " : "f "; }
+    void integerValueImpl(int64_t v) { events += std::to_string(v) + " "; }
+    void doubleValueImpl(double v) { events += "d "; }
+    void stringValueImpl(const std::string& v) { events += "'" + v + "' "; }
+};
+
+}  // anonymous namespace
+
+TEST(json_parser, test_load_max_depth)
+{
+    for (Engine engine : {Engine::Recursive, Engine::Iterative}) {
+        EXPECT_NO_THROW(load("[[[]]]", options(engine, 3)));
+        EXPECT_NO_THROW(load(R"({"a": [{}]})", options(engine, 3)));
+        EXPECT_NO_THROW(load("1", options(engine, 0)));
+        EXPECT_EQ(DiagError::MaxDepthExceeded, loadError("[[[]]]", options(engine, 2)));
+        EXPECT_EQ(DiagError::MaxDepthExceeded, loadError(R"({"a": [{}]})", options(engine, 2)));
+        EXPECT_EQ(DiagError::MaxDepthExceeded, loadError("[]", options(engine, 0)));
+    }
+}
+
+TEST(json_parser, test_load_default_max_depth)
+{
+    const std::string deep = std::string(1000, '[') + std::string(1000, ']');
+    EXPECT_EQ(DiagError::MaxDepthExceeded, loadError(deep, ParseOptions{}));
+    EXPECT_THROW(load(deep), str_parse_error);
+}
+
+TEST(json_parser, test_iterative_load)
+{
+    const char* inputs[] = {
+        "null", "true", "false", "0", "-12", "1.5", "-2e3", ".5", "inf",
+        R"("")", R"("a\"b\\c\/\b\f\n\r\t\v")",
+        "[]", "{}", " [ 1 , [ ] , { } , null ] ",
+        R"({"a": {"b": [true, {"c": "d"}]}, "e": {}, "f": [[], [1.25]]})",
+        "99999999999999999999"};
+    for (const char* input : inputs) {
+        EXPECT_EQ(load(input, options(Engine::Recursive)),
+                  load(input, options(Engine::Iterative)))
+            << input;
+    }
+}
+
+TEST(json_parser, test_iterative_load_invalid)
+{
+    const char* inputs[] = {"", "+1", "01", "-01", "1a2", "e1", "Null",
+                            "[", "[1,", "[1,,]", "[1 2]", "{", R"({"a")",
+                            R"({"a":})", R"({"a" 1})", R"({1: 2})",
+                            R"("abc)", R"("a\yb")", "[] []", "truex"};
+    for (const char* input : inputs) {
+        EXPECT_THROW(load(input, options(Engine::Iterative)), str_parse_error)
+            << input;
+    }
+    EXPECT_EQ(DiagError::ExpectedArrayEnd, loadError("[1 2]", options(Engine::Iterative)));
+    EXPECT_EQ(DiagError::ExpectedObjectEnd, loadError(R"({"a": 1 "b": 2})", options(Engine::Iterative)));
+    EXPECT_EQ(DiagError::Colon, loadError(R"({"a" 1})", options(Engine::Iterative)));
+    EXPECT_EQ(DiagError::Value, loadError(R"({"a": x})", options(Engine::Iterative)));
+    EXPECT_EQ(DiagError::ExpectedQuot, loadError(R"("abc)", options(Engine::Iterative)));
+    EXPECT_EQ(DiagError::InvalidSpecialChar, loadError(R"("a\yb")", options(Engine::Iterative)));
+}
+
+TEST(json_parser, test_iterative_load_strict)
+{
+    const ParseOptions strict = options(Engine::Iterative, 128, Conformance::Strict);
+    EXPECT_NO_THROW(load("[1.5]", strict));
+    EXPECT_THROW(load("1", strict), str_parse_error);
+    EXPECT_THROW(load("[.5]", strict), str_parse_error);
+    EXPECT_THROW(load("[nan]", strict), str_parse_error);
+    EXPECT_THROW(load(R"(["\v"])", strict), str_parse_error);
+    EXPECT_THROW(load("[1,]", strict), str_parse_error);
+}
+
+TEST(json_parser, test_unicode_escapes)
+{
+    // U+00E9, U+20AC, U+1F600 as a surrogate pair and a lone surrogate
+    const std::string input =
+        R"(["\u0041\u00e9\u20AC\ud83d\ude00", "\u0000\u001f", "\ud800x"])";
+    const Value expected = Array{"A\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80",
+                                 std::string("\0\x1f", 2), "\xed\xa0\x80x"};
+    // UTF-8 and DEL are not escaped
+    const std::string raw = "[\"za\xc5\xbc\x7f\"]";
+    for (Engine engine : {Engine::Recursive, Engine::Iterative}) {
+        for (Conformance level : {Conformance::Relaxed, Conformance::Strict}) {
+            const ParseOptions opts = options(engine, 128, level);
+            EXPECT_EQ(expected, load(input, opts));
+            EXPECT_EQ(Value(Array{"za\xc5\xbc\x7f"}), load(raw, opts));
+
+            const std::string invalid = R"(["\u12g4"])";
+            try {
+                load(invalid, opts);
+                FAIL() << invalid;
+            } catch (const str_parse_error& e) {
+                EXPECT_EQ(DiagError::InvalidSpecialChar, e.issue);
+                EXPECT_EQ(4, e.where - invalid.begin());
+            }
+            EXPECT_EQ(DiagError::InvalidSpecialChar,
+                      loadError(R"(["\u12"])", opts));
+            EXPECT_EQ(DiagError::ExpectedQuot,
+                      loadError("[\"a\x01\"]", opts));
+        }
+    }
+}
+
+TEST(json_parser, test_relaxed_extensions)
+{
+    const char* documents[][2] = {
+        {"// config\n[1, /* two */ 2 // end\n]", "[1, 2]"},
+        {"/**/ 3 /* * / **/", "3"},
+        {"[1, 2,]", "[1, 2]"},
+        {R"({"a": [[],], "b": {"c": 1,},})", R"({"a": [[]], "b": {"c": 1}})"},
+        {R"(['it\'s', 'say "hi"', {'k': '\t'}])",
+         R"(["it's", "say \"hi\"", {"k": "\t"}])"},
+        {"{\"a\"/**/:/**/1/**/,/**/}", R"({"a": 1})"}};
+    for (Engine engine : {Engine::Recursive, Engine::Iterative}) {
+        for (const auto& document : documents) {
+            EXPECT_EQ(load(document[1], options(engine)),
+                      load(document[0], options(engine)))
+                << document[0];
+            EXPECT_THROW(load(std::string("[") + document[0] + "]",
+                              options(engine, 128, Conformance::Strict)),
+                         str_parse_error)
+                << document[0];
+        }
+
+        // as written by Python
+        const Array numbers =
+            load("[NaN, Infinity, -Infinity]", options(engine)).as<Array>();
+        EXPECT_TRUE(std::isnan(numbers[0].as<double>()));
+        EXPECT_TRUE(std::isinf(numbers[1].as<double>()));
+        EXPECT_GT(0, numbers[2].as<double>());
+
+        const char* invalid[] = {"[,]", "[1,,]", "{,}", "[1] /",
+                                 "/* unclosed", "[1 /* ] */", "['a\"]",
+                                 "{'a' 1}", "[1 // ]"};
+        for (const char* input : invalid) {
+            EXPECT_THROW(load(input, options(engine)), str_parse_error)
+                << input;
+        }
+    }
+}
+
+TEST(json_parser, test_parse_events)
+{
+    EventRecorder recorder;
+    parse(R"({"a": {}, "b": [1, "x", null], "c": {"d": true}})", recorder);
+    EXPECT_EQ("{a:}{b:[1 'x' n ]{c:{d:t }}", recorder.events);
+
+    EventRecorder empty;
+    parse("[{}, []]", empty);
+    EXPECT_EQ("[}[]]", empty.events);
+}
+
+TEST(json_parser, test_parse_deep_nesting)
+{
+    const std::size_t depth = 100000;
+    EventRecorder recorder;
+    ParseOptions opts;
+    opts.maxDepth = depth;
+    parse(std::string(depth, '[') + std::string(depth, ']'), recorder, opts);
+    EXPECT_EQ(2 * depth, recorder.events.size());
+
+    EXPECT_THROW(parse(std::string(depth, '['), recorder, opts), str_parse_error);
+}
+
+namespace
+{
+
+class SkippingRecorder : public EventRecorder
+{
+public:
+    std::string skippedMember;
+    bool skipArrays = false;
+    bool skipObjects = false;
+
+private:
+    bool skipMemberImpl(const std::string& name) override
+    {
+        return name == skippedMember;
+    }
+    bool skipArrayImpl() override { return skipArrays; }
+    bool skipObjectImpl() override { return skipObjects; }
+};
+
+std::string skipEvents(const std::string& input, SkippingRecorder recorder)
+{
+    SkippingRecorder pointerRecorder = recorder;
+    parse(input, recorder);
+    parse(input.data(), input.data() + input.size(), pointerRecorder);
+    EXPECT_EQ(recorder.events, pointerRecorder.events) << input;
+    return recorder.events;
+}
+
+DiagError skipError(const std::string& input, SkippingRecorder recorder)
+{
+    try {
+        parse(input.data(), input.data() + input.size(), recorder);
+    } catch (const parse_error<const char*>& e) {
+        return e.issue;
+    }
+    return DiagError::Other;
+}
+
+}  // anonymous namespace
+
+TEST(json_parser, test_parse_skip_member)
+{
+    SkippingRecorder recorder;
+    recorder.skippedMember = "skip";
+    EXPECT_EQ("{a:1 {b:'x' }",
+              skipEvents(R"({"a": 1, "skip": {"long member": [1, "]]}}",
+                         {"\"}": "quoted \"} and \\"}]}, "b": "x"})",
+                         recorder));
+    EXPECT_EQ("{a:{b:n }}",
+              skipEvents(R"({"skip": 1.5, "a": {"skip": "text", "b": null,
+                         "skip": true}})",
+                         recorder));
+    EXPECT_EQ("[}]", skipEvents(R"([{"skip": [[[[]]]]}])", recorder));
+    EXPECT_EQ("{skipped:[]}",
+              skipEvents(R"({"skipped": []})", recorder));
+}
+
+TEST(json_parser, test_parse_skip_escapes)
+{
+    SkippingRecorder recorder;
+    recorder.skippedMember = "skip";
+    // escapes and brackets at every offset within a block
+    for (std::size_t padding = 0; padding < 40; ++padding) {
+        const std::string input =
+            R"({"skip": [)" + std::string(padding, ' ') +
+            R"("\"]\\", {"\\\\": "\"}\\\""}, "\\"],)"
+            R"( "c": 1})";
+        EXPECT_EQ("{c:1 }", skipEvents(input, recorder)) << input;
+    }
+}
+
+TEST(json_parser, test_parse_skip_containers)
+{
+    SkippingRecorder objects;
+    objects.skipObjects = true;
+    EXPECT_EQ("[1 }'x' ]",
+              skipEvents(R"([1, {"a": [4, "}"], "b": {"c": {}}}, "x"])",
+                         objects));
+
+    SkippingRecorder arrays;
+    arrays.skipArrays = true;
+    EXPECT_EQ("{a:[]{b:{c:2 }}",
+              skipEvents(R"({"a": [1, [2, "[["], {"d": []}], "b": {"c": 2}})",
+                         arrays));
+}
+
+TEST(json_parser, test_parse_skip_relaxed)
+{
+    SkippingRecorder recorder;
+    recorder.skippedMember = "skip";
+    EXPECT_EQ("{a:1 }",
+              skipEvents("{'skip': ['x]', \"'\", // ]\n /* ] */ ['\\']'],"
+                         " {/* } */},], 'a': 1,}",
+                         recorder));
+    // comments at every offset within a block
+    for (std::size_t padding = 0; padding < 40; ++padding) {
+        const std::string input = "{\"skip\": [" +
+                                  std::string(padding, ' ') +
+                                  "/* ]] */ 1 // ]\n], \"c\": 1}";
+        EXPECT_EQ("{c:1 }", skipEvents(input, recorder)) << input;
+    }
+}
+
+TEST(json_parser, test_parse_skip_errors)
+{
+    SkippingRecorder recorder;
+    recorder.skippedMember = "a";
+    EXPECT_EQ(DiagError::ExpectedArrayEnd,
+              skipError(R"({"a": [[1, 2, 3, 4, 5])", recorder));
+    EXPECT_EQ(DiagError::ExpectedObjectEnd,
+              skipError(R"({"a": {"b": {}})", recorder));
+    EXPECT_EQ(DiagError::ExpectedQuot,
+              skipError(R"({"a": ["unterminated string]})", recorder));
+    EXPECT_EQ(DiagError::ExpectedQuot, skipError(R"({"a": "\)", recorder));
+    EXPECT_EQ(DiagError::Value, skipError(R"({"a": x})", recorder));
+    EXPECT_EQ(DiagError::ExpectedObjectEnd,
+              skipError(R"({"a": [] "b": 1})", recorder));
+}
@@ -0,0 +1,169 @@
+#include <string>
+#include <gtest/gtest.h>
+#include "polip/json/hash.hpp"
+#include "polip/json/parser.hpp"
+#include "polip/json/patch.hpp"
+
+using namespace polip::json;
+
+namespace
+{
+
+Value patched(const char* document, const char* patch)
+{
+    Value value = load(document);
+    apply_patch(value, load(patch));
+    return value;
+}
+
+void expectRoundTrip(const Value& from, const Value& to)
+{
+    const Value patch = diff(from, to);
+    Value value = from;
+    apply_patch(value, patch);
+    // member order is not kept
+    EXPECT_TRUE(unorderedEqual(to, value));
+}
+
+}  // anonymous namespace
+
+TEST(json_patch, test_resolve)
+{
+    const Value document = load(R"({"foo": ["bar", "baz"], "": 0, "a/b": 1,
+        "m~n": 8, "k": {"l": [null, {"m": true}]}})");
+    EXPECT_EQ(document, *resolve(document, ""));
+    EXPECT_EQ(Value("baz"), *resolve(document, "/foo/1"));
+    EXPECT_EQ(Value(int64_t{0}), *resolve(document, "/"));
+    EXPECT_EQ(Value(int64_t{1}), *resolve(document, "/a~1b"));
+    EXPECT_EQ(Value(int64_t{8}), *resolve(document, "/m~0n"));
+    EXPECT_EQ(Value(true), *resolve(document, "/k/l/1/m"));
+    EXPECT_EQ(nullptr, resolve(document, "/foo/2"));
+    EXPECT_EQ(nullptr, resolve(document, "/foo/01"));
+    EXPECT_EQ(nullptr, resolve(document, "/foo/-"));
+    EXPECT_EQ(nullptr, resolve(document, "/bar"));
+    EXPECT_THROW(resolve(document, "foo"), invalid_pointer);
+    EXPECT_THROW(resolve(document, "/m~2n"), invalid_pointer);
+}
+
+// examples of RFC 6902, appendix A
+TEST(json_patch, test_apply)
+{
+    EXPECT_TRUE(unorderedEqual(
+        load(R"({"baz": "qux", "foo": "bar"})"),
+        patched(R"({"foo": "bar"})",
+                R"([{"op": "add", "path": "/baz", "value": "qux"}])")));
+    EXPECT_EQ(load(R"({"foo": ["bar", "qux", "baz"]})"),
+              patched(R"({"foo": ["bar", "baz"]})",
+                      R"([{"op": "add", "path": "/foo/1", "value": "qux"}])"));
+    EXPECT_EQ(load(R"({"foo": "bar"})"),
+              patched(R"({"baz": "qux", "foo": "bar"})",
+                      R"([{"op": "remove", "path": "/baz"}])"));
+    EXPECT_EQ(load(R"({"foo": ["bar", "baz"]})"),
+              patched(R"({"foo": ["bar", "qux", "baz"]})",
+                      R"([{"op": "remove", "path": "/foo/1"}])"));
+    EXPECT_EQ(load(R"({"baz": "boo", "foo": "bar"})"),
+              patched(R"({"baz": "qux", "foo": "bar"})",
+                      R"([{"op": "replace", "path": "/baz", "value": "boo"}])"));
+    EXPECT_EQ(load(R"({"foo": {"bar": "baz"}, "qux": {"corge": "grault",
+                        "thud": "fred"}})"),
+              patched(R"({"foo": {"bar": "baz", "waldo": "fred"},
+                          "qux": {"corge": "grault"}})",
+                      R"([{"op": "move", "from": "/foo/waldo",
+                           "path": "/qux/thud"}])"));
+    EXPECT_EQ(load(R"({"foo": ["all", "cows", "eat", "grass"]})"),
+              patched(R"({"foo": ["all", "grass", "cows", "eat"]})",
+                      R"([{"op": "move", "from": "/foo/1",
+                           "path": "/foo/3"}])"));
+    EXPECT_EQ(load(R"({"foo": ["bar", ["abc", "def"]]})"),
+              patched(R"({"foo": ["bar"]})",
+                      R"([{"op": "add", "path": "/foo/-",
+                           "value": ["abc", "def"]}])"));
+    EXPECT_EQ(load(R"({"a": [1], "b": [1]})"),
+              patched(R"({"a": [1]})",
+                      R"([{"op": "copy", "from": "/a", "path": "/b"}])"));
+    EXPECT_EQ(load("[1]"),
+              patched(R"({"a": 1})",
+                      R"([{"op": "replace", "path": "", "value": [1]}])"));
+}
+
+TEST(json_patch, test_apply_errors)
+{
+    EXPECT_NO_THROW(patched(R"({"baz": "qux", "foo": ["a", 2, "c"]})",
+                            R"([{"op": "test", "path": "/baz", "value": "qux"},
+                                {"op": "test", "path": "/foo/1", "value": 2}])"));
+    EXPECT_THROW(patched(R"({"baz": "qux"})",
+                         R"([{"op": "test", "path": "/baz", "value": "bar"}])"),
+                 patch_test_failed);
+    EXPECT_THROW(patched(R"({"foo": "bar"})",
+                         R"([{"op": "add", "path": "/baz/bat", "value": 1}])"),
+                 invalid_patch);
+    EXPECT_THROW(patched(R"({"foo": [1]})",
+                         R"([{"op": "add", "path": "/foo/2", "value": 1}])"),
+                 invalid_patch);
+    EXPECT_THROW(patched(R"({"foo": "bar"})",
+                         R"([{"op": "remove", "path": "/baz"}])"),
+                 invalid_patch);
+    EXPECT_THROW(patched(R"({"a": {"b": 1}})",
+                         R"([{"op": "move", "from": "/a", "path": "/a/c"}])"),
+                 invalid_patch);
+    EXPECT_THROW(patched("{}", R"([{"op": "jump", "path": ""}])"),
+                 invalid_patch);
+    EXPECT_THROW(patched("{}", R"([{"path": ""}])"), invalid_patch);
+    EXPECT_THROW(patched("{}", R"({"op": "remove", "path": ""})"),
+                 invalid_patch);
+    EXPECT_THROW(patched("{}", R"([{"op": "add", "path": "a", "value": 1}])"),
+                 invalid_pointer);
+}
+
+TEST(json_patch, test_diff)
+{
+    EXPECT_EQ(load("[]"), diff(load(R"({"a": [1, 2]})"),
+                               load(R"({"a": [1, 2]})")));
+    EXPECT_EQ(load(R"([{"op": "replace", "path": "", "value": [1]}])"),
+              diff(load("{}"), load("[1]")));
+    EXPECT_EQ(load(R"([{"op": "remove", "path": "/a~1b"},
+                       {"op": "replace", "path": "/c/d", "value": 2},
+                       {"op": "add", "path": "/e", "value": {"f": null}}])"),
+              diff(load(R"({"a/b": 1, "c": {"d": 1}})"),
+                   load(R"({"c": {"d": 2}, "e": {"f": null}})")));
+    EXPECT_EQ(load(R"([{"op": "add", "path": "/1", "value": "x"}])"),
+              diff(load("[1, 2, 3]"), load(R"([1, "x", 2, 3])")));
+    EXPECT_EQ(load(R"([{"op": "remove", "path": "/1"}])"),
+              diff(load("[1, 2, 3]"), load("[1, 3]")));
+    EXPECT_EQ(load(R"([{"op": "replace", "path": "/1/a", "value": 3}])"),
+              diff(load(R"([1, {"a": 2}, 3])"), load(R"([1, {"a": 3}, 3])")));
+}
+
+TEST(json_patch, test_diff_round_trip)
+{
+    const char* documents[] = {
+        "null", "[]", "{}", "[1, 2, 3, 4, 5]", "[5, 4, 3, 2, 1]",
+        "[1, [2, 3], {\"a\": [4]}, 5]", "[0, 1, 2, 6, 3, 7, 4, 5]",
+        "[2, 2, 1, 1]", R"({"a": 1, "b": [1, 2], "c": {"d": [{"e": 1}]}})",
+        R"({"c": {"d": [{"e": 2}, {"f": 1}]}, "b": [2], "x": "y"})"};
+    for (const char* from : documents) {
+        for (const char* to : documents) {
+            expectRoundTrip(load(from), load(to));
+        }
+    }
+}
+
+TEST(json_patch, test_diff_large_arrays)
+{
+    Value from = Array{};
+    for (int64_t i = 0; i < 100000; ++i) {
+        from.as<Array>().push_back(i);
+    }
+    Value to = from;
+    to.as<Array>().push_back(int64_t{-1});
+    to.as<Array>().push_back(int64_t{-2});
+    EXPECT_EQ(2u, diff(from, to).as<Array>().size());
+    expectRoundTrip(from, to);
+
+    // beyond the LCS limit, compared position by position
+    Value shifted = from;
+    shifted.as<Array>().erase(shifted.as<Array>().begin() + 5);
+    shifted.as<Array>().insert(shifted.as<Array>().begin() + 90000,
+                               int64_t{-1});
+    expectRoundTrip(from, shifted);
+}
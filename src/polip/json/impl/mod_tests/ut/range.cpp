@@ -0,0 +1,108 @@
+#include <cstring>
+#include <deque>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "polip/json/parser_templates.hpp"
+
+using namespace polip::json;
+
+namespace
+{
+
+const char* document = R"({"a": [1, 2.5, "x"], "b": {"c": null}})";
+
+// counts events only, enough to tell the inputs were read in full
+class Counter final : public DispatchTarget
+{
+public:
+    std::size_t events = 0;
+
+private:
+    void objectBeginImpl(const std::string&) override { ++events; }
+    void objectEndImpl() override { ++events; }
+    void arrayBeginImpl() override { ++events; }
+    void arrayEndImpl() override { ++events; }
+    void nullValueImpl() override { ++events; }
+    void boolValueImpl(bool) override { ++events; }
+    void integerValueImpl(int64_t) override { ++events; }
+    void doubleValueImpl(double) override { ++events; }
+    void stringValueImpl(const std::string&) override { ++events; }
+};
+
+template <typename Range>
+void checkLoad(const Range& range)
+{
+    const Value expected = load(document);
+    EXPECT_EQ(expected, load(range));
+    ParseOptions options;
+    options.engine = Engine::Iterative;
+    EXPECT_EQ(expected, load(range, options));
+    options.level = Conformance::Strict;
+    EXPECT_EQ(expected, load(range.begin(), range.end(), options));
+
+    Counter counter;
+    parse(range, counter);
+    EXPECT_EQ(11u, counter.events);
+}
+
+}  // anonymous namespace
+
+TEST(json_range, test_char_buffer)
+{
+    std::vector<char> buffer(document, document + std::strlen(document));
+    buffer.push_back('?');
+    const char* begin = buffer.data();
+    const char* end = begin + buffer.size() - 1;
+    EXPECT_EQ(load(document), load(begin, end));
+    char* mutableBegin = buffer.data();
+    EXPECT_EQ(load(document),
+              load(mutableBegin, mutableBegin + buffer.size() - 1));
+    Counter counter;
+    parse(begin, end, counter);
+    EXPECT_EQ(11u, counter.events);
+}
+
+TEST(json_range, test_contiguous_ranges)
+{
+    checkLoad(std::vector<char>(document, document + std::strlen(document)));
+}
+
+TEST(json_range, test_non_contiguous_ranges)
+{
+    checkLoad(std::deque<char>(document, document + std::strlen(document)));
+}
+
+TEST(json_range, test_error_positions)
+{
+    // the same offsets as for std::string input
+    const std::string text = "[1, 2, ?]";
+    const std::deque<char> chunks(text.begin(), text.end());
+    for (auto engine : {Engine::Recursive, Engine::Iterative}) {
+        ParseOptions options;
+        options.engine = engine;
+        std::size_t offset = 0;
+        try {
+            load(text, options);
+            FAIL();
+        } catch (const parse_error<std::string::const_iterator>& e) {
+            offset = e.where - e.begin;
+        }
+
+        try {
+            load(chunks, options);
+            FAIL();
+        } catch (const parse_error<std::deque<char>::const_iterator>& e) {
+            EXPECT_EQ(offset, std::size_t(std::distance(e.begin, e.where)));
+            EXPECT_TRUE(e.end == chunks.end());
+        }
+
+        try {
+            load(text.data(), text.data() + text.size(), options);
+            FAIL();
+        } catch (const parse_error<const char*>& e) {
+            EXPECT_EQ(text.data() + offset, e.where);
+        }
+    }
+}
@@ -0,0 +1,131 @@
+#include <string>
+#include <gtest/gtest.h>
+#include "polip/json/schema.hpp"
+
+using namespace polip::json;
+
+namespace
+{
+
+const char* personSchema = R"({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "title": "person",
+    "type": "object",
+    "required": ["id", "name"],
+    "properties": {
+        "id": {"type": "integer", "minimum": 1},
+        "name": {"type": "string", "minLength": 1, "maxLength": 8},
+        "score": {"type": "number", "exclusiveMaximum": 10},
+        "role": {"enum": ["admin", "user", null, 3]},
+        "tags": {
+            "type": "array", "maxItems": 2, "minItems": 1,
+            "items": {"type": "string"}
+        },
+        "address": {
+            "type": "object",
+            "properties": {"city": {"type": "string"}},
+            "required": ["city"],
+            "additionalProperties": false
+        }
+    }
+})";
+
+std::string violation(const Schema& schema, const std::string& document)
+{
+    try {
+        schema.validate(document);
+    } catch (const schema_violation& e) {
+        return e.keyword + " " + e.path;
+    }
+    return "valid";
+}
+
+}  // anonymous namespace
+
+TEST(json_schema, test_valid)
+{
+    const Schema schema(load(personSchema));
+    EXPECT_EQ("valid", violation(schema, R"({"id": 1, "name": "Ala"})"));
+    EXPECT_EQ("valid",
+              violation(schema, R"({"name": "Ala", "id": 2, "score": 9.5,
+                                    "role": "user", "tags": ["a", "b"],
+                                    "address": {"city": "X"},
+                                    "other": [{}, [], {"a": 1}]})"));
+    EXPECT_EQ("valid", violation(schema, R"({"id": 1, "name": "A",
+                                             "role": null})"));
+    EXPECT_EQ("valid", violation(schema, R"({"id": 1, "name": "A",
+                                             "role": 3.0})"));
+    EXPECT_EQ("valid", violation(schema, R"({"id": 1.0, "name": "A"})"));
+}
+
+TEST(json_schema, test_violations)
+{
+    const Schema schema(load(personSchema));
+    EXPECT_EQ("type ", violation(schema, "[]"));
+    EXPECT_EQ("required ", violation(schema, R"({"id": 1})"));
+    EXPECT_EQ("required ", violation(schema, "{}"));
+    EXPECT_EQ("type /id", violation(schema, R"({"id": "1", "name": "A"})"));
+    EXPECT_EQ("type /id", violation(schema, R"({"id": 1.5, "name": "A"})"));
+    EXPECT_EQ("minimum /id", violation(schema, R"({"id": 0, "name": "A"})"));
+    EXPECT_EQ("minLength /name", violation(schema, R"({"name": ""})"));
+    EXPECT_EQ("maxLength /name", violation(schema, R"({"name": "123456789"})"));
+    EXPECT_EQ("exclusiveMaximum /score", violation(schema, R"({"score": 10})"));
+    EXPECT_EQ("enum /role", violation(schema, R"({"role": "root"})"));
+    EXPECT_EQ("enum /role", violation(schema, R"({"role": []})"));
+    EXPECT_EQ("type /tags/1", violation(schema, R"({"tags": ["a", 1]})"));
+    EXPECT_EQ("maxItems /tags", violation(schema, R"({"tags": ["a", "b", "c"]})"));
+    EXPECT_EQ("minItems /tags", violation(schema, R"({"tags": []})"));
+    EXPECT_EQ("additionalProperties /address/zip",
+              violation(schema, R"({"address": {"city": "X", "zip": 1}})"));
+    EXPECT_EQ("required /address", violation(schema, R"({"address": {}})"));
+}
+
+TEST(json_schema, test_fail_fast)
+{
+    // the violation is reported before the syntax error that follows it
+    const Schema schema(load(R"({"items": {"type": "integer"}})"));
+    EXPECT_EQ("type /2", violation(schema, R"([1, 2, "3", ?)"));
+    EXPECT_THROW(schema.validate(R"([1, 2, ?)"), error);
+}
+
+TEST(json_schema, test_pointer_escapes)
+{
+    const Schema schema(load(R"({"additionalProperties": {"type": "null"}})"));
+    EXPECT_EQ("type /a~1b~0c", violation(schema, R"({"a/b~c": 1})"));
+}
+
+TEST(json_schema, test_boolean_schemas)
+{
+    EXPECT_EQ("valid", violation(Schema(true), R"({"a": [1, {}]})"));
+    EXPECT_EQ("false ", violation(Schema(false), "1"));
+    const Schema schema(load(R"({"properties": {"a": false}})"));
+    EXPECT_EQ("valid", violation(schema, R"({"b": 1})"));
+    EXPECT_EQ("false /a", violation(schema, R"({"a": 1})"));
+}
+
+TEST(json_schema, test_required_only)
+{
+    const Schema open(load(R"({"required": ["a"]})"));
+    EXPECT_EQ("valid", violation(open, R"({"a": [1]})"));
+    const Schema closed(load(R"({"required": ["a"],
+                                 "additionalProperties": false})"));
+    EXPECT_EQ("additionalProperties /a", violation(closed, R"({"a": 1})"));
+}
+
+TEST(json_schema, test_load)
+{
+    const Schema schema(load(personSchema));
+    const std::string document = R"({"id": 1, "name": "Ala", "tags": ["x"]})";
+    EXPECT_EQ(load(document), schema.load(document));
+    EXPECT_THROW(schema.load(R"({"id": 1})"), schema_violation);
+}
+
+TEST(json_schema, test_invalid_schema)
+{
+    EXPECT_THROW(Schema(load(R"({"pattern": "a*"})")), invalid_schema);
+    EXPECT_THROW(Schema(load(R"({"type": "text"})")), invalid_schema);
+    EXPECT_THROW(Schema(load(R"({"enum": [[1]]})")), invalid_schema);
+    EXPECT_THROW(Schema(load(R"({"maxLength": -1})")), invalid_schema);
+    EXPECT_THROW(Schema(load(R"({"required": "a"})")), invalid_schema);
+    EXPECT_THROW(Schema(load("1")), invalid_schema);
+}
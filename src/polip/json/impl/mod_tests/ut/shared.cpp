@@ -0,0 +1,130 @@
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "polip/json/parser.hpp"
+#include "polip/json/shared.hpp"
+#include "fixtures.hpp"
+
+using namespace polip::json;
+
+TEST(json_shared, test_round_trip)
+{
+    const Value value = load(config);
+    const SharedValue shared(value);
+    EXPECT_EQ(value, shared.toValue());
+    EXPECT_EQ(value, SharedValue(load(config)).toValue());
+    EXPECT_EQ(Value(), SharedValue().toValue());
+}
+
+TEST(json_shared, test_accessors)
+{
+    const SharedValue shared(load(config));
+    ASSERT_TRUE(shared.isObject());
+    EXPECT_EQ(8u, shared.size());
+    EXPECT_EQ("limits", shared.name(1));
+    EXPECT_EQ("service", shared.at(0).as<std::string>());
+    EXPECT_EQ(1024, shared.find("limits")->find("memory")->at(1).as<int64_t>());
+    EXPECT_TRUE(shared.find("enabled")->as<bool>());
+    EXPECT_EQ(0.5, shared.find("ratio")->as<double>());
+    EXPECT_NO_THROW(shared.find("owner")->as<Null>());
+    EXPECT_EQ(nullptr, shared.find("missing"));
+
+    EXPECT_THROW(shared.as<Null>(), not_null);
+    EXPECT_THROW(shared.as<int64_t>(), not_int);
+    EXPECT_THROW(shared.at(0).size(), not_array);
+    EXPECT_THROW(shared.find("tags")->find("a"), not_object);
+    EXPECT_THROW(shared.at(8), std::out_of_range);
+    EXPECT_THROW(shared.at(0).as<bool>(), not_bool);
+}
+
+TEST(json_shared, test_copy_shares)
+{
+    const SharedValue shared(load(config));
+    const SharedValue copy = shared;
+    EXPECT_TRUE(copy.sameAs(shared));
+    const SharedValue limits = *shared.find("limits");
+    EXPECT_TRUE(limits.sameAs(*copy.find("limits")));
+}
+
+TEST(json_shared, test_updates)
+{
+    const SharedValue shared(load(config));
+    const SharedValue renamed = shared.withMember("name", "other");
+    EXPECT_EQ("service", shared.find("name")->as<std::string>());
+    EXPECT_EQ("other", renamed.find("name")->as<std::string>());
+    EXPECT_EQ(shared.size(), renamed.size());
+    EXPECT_TRUE(renamed.find("limits")->sameAs(*shared.find("limits")));
+
+    const SharedValue added = shared.withMember("extra", Array{int64_t{1}, int64_t{2}});
+    EXPECT_EQ(9u, added.size());
+    EXPECT_EQ("extra", added.name(8));
+
+    const SharedValue removed = shared.withoutMember("tags");
+    EXPECT_EQ(7u, removed.size());
+    EXPECT_EQ(nullptr, removed.find("tags"));
+
+    const SharedValue tags = *shared.find("tags");
+    EXPECT_EQ(load(R"(["a", "c"])"), tags.withItem(1, "c").toValue());
+    EXPECT_EQ(load(R"(["a", "b", 3])"), tags.withAppended(int64_t{3}).toValue());
+    EXPECT_EQ(load(R"(["a", "b"])"), tags.toValue());
+    EXPECT_THROW(tags.withItem(2, int64_t{1}), std::out_of_range);
+    EXPECT_THROW(tags.withMember("a", int64_t{1}), not_object);
+    EXPECT_THROW(shared.withAppended(int64_t{1}), not_array);
+}
+
+TEST(json_shared, test_value_at)
+{
+    const SharedValue shared(load(config));
+    const SharedValue updated = shared.withValueAt("/limits/memory/0", int64_t{256});
+    EXPECT_EQ(256, updated.find("limits")->find("memory")->at(0).as<int64_t>());
+    EXPECT_EQ(512, shared.find("limits")->find("memory")->at(0).as<int64_t>());
+    // only the path to the change is copied
+    EXPECT_FALSE(updated.find("limits")->sameAs(*shared.find("limits")));
+    EXPECT_TRUE(updated.find("tags")->sameAs(*shared.find("tags")));
+    EXPECT_TRUE(updated.find("limits")->find("cpu")->sameAs(
+        *shared.find("limits")->find("cpu")));
+
+    EXPECT_EQ(3u, shared.withValueAt("/tags/-", "c").find("tags")->size());
+    EXPECT_EQ(3u, shared.withValueAt("/tags/2", "c").find("tags")->size());
+    EXPECT_EQ(1, shared.withValueAt("/limits/gpu", int64_t{1})
+                     .find("limits")->find("gpu")->as<int64_t>());
+    EXPECT_EQ(Value(true), shared.withValueAt("", true).toValue());
+
+    EXPECT_THROW(shared.withValueAt("limits", int64_t{1}), invalid_pointer);
+    EXPECT_THROW(shared.withValueAt("/missing/a", int64_t{1}), invalid_pointer);
+    EXPECT_THROW(shared.withValueAt("/tags/3", int64_t{1}), invalid_pointer);
+    EXPECT_THROW(shared.withValueAt("/name/a", int64_t{1}), invalid_pointer);
+}
+
+TEST(json_shared, test_equality)
+{
+    const SharedValue shared(load(config));
+    EXPECT_EQ(shared, SharedValue(load(config)));
+    EXPECT_NE(shared, shared.withMember("name", "other"));
+    EXPECT_EQ(shared, shared.withMember("name", "other")
+                          .withMember("name", "service"));
+    EXPECT_NE(SharedValue(Array{}), SharedValue(Object{}));
+    EXPECT_NE(SharedValue(int64_t{1}), SharedValue(1.0));
+}
+
+TEST(json_shared, test_concurrent_readers)
+{
+    const SharedValue shared(load(config));
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&shared]() {
+            for (int i = 0; i < 10000; ++i) {
+                const SharedValue snapshot = shared;
+                const SharedValue limits = *snapshot.find("limits");
+                const SharedValue updated = limits.withMember("cpu", int64_t{i});
+                ASSERT_EQ(i, updated.find("cpu")->as<int64_t>());
+                ASSERT_EQ(2, limits.find("cpu")->as<int64_t>());
+            }
+        });
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(load(config), shared.toValue());
+}
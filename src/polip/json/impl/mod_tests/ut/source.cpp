@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include "polip/json/source.hpp"
+#include "fixtures.hpp"
+
+using namespace polip::json;
+
+namespace
+{
+
+void expectLocation(std::size_t line, std::size_t column, Location location)
+{
+    EXPECT_EQ(line, location.line);
+    EXPECT_EQ(column, location.column);
+}
+
+}  // anonymous namespace
+
+TEST(json_source, test_locate)
+{
+    const LineIndex index(config);
+    expectLocation(1, 1, index.locate(0));
+    expectLocation(1, 2, index.locate(1));
+    expectLocation(2, 1, index.locate(2));
+    expectLocation(2, 5, index.locate(config.find("\"name\"")));
+    expectLocation(10, 9, index.locate(config.find("443")));
+    expectLocation(13, 1, index.locate(config.rfind('}')));
+    // the end and beyond
+    expectLocation(14, 1, index.locate(config.size()));
+    expectLocation(14, 1, index.locate(config.size() + 10));
+    // back to where the index was already built
+    expectLocation(3, 36, index.locate(config.find('[')));
+}
+
+TEST(json_source, test_locate_long_text)
+{
+    // more lines than scanned at once, in both directions
+    std::string text;
+    for (int i = 0; i < 100000; ++i) {
+        text += std::string(i % 7, 'x') + '\n';
+    }
+    const LineIndex index(text);
+    std::size_t start = 0;
+    for (int i = 0; i < 100000; i += 997) {
+        start = 0;
+        for (int j = 0; j < i; ++j) {
+            start += j % 7 + 1;
+        }
+        expectLocation(i + 1, 1, index.locate(start));
+        expectLocation(i + 1, i % 7 + 1, index.locate(start + i % 7));
+    }
+    expectLocation(1, 1, index.locate(0));
+    expectLocation(100001, 1, index.locate(text.size()));
+}
+
+TEST(json_source, test_locate_error)
+{
+    const std::string input = "[1,\n 2,\n  x]";
+    const LineIndex index(input);
+    ParseOptions options;
+    options.engine = Engine::Iterative;
+    try {
+        load(input.data(), input.data() + input.size(), options);
+        FAIL();
+    } catch (const parse_error<const char*>& e) {
+        expectLocation(3, 3, index.locate(e));
+    }
+    try {
+        load(input, options);
+        FAIL();
+    } catch (const parse_error<std::string::const_iterator>& e) {
+        expectLocation(3, 3, index.locate(e));
+    }
+}
+
+TEST(json_source, test_source_map)
+{
+    Value value;
+    SourceMap sources;
+    load(config, value, sources);
+    EXPECT_EQ(load(config), value);
+
+    const LineIndex index(config);
+    EXPECT_EQ(0, sources.offset(value));
+    expectLocation(2, 13, index.locate(sources.offset(*value.find("name"))));
+    const Value& ports = *value.find("ports");
+    expectLocation(8, 14, index.locate(sources.offset(ports)));
+    expectLocation(9, 9, index.locate(sources.offset(ports.as<Array>()[0])));
+    expectLocation(10, 9, index.locate(sources.offset(ports.as<Array>()[1])));
+    const Value& limits = *value.find("limits");
+    EXPECT_EQ(config.find("{\"cpu\""), sources.offset(limits));
+    EXPECT_EQ(config.find("[512"), sources.offset(*limits.find("memory")));
+
+    const Value copy = value;
+    EXPECT_EQ(SourceMap::npos, sources.offset(copy));
+}
+
+TEST(json_source, test_source_map_depth)
+{
+    Value value;
+    SourceMap sources(1);
+    load(config, value, sources);
+    EXPECT_EQ(0, sources.offset(value));
+    EXPECT_EQ(config.find("[\n"), sources.offset(*value.find("ports")));
+    EXPECT_EQ(SourceMap::npos,
+              sources.offset(value.find("ports")->as<Array>()[0]));
+    EXPECT_EQ(SourceMap::npos,
+              sources.offset(*value.find("limits")->find("cpu")));
+
+    SourceMap top(0);
+    load(R"([{}, [], "a"])", value, top);
+    EXPECT_EQ(0, top.offset(value));
+    EXPECT_EQ(SourceMap::npos, top.offset(value.as<Array>()[0]));
+}
+
+TEST(json_source, test_source_map_empty_containers)
+{
+    const std::string input = R"([{}, [], {"a": {}, "b": []}, 1])";
+    Value value;
+    SourceMap sources;
+    load(input, value, sources);
+    const Array& items = value.as<Array>();
+    EXPECT_EQ(1, sources.offset(items[0]));
+    EXPECT_EQ(5, sources.offset(items[1]));
+    EXPECT_EQ(9, sources.offset(items[2]));
+    EXPECT_EQ(input.find("{}", 10), sources.offset(*items[2].find("a")));
+    EXPECT_EQ(input.find("[]", 10), sources.offset(*items[2].find("b")));
+    EXPECT_EQ(input.size() - 2, sources.offset(items[3]));
+}
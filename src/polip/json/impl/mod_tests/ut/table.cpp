@@ -0,0 +1,123 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include "polip/json/table.hpp"
+
+using namespace polip::json;
+
+namespace
+{
+
+const char* records = R"([
+    {"id": 1, "name": "a", "score": 0.5, "active": true, "note": null},
+    {"name": "b", "id": 2, "score": 1.5, "active": false, "note": null},
+    {"id": 3, "name": "c", "score": 2.5, "active": true, "note": null}
+])";
+
+}  // anonymous namespace
+
+TEST(json_table, test_typed_columns)
+{
+    auto table = Table::load(records);
+    ASSERT_TRUE(table);
+    EXPECT_EQ(3, table->rows());
+    ASSERT_EQ(5, table->columns().size());
+
+    const Column* id = table->column("id");
+    ASSERT_NE(nullptr, id);
+    EXPECT_EQ(Column::Type::Int, id->type());
+    EXPECT_EQ((std::vector<int64_t>{1, 2, 3}), id->integers());
+    EXPECT_THROW(id->doubles(), not_double);
+
+    EXPECT_EQ((std::vector<std::string>{"a", "b", "c"}),
+              table->column("name")->strings());
+    EXPECT_EQ((std::vector<double>{0.5, 1.5, 2.5}),
+              table->column("score")->doubles());
+    EXPECT_EQ((std::vector<char>{1, 0, 1}), table->column("active")->bools());
+    EXPECT_EQ(Column::Type::Null, table->column("note")->type());
+    EXPECT_EQ(nullptr, table->column("missing"));
+}
+
+TEST(json_table, test_rows)
+{
+    auto table = Table::load(records);
+    ASSERT_TRUE(table);
+    // members in the order of the first row
+    EXPECT_EQ(load(R"({"id": 2, "name": "b", "score": 1.5, "active": false,
+                       "note": null})"),
+              table->row(1));
+
+    Value array = load(records);
+    for (auto& row : array.as<Array>()) {
+        Value id = *row.find("id");
+        row.erase("id");
+        Value reordered = Object{};
+        reordered.append("id", id);
+        for (auto it = row.objectBegin(); it != row.objectEnd(); ++it) {
+            reordered.append(it->first, it->second);
+        }
+        row = reordered;
+    }
+    EXPECT_EQ(array, table->toValue());
+
+    EXPECT_THROW(table->row(3), std::out_of_range);
+    EXPECT_EQ(Value(int64_t{3}), table->column("id")->at(2));
+    EXPECT_THROW(table->column("id")->at(3), std::out_of_range);
+    // a column without storage
+    EXPECT_EQ(Value(), table->column("note")->at(2));
+    EXPECT_THROW(table->column("note")->at(3), std::out_of_range);
+}
+
+TEST(json_table, test_mixed_columns)
+{
+    const char* document = R"([
+        {"v": 1, "w": [1, {"x": [2]}], "e": {}},
+        {"v": "one", "w": {"k": []}, "e": {}},
+        {"v": null, "w": [], "e": {}}
+    ])";
+    auto table = Table::load(document);
+    ASSERT_TRUE(table);
+    const Column* v = table->column("v");
+    EXPECT_EQ(Column::Type::Mixed, v->type());
+    EXPECT_EQ((std::vector<Value>{int64_t{1}, "one", Null{}}), v->values());
+    EXPECT_THROW(v->integers(), not_int);
+    EXPECT_EQ(load(document), table->toValue());
+    EXPECT_EQ(load(document), Table::fromValue(load(document))->toValue());
+}
+
+TEST(json_table, test_not_tabular)
+{
+    const char* documents[] = {
+        "null", "1", "{}", R"({"a": [{"b": 1}]})", "[1]", "[[]]",
+        R"([{"a": 1}, 2])", R"([{"a": 1}, {"b": 1}])",
+        R"([{"a": 1}, {"a": 1, "b": 2}])", R"([{"a": 1, "b": 2}, {"a": 1}])",
+        R"([{"a": 1, "a": 2}])", R"([{"a": 1, "b": 2}, {"a": 1, "a": 2}])",
+        R"([{"a": 1}, {}])", R"([{}, {"a": 1}])"};
+    for (const char* document : documents) {
+        EXPECT_FALSE(Table::load(document)) << document;
+        EXPECT_FALSE(Table::fromValue(load(document))) << document;
+    }
+}
+
+TEST(json_table, test_empty)
+{
+    auto empty = Table::load("[]");
+    ASSERT_TRUE(empty);
+    EXPECT_EQ(0, empty->rows());
+    EXPECT_TRUE(empty->columns().empty());
+    EXPECT_EQ(Value{Array{}}, empty->toValue());
+
+    auto members = Table::load("[{}, {}]");
+    ASSERT_TRUE(members);
+    EXPECT_EQ(2, members->rows());
+    EXPECT_EQ(load("[{}, {}]"), members->toValue());
+    // rows without columns
+    EXPECT_EQ(Value{Object{}}, members->row(1));
+    EXPECT_THROW(members->row(2), std::out_of_range);
+    EXPECT_THROW(empty->row(0), std::out_of_range);
+}
+
+TEST(json_table, test_parse_error)
+{
+    EXPECT_THROW(Table::load(R"([{"a": 1}, {"a": ])"),
+                 parse_error<std::string::const_iterator>);
+}
@@ -0,0 +1,266 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <gtest/gtest.h>
+#include "polip/json/tape.hpp"
+
+using namespace polip::json;
+
+namespace
+{
+
+const char* documents[] = {
+    "null", "true", "false", "0", "-12", "1.5", R"("")", R"("ala")", "[]",
+    "{}", "[[], {}, [[]], [{}]]",
+    R"({"a": 1, "b": [2, 3.5], "c": {"d": {}, "e": "f"}, "g": null})",
+    R"([{"id": 1, "tags": ["x", "y"]}, {"id": 2, "tags": []}, true, false])"};
+
+std::string tempPath(const char* name)
+{
+    return testing::TempDir() + name;
+}
+
+// maps a saved tape with one of its words or string bytes replaced
+void mapPatched(const std::string& path, const std::string& saved,
+                std::size_t offset, std::uint64_t word)
+{
+    std::string bytes = saved;
+    std::memcpy(&bytes[offset], &word, sizeof(word));
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << bytes;
+    }
+    Tape::map(path);
+}
+
+}  // anonymous namespace
+
+TEST(json_tape, test_to_value)
+{
+    for (const char* document : documents) {
+        EXPECT_EQ(load(document), Tape::load(document).root().toValue())
+            << document;
+    }
+}
+
+TEST(json_tape, test_scalars)
+{
+    EXPECT_NO_THROW(Tape::load("null").root().as<Null>());
+    EXPECT_TRUE(Tape::load("true").root().as<bool>());
+    EXPECT_FALSE(Tape::load("false").root().as<bool>());
+    EXPECT_EQ(-9223372036854775807 - 1,
+              Tape::load("-9223372036854775808").root().as<int64_t>());
+    EXPECT_DOUBLE_EQ(2.5, Tape::load("2.5").root().as<double>());
+    EXPECT_EQ("a\"b", Tape::load(R"("a\"b")").root().as<std::string>());
+    EXPECT_EQ(TapeValue::Type::String, Tape::load(R"("x")").root().type());
+
+    EXPECT_THROW(Tape::load("1").root().as<double>(), not_double);
+    EXPECT_THROW(Tape::load("1").root().as<std::string>(), not_string);
+    EXPECT_THROW(Tape::load("null").root().as<bool>(), not_bool);
+    EXPECT_THROW(Tape::load("[]").root().objectBegin(), not_object);
+    EXPECT_THROW(Tape::load("{}").root().arrayBegin(), not_array);
+}
+
+TEST(json_tape, test_navigation)
+{
+    const Tape tape = Tape::load(
+        R"({"id": 7, "tags": ["x", [1, 2], {"k": null}, "y"], "empty": {}})");
+    const TapeValue root = tape.root();
+    ASSERT_EQ(TapeValue::Type::Object, root.type());
+    EXPECT_EQ(3, root.size());
+
+    auto id = root.find("id");
+    ASSERT_NE(root.objectEnd(), id);
+    EXPECT_EQ(7, id->second.as<int64_t>());
+    EXPECT_EQ(root.objectEnd(), root.find("missing"));
+
+    const TapeValue tags = root.find("tags")->second;
+    ASSERT_EQ(4, tags.size());
+    std::vector<TapeValue::Type> types;
+    for (auto it = tags.arrayBegin(); it != tags.arrayEnd(); ++it) {
+        types.push_back(it->type());
+    }
+    EXPECT_EQ((std::vector<TapeValue::Type>{
+                  TapeValue::Type::String, TapeValue::Type::Array,
+                  TapeValue::Type::Object, TapeValue::Type::String}),
+              types);
+    auto last = tags.arrayBegin();
+    ++last;
+    ++last;
+    ++last;
+    EXPECT_EQ("y", last->as<boost::string_view>());
+
+    const TapeValue empty = root.find("empty")->second;
+    EXPECT_EQ(0, empty.size());
+    EXPECT_EQ(empty.objectBegin(), empty.objectEnd());
+
+    std::vector<std::string> keys;
+    for (auto it = root.objectBegin(); it != root.objectEnd(); ++it) {
+        keys.push_back(it->first.to_string());
+    }
+    EXPECT_EQ((std::vector<std::string>{"id", "tags", "empty"}), keys);
+}
+
+TEST(json_tape, test_save_and_map)
+{
+    const std::string path = tempPath("polip_tape_test.bin");
+    for (const char* document : documents) {
+        Tape::load(document).save(path);
+        const Tape mapped = Tape::map(path);
+        EXPECT_EQ(load(document), mapped.root().toValue()) << document;
+    }
+    std::remove(path.c_str());
+}
+
+TEST(json_tape, test_map_invalid)
+{
+    const std::string path = tempPath("polip_tape_invalid.bin");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "definitely not a polip tape";
+    }
+    EXPECT_THROW(Tape::map(path), invalid_tape);
+    std::remove(path.c_str());
+    EXPECT_THROW(Tape::map(path), std::system_error);
+}
+
+TEST(json_tape, test_map_corrupted)
+{
+    const std::string path = tempPath("polip_tape_corrupted.bin");
+    // words: { "a" [ l 1 "bc" ] }, strings: "a" at 0, "bc" at 5
+    Tape::load(R"({"a": [1, "bc"]})").save(path);
+    std::string saved;
+    {
+        std::ifstream in(path, std::ios::binary);
+        saved.assign(std::istreambuf_iterator<char>(in),
+                     std::istreambuf_iterator<char>());
+    }
+    const std::size_t words = 40;
+    const std::size_t strings = words + 8 * 8;
+    const auto tag = [](char c) {
+        return static_cast<std::uint64_t>(c) << 56;
+    };
+
+    EXPECT_NO_THROW(mapPatched(path, saved, words + 5 * 8, tag('s') | 5));
+    // string offset past the string area
+    EXPECT_THROW(mapPatched(path, saved, words + 5 * 8, tag('s') | 100),
+                 invalid_tape);
+    // string length past the string area
+    EXPECT_THROW(mapPatched(path, saved, strings + 5, 1000), invalid_tape);
+    // end index past the tape, before the matching end, and an item count
+    // that does not match
+    EXPECT_THROW(mapPatched(path, saved, words + 2 * 8,
+                            tag('[') | (std::uint64_t{2} << 32) | 100),
+                 invalid_tape);
+    EXPECT_THROW(mapPatched(path, saved, words,
+                            tag('{') | (std::uint64_t{1} << 32) | 7),
+                 invalid_tape);
+    EXPECT_THROW(mapPatched(path, saved, words + 2 * 8,
+                            tag('[') | (std::uint64_t{3} << 32) | 7),
+                 invalid_tape);
+    // unknown tag, mismatched end and a value in place of a key
+    EXPECT_THROW(mapPatched(path, saved, words + 6 * 8, tag('x') | 2),
+                 invalid_tape);
+    EXPECT_THROW(mapPatched(path, saved, words + 6 * 8, tag('}') | 2),
+                 invalid_tape);
+    EXPECT_THROW(mapPatched(path, saved, words + 8, tag('n')), invalid_tape);
+    std::remove(path.c_str());
+}
+
+TEST(json_tape, test_interned_keys)
+{
+    const KeyTable none;
+    const KeyTable table({"id", "tags", "id"});
+    for (const char* document : documents) {
+        EXPECT_EQ(load(document),
+                  Tape::load(document, ParseOptions{}, none).root().toValue())
+            << document;
+        EXPECT_EQ(load(document),
+                  Tape::load(document, ParseOptions{}, table).root().toValue())
+            << document;
+    }
+
+    std::string records = "[";
+    for (int i = 0; i < 100; ++i) {
+        records += (i ? "," : "");
+        records += R"({"id": 1, "name": "n", "tags": []})";
+    }
+    records += "]";
+    const Tape plain = Tape::load(records);
+    const Tape interned = Tape::load(records, ParseOptions{}, none);
+    EXPECT_EQ(plain.root().toValue(), interned.root().toValue());
+    EXPECT_EQ(plain.size(), interned.size());
+    // length prefixed entries: the keys of every record and its "n"
+    EXPECT_EQ(100 * (6 + 8 + 8 + 5), plain.stringBytes());
+    EXPECT_EQ(6 + 8 + 8 + 100 * 5, interned.stringBytes());
+    const Tape shared = Tape::load(records, ParseOptions{}, table);
+    EXPECT_EQ(plain.root().toValue(), shared.root().toValue());
+}
+
+TEST(json_tape, test_find_interned_key)
+{
+    const KeyTable table({"id", "tags"});
+    const TapeKey id = table.find("id");
+    const TapeKey tags = table.find("tags");
+    ASSERT_TRUE(id.valid());
+    EXPECT_FALSE(table.find("name").valid());
+
+    const std::string first = R"({"name": "a", "tags": [1], "id": 7})";
+    const std::string second = R"({"id": 8, "other": {"id": 0}})";
+    const Tape firstTape = Tape::load(first, ParseOptions{}, table);
+    const Tape secondTape = Tape::load(second, ParseOptions{}, table);
+    const TapeValue a = firstTape.root();
+    const TapeValue b = secondTape.root();
+    EXPECT_EQ(7, a.find(id)->second.as<int64_t>());
+    EXPECT_EQ(1u, a.find(tags)->second.size());
+    EXPECT_EQ(8, b.find(id)->second.as<int64_t>());
+    EXPECT_EQ(b.objectEnd(), b.find(tags));
+    EXPECT_EQ(0, b.find("other")->second.find(id)->second.as<int64_t>());
+    EXPECT_THROW(b.find(id)->second.find(id), not_object);
+}
+
+TEST(json_tape, test_find_foreign_key)
+{
+    const KeyTable table({"id", "tags"});
+    // the same offsets, other keys
+    const KeyTable other({"xy", "name"});
+    const TapeKey id = table.find("id");
+    EXPECT_NE(table.find("id").table, other.find("xy").table);
+    EXPECT_EQ(id.table, KeyTable({"id", "tags"}).find("id").table);
+
+    const std::string document = R"({"xy": 1, "name": "a", "id": 7})";
+    const Tape plain = Tape::load(document);
+    const Tape interned = Tape::load(document, ParseOptions{}, KeyTable{});
+    const Tape foreign = Tape::load(document, ParseOptions{}, other);
+    EXPECT_EQ(0u, plain.keyTable());
+    EXPECT_EQ(0u, interned.keyTable());
+    EXPECT_EQ(other.find("xy").table, foreign.keyTable());
+    for (const Tape* tape : {&plain, &interned, &foreign}) {
+        const TapeValue root = tape->root();
+        EXPECT_EQ(7, root.find(id)->second.as<int64_t>());
+        EXPECT_EQ(root.objectEnd(), root.find(table.find("tags")));
+        EXPECT_EQ(root.objectEnd(), root.find(TapeKey{}));
+    }
+    EXPECT_THROW(plain.root().find("id")->second.find(id), not_object);
+
+    // saved files keep the table
+    const std::string path = tempPath("polip_tape_keys.bin");
+    Tape::load(document, ParseOptions{}, table).save(path);
+    const Tape mapped = Tape::map(path);
+    EXPECT_EQ(id.table, mapped.keyTable());
+    EXPECT_EQ(7, mapped.root().find(id)->second.as<int64_t>());
+    std::string saved;
+    {
+        std::ifstream in(path, std::ios::binary);
+        saved.assign(std::istreambuf_iterator<char>(in),
+                     std::istreambuf_iterator<char>());
+    }
+    // a fingerprint or prefix that does not match the strings
+    EXPECT_THROW(mapPatched(path, saved, 24, id.table + 1), invalid_tape);
+    EXPECT_THROW(mapPatched(path, saved, 32, 6), invalid_tape);
+    EXPECT_THROW(mapPatched(path, saved, 32, 1000), invalid_tape);
+    EXPECT_NO_THROW(mapPatched(path, saved, 24, id.table));
+    std::remove(path.c_str());
+}
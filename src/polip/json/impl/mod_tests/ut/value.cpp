@@ -1,3 +1,4 @@
+#include <limits>
 #include <gtest/gtest.h>
 #include "polip/json/value.hpp"
 #include "polip/json/error.hpp"
@@ -174,3 +175,72 @@ TEST(json_value, test_value_equal)
     EXPECT_TRUE(v8 == v9);
     EXPECT_TRUE(v9 != v10);
 }
+
+TEST(json_value, test_value_nan_not_equal_to_itself)
+{
+    const Value nan{ std::numeric_limits<double>::quiet_NaN() };
+    const Value array{ Array{ int64_t{1}, nan } };
+    const Value object{ Object{{ "x", nan }} };
+
+    EXPECT_FALSE(nan == nan);
+    EXPECT_TRUE(nan != nan);
+    EXPECT_FALSE(array == array);
+    EXPECT_TRUE(array != array);
+    EXPECT_FALSE(object == object);
+}
+
+TEST(json_value, test_value_moves_containers)
+{
+    Array array(1000, Value{int64_t{1}});
+    const Value* items = array.data();
+    Value value{std::move(array)};
+    EXPECT_EQ(items, value.as<Array>().data());
+
+    Object object{{"a", Value{}}};
+    const NameValue* members = object.data();
+    value = std::move(object);
+    EXPECT_EQ(members, value.as<Object>().data());
+
+    std::string text(100, 'x');
+    const char* chars = text.data();
+    Value string{std::move(text)};
+    EXPECT_EQ(chars, string.as<std::string>().data());
+
+    Value copy = string;
+    EXPECT_EQ(string, copy);
+    EXPECT_NE(chars, copy.as<std::string>().data());
+}
+
+TEST(json_value, test_value_array_mutation)
+{
+    Value value = Array{};
+    value.reserve(3);
+    value.pushBack(int64_t{1});
+    Value& nested = value.pushBack(Array{});
+    nested.pushBack("a");
+    value.pushBack(Null{});
+    EXPECT_EQ(3u, value.size());
+    EXPECT_EQ((Array{int64_t{1}, Array{"a"}, Null{}}), value.as<Array>());
+    EXPECT_THROW(value.set("a", true), not_object);
+    EXPECT_THROW(Value{true}.pushBack(true), not_array);
+    EXPECT_THROW(Value{true}.size(), not_array);
+}
+
+TEST(json_value, test_value_object_mutation)
+{
+    Value value = Object{};
+    value.set("a", int64_t{1});
+    value.set("b", Object{});
+    value.set("a", int64_t{2});
+    value.find("b")->set("c", "d");
+    value.append("b", false);
+    EXPECT_EQ(3u, value.size());
+    EXPECT_EQ(Value{int64_t{2}}, *value.find("a"));
+    EXPECT_EQ(Value{"d"}, *value.find("b")->find("c"));
+    EXPECT_EQ(nullptr, value.find("c"));
+    EXPECT_EQ(2u, value.erase("b"));
+    EXPECT_EQ(0u, value.erase("b"));
+    EXPECT_EQ((Object{{"a", int64_t{2}}}), value.as<Object>());
+    EXPECT_THROW(value.pushBack(true), not_array);
+    EXPECT_THROW(Value{}.find("a"), not_object);
+}
@@ -0,0 +1,234 @@
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include "polip/json/parser.hpp"
+#include "polip/json/writer.hpp"
+
+using namespace polip::json;
+
+namespace
+{
+
+const char* document =
+    R"({"a": [1, -2.5, "x\"y", true, null, [], {}], "b": {"c": {"d": []}}})";
+
+std::string rewrite(const std::string& text, std::size_t indent = 0)
+{
+    std::string out;
+    StringSink sink(out);
+    WriterOptions options;
+    options.indent = indent;
+    Writer writer(sink, options);
+    parse(text, writer);
+    writer.flush();
+    return out;
+}
+
+// records the size of every write
+class RecordingSink final : public Sink
+{
+public:
+    std::vector<std::size_t> writes;
+    std::string text;
+
+    void write(const char* data, std::size_t size) override
+    {
+        writes.push_back(size);
+        text.append(data, size);
+    }
+};
+
+}  // anonymous namespace
+
+TEST(json_writer, test_compact)
+{
+    EXPECT_EQ(R"({"a":[1,-2.5,"x\"y",true,null,[],{}],"b":{"c":{"d":[]}}})",
+              rewrite(document));
+    EXPECT_EQ("{}", rewrite("{}"));
+    EXPECT_EQ("[[],{}]", rewrite("[[], {}]"));
+    EXPECT_EQ("1.0", rewrite("1.0"));
+    EXPECT_EQ(load(document), load(rewrite(document)));
+}
+
+TEST(json_writer, test_escapes_read_back)
+{
+    const Value value = Array{std::string("\0\x01\x1f\x7f\"\\\n", 7),
+                              "z\xc5\xbc"};
+    std::string out;
+    StringSink sink(out);
+    {
+        Writer writer(sink);
+        writer.value(value);
+    }
+    EXPECT_EQ("[\"\\u0000\\u0001\\u001f\x7f\\\"\\\\\\n\",\"z\xc5\xbc\"]", out);
+    for (Engine engine : {Engine::Recursive, Engine::Iterative}) {
+        ParseOptions options;
+        options.engine = engine;
+        EXPECT_EQ(value, load(out, options));
+    }
+}
+
+TEST(json_writer, test_pretty)
+{
+    EXPECT_EQ("{\n"
+              "  \"a\": [\n"
+              "    1,\n"
+              "    [],\n"
+              "    {}\n"
+              "  ],\n"
+              "  \"b\": {\n"
+              "    \"c\": null\n"
+              "  }\n"
+              "}",
+              rewrite(R"({"a": [1, [], {}], "b": {"c": null}})", 2));
+    EXPECT_EQ(load(document), load(rewrite(document, 4)));
+}
+
+TEST(json_writer, test_events)
+{
+    std::string out;
+    StringSink sink(out);
+    {
+        Writer writer(sink);
+        writer.objectBegin("list");
+        writer.arrayBegin();
+        writer.stringValue("tab\there");
+        writer.integerValue(7);
+        writer.arrayEnd();
+        writer.objectBegin("empty");
+        writer.objectEnd();
+        writer.objectEnd();
+        // further top level values go on separate lines
+        writer.value(load(R"({"x": [1.5, {"y": {}}]})"));
+        writer.nullValue();
+    }
+    EXPECT_EQ("{\"list\":[\"tab\\there\",7],\"empty\":{}}\n"
+              "{\"x\":[1.5,{\"y\":{}}]}\n"
+              "null",
+              out);
+}
+
+TEST(json_writer, test_unbalanced_events)
+{
+    std::string out;
+    StringSink sink(out);
+    Writer writer(sink);
+    EXPECT_THROW(writer.arrayEnd(), std::logic_error);
+
+    writer.objectBegin("a");
+    // the member has no value yet
+    EXPECT_THROW(writer.arrayEnd(), std::logic_error);
+    writer.integerValue(1);
+    EXPECT_THROW(writer.arrayEnd(), std::logic_error);
+    writer.objectBegin("b");
+    writer.arrayBegin();
+    writer.arrayEnd();
+    // an empty object as the value of "c", then the end of the object
+    writer.objectBegin("c");
+    writer.objectEnd();
+    writer.objectEnd();
+    EXPECT_THROW(writer.arrayEnd(), std::logic_error);
+
+    // an empty object at the top level
+    writer.objectEnd();
+    writer.flush();
+    EXPECT_EQ("{\"a\":1,\"b\":[],\"c\":{}}\n{}", out);
+}
+
+TEST(json_writer, test_non_finite)
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double inf = std::numeric_limits<double>::infinity();
+    std::string out;
+    StringSink sink(out);
+    {
+        Writer writer(sink);
+        writer.value(Array{nan, inf, -inf, 0.5});
+    }
+    // valid JSON by default
+    EXPECT_EQ("[null,null,null,0.5]", out);
+    EXPECT_EQ(load("[null, null, null, 0.5]", Conformance::Strict),
+              load(out, Conformance::Strict));
+
+    out.clear();
+    WriterOptions options;
+    options.nonFinite = true;
+    {
+        Writer writer(sink, options);
+        writer.value(Array{nan, inf, -inf, 0.5});
+    }
+    EXPECT_EQ("[nan,inf,-inf,0.5]", out);
+    const Value relaxed = load(out);
+    EXPECT_TRUE(std::isnan(relaxed.as<Array>()[0].as<double>()));
+    EXPECT_EQ(-inf, relaxed.as<Array>()[2].as<double>());
+}
+
+TEST(json_writer, test_flush_threshold)
+{
+    RecordingSink sink;
+    WriterOptions options;
+    options.flushThreshold = 16;
+    {
+        Writer writer(sink, options);
+        writer.arrayBegin();
+        for (int64_t i = 0; i < 100; ++i) {
+            writer.integerValue(i);
+            EXPECT_GT(20u, sink.text.empty() ? 0 : sink.writes.back());
+        }
+        writer.arrayEnd();
+        EXPECT_LT(10u, sink.writes.size());
+    }
+    Value expected = Array{};
+    for (int64_t i = 0; i < 100; ++i) {
+        expected.pushBack(i);
+    }
+    EXPECT_EQ(expected, load(sink.text));
+}
+
+TEST(json_writer, test_stream_sink)
+{
+    std::ostringstream os;
+    {
+        StreamSink sink(os);
+        Writer writer(sink);
+        writer.value(load(document));
+    }
+    EXPECT_EQ(load(document), load(os.str()));
+
+    std::ostringstream failed;
+    failed.setstate(std::ios::badbit);
+    StreamSink sink(failed);
+    Writer writer(sink);
+    writer.nullValue();
+    EXPECT_THROW(writer.flush(), write_error);
+}
+
+TEST(json_writer, test_file_sink)
+{
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    {
+        FileSink sink(fds[1]);
+        Writer writer(sink);
+        writer.value(load(document));
+        writer.flush();
+    }
+    close(fds[1]);
+    std::string text;
+    char buffer[256];
+    ssize_t got;
+    while ((got = read(fds[0], buffer, sizeof(buffer))) > 0) {
+        text.append(buffer, static_cast<std::size_t>(got));
+    }
+    close(fds[0]);
+    EXPECT_EQ(load(document), load(text));
+
+    FileSink closed(fds[1]);
+    EXPECT_THROW(closed.write("x", 1), write_error);
+}
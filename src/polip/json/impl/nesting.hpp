@@ -0,0 +1,90 @@
+#ifndef INCLUDE_POLIP_JSON_IMPL_NESTING_HPP
+#define INCLUDE_POLIP_JSON_IMPL_NESTING_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace polip
+{
+namespace json
+{
+
+// Recovers the container structure from DispatchTarget events, where
+// objectBegin() announces a member and an object has no start event.
+class Nesting
+{
+public:
+    // on objectBegin(), true if the member opens a new object
+    bool member()
+    {
+        if (inObject()) {
+            m_levels.back().memberOpen = true;
+            return false;
+        }
+        value();
+        m_levels.push_back(Level{true, true});
+        return true;
+    }
+
+    // on objectEnd(), true if it closes an object opened by member(),
+    // false if it stands for an empty object
+    bool closeObject()
+    {
+        if (inObject()) {
+            m_levels.pop_back();
+            return true;
+        }
+        value();
+        return false;
+    }
+
+    void openArray()
+    {
+        value();
+        m_levels.push_back(Level{false, false});
+    }
+
+    void closeArray()
+    {
+        m_levels.pop_back();
+    }
+
+    // on a scalar, or before a container value
+    void value()
+    {
+        if (!m_levels.empty()) {
+            m_levels.back().memberOpen = false;
+        }
+    }
+
+    std::size_t depth() const
+    {
+        return m_levels.size();
+    }
+
+    bool inArray() const
+    {
+        return !m_levels.empty() && !m_levels.back().object;
+    }
+
+private:
+    struct Level
+    {
+        bool object;
+        bool memberOpen;  // member announced, its value not started yet
+    };
+
+    // inside an object and not waiting for a member value
+    bool inObject() const
+    {
+        return !m_levels.empty() && m_levels.back().object &&
+               !m_levels.back().memberOpen;
+    }
+
+    std::vector<Level> m_levels;
+};
+
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_IMPL_NESTING_HPP
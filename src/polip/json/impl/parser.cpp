@@ -1,34 +1,56 @@
-#include <sstream>
-#include <stdexcept>
 #include "polip/json/parser.hpp"
-#include "polip/json/error.hpp"
-#include "grammar.hpp"
+#include "parser_instances.hpp"
 
 namespace pjson = polip::json;
 
+template pjson::Value pjson::load(details::StringIterator,
+                                  details::StringIterator,
+                                  const ParseOptions&);
+template void pjson::parse(details::StringIterator, details::StringIterator,
+                           DispatchTarget&, const ParseOptions&);
+
 pjson::Value pjson::load(const std::string& jsonDoc, Conformance level)
 {
-    /*
-        TODO:
-            handle conformance level
-            process errors
-     */
-    auto it = jsonDoc.begin();
-    ExtendedGrammar<std::string::const_iterator> parser;
-    pjson::Value value;
-    bool success =
-        qi::phrase_parse(it, jsonDoc.end(), parser, ascii::space, value);
-    if (success && it == jsonDoc.end()) {
-        return value;
-    }
-    //std::cout << "parsing error, still to parse: " +
-    //                 std::string(it, jsonDoc.end()) << std::endl;
+    ParseOptions options;
+    options.level = level;
+    return load(jsonDoc, options);
+}
 
-    //assert(false && "It is expected that the underlying parser throws on error");
-    throw parse_error<std::string::const_iterator>{ DiagError::Other, jsonDoc.end(), jsonDoc.end(), jsonDoc.end(),"" };
+pjson::Value pjson::load(const std::string& jsonDoc,
+                         const ParseOptions& options)
+{
+    return load(jsonDoc.begin(), jsonDoc.end(), options);
+}
+
+pjson::Value pjson::load(const char* begin, const char* end,
+                         const ParseOptions& options)
+{
+    return options.level == Conformance::Strict
+               ? details::loadAs<const char*, StrictConformance>(begin, end,
+                                                                 options)
+               : details::loadAs<const char*, RelaxedConformance>(begin, end,
+                                                                  options);
 }
 
 void pjson::parse(const std::string& jsonDoc, DispatchTarget& builder)
 {
-    // TODO
+    parse(jsonDoc, builder, ParseOptions{});
+}
+
+void pjson::parse(const std::string& jsonDoc, DispatchTarget& builder,
+                  const ParseOptions& options)
+{
+    parse(jsonDoc.begin(), jsonDoc.end(), builder, options);
+}
+
+void pjson::parse(const char* begin, const char* end, DispatchTarget& builder,
+                  const ParseOptions& options)
+{
+    if (options.level == Conformance::Strict) {
+        details::parseIterative<const char*, StrictConformance>(
+            begin, end, builder, options);
+    } else {
+        details::parseIterative<const char*, RelaxedConformance>(
+            begin, end, builder, options);
+    }
 }
@@ -0,0 +1,85 @@
+#ifndef INCLUDE_POLIP_JSON_IMPL_PARSER_INSTANCES_HPP
+#define INCLUDE_POLIP_JSON_IMPL_PARSER_INSTANCES_HPP
+
+#include <cstddef>
+#include <string>
+#include "polip/json/parser.hpp"
+
+// Dispatch of the generic load()/parse() to the conformance levels. The
+// parsers themselves are defined in parser_templates.hpp, those for the
+// supported iterators are compiled once in parser_pointer.cpp and
+// parser_string.cpp, so this header does not pull in Spirit.
+
+namespace polip
+{
+namespace json
+{
+
+struct RelaxedConformance;
+struct StrictConformance;
+
+namespace details
+{
+
+using StringIterator = std::string::const_iterator;
+
+template <typename Iterator, typename Policy>
+Value loadAs(Iterator begin, Iterator end, const ParseOptions& options);
+
+template <typename Iterator, typename Policy, typename Target>
+void parseIterative(Iterator begin, Iterator end, Target& target,
+                    const ParseOptions& options);
+
+}  // namespace details
+
+template <typename Iterator, typename>
+Value load(Iterator begin, Iterator end, const ParseOptions& options)
+{
+    return options.level == Conformance::Strict
+               ? details::loadAs<Iterator, StrictConformance>(begin, end,
+                                                              options)
+               : details::loadAs<Iterator, RelaxedConformance>(begin, end,
+                                                               options);
+}
+
+template <typename Iterator, typename>
+void parse(Iterator begin, Iterator end, DispatchTarget& builder,
+           const ParseOptions& options)
+{
+    if (options.level == Conformance::Strict) {
+        details::parseIterative<Iterator, StrictConformance>(
+            begin, end, builder, options);
+    } else {
+        details::parseIterative<Iterator, RelaxedConformance>(
+            begin, end, builder, options);
+    }
+}
+
+// instantiated in parser_pointer.cpp and parser_string.cpp
+extern template Value details::loadAs<const char*, RelaxedConformance>(
+    const char*, const char*, const ParseOptions&);
+extern template void details::parseIterative<const char*, RelaxedConformance>(
+    const char*, const char*, DispatchTarget&, const ParseOptions&);
+extern template Value details::loadAs<const char*, StrictConformance>(
+    const char*, const char*, const ParseOptions&);
+extern template void details::parseIterative<const char*, StrictConformance>(
+    const char*, const char*, DispatchTarget&, const ParseOptions&);
+extern template Value
+details::loadAs<details::StringIterator, RelaxedConformance>(
+    details::StringIterator, details::StringIterator, const ParseOptions&);
+extern template void
+details::parseIterative<details::StringIterator, RelaxedConformance>(
+    details::StringIterator, details::StringIterator, DispatchTarget&,
+    const ParseOptions&);
+extern template Value
+details::loadAs<details::StringIterator, StrictConformance>(
+    details::StringIterator, details::StringIterator, const ParseOptions&);
+extern template void
+details::parseIterative<details::StringIterator, StrictConformance>(
+    details::StringIterator, details::StringIterator, DispatchTarget&,
+    const ParseOptions&);
+
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_IMPL_PARSER_INSTANCES_HPP
@@ -0,0 +1,23 @@
+#include "polip/json/parser_templates.hpp"
+
+// Spirit instantiations for const char* input, kept apart from those of the
+// other supported iterator so the two build in parallel.
+
+namespace pjson = polip::json;
+
+template struct pjson::ExtendedGrammar<const char*, pjson::RelaxedConformance>;
+template struct pjson::ExtendedGrammar<const char*, pjson::StrictConformance>;
+
+template pjson::Value
+pjson::details::loadAs<const char*, pjson::RelaxedConformance>(
+    const char*, const char*, const ParseOptions&);
+template void
+pjson::details::parseIterative<const char*, pjson::RelaxedConformance>(
+    const char*, const char*, DispatchTarget&, const ParseOptions&);
+
+template pjson::Value
+pjson::details::loadAs<const char*, pjson::StrictConformance>(
+    const char*, const char*, const ParseOptions&);
+template void
+pjson::details::parseIterative<const char*, pjson::StrictConformance>(
+    const char*, const char*, DispatchTarget&, const ParseOptions&);
@@ -0,0 +1,27 @@
+#include "polip/json/parser_templates.hpp"
+
+// Spirit instantiations for std::string::const_iterator input, kept apart
+// from those of the other supported iterator so the two build in parallel.
+
+namespace pjson = polip::json;
+
+using pjson::details::StringIterator;
+
+template struct pjson::ExtendedGrammar<StringIterator,
+                                       pjson::RelaxedConformance>;
+template struct pjson::ExtendedGrammar<StringIterator,
+                                       pjson::StrictConformance>;
+
+template pjson::Value
+pjson::details::loadAs<StringIterator, pjson::RelaxedConformance>(
+    StringIterator, StringIterator, const ParseOptions&);
+template void
+pjson::details::parseIterative<StringIterator, pjson::RelaxedConformance>(
+    StringIterator, StringIterator, DispatchTarget&, const ParseOptions&);
+
+template pjson::Value
+pjson::details::loadAs<StringIterator, pjson::StrictConformance>(
+    StringIterator, StringIterator, const ParseOptions&);
+template void
+pjson::details::parseIterative<StringIterator, pjson::StrictConformance>(
+    StringIterator, StringIterator, DispatchTarget&, const ParseOptions&);
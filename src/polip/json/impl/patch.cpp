@@ -0,0 +1,476 @@
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "polip/json/patch.hpp"
+#include "pointer.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+using pjson::pointerIndex;
+using pjson::pointerTokens;
+
+// largest number of LCS table cells (uint32_t) for an array diff
+const std::size_t maxLcsCells = std::size_t{1} << 22;
+
+template <typename T>
+T* get(pjson::Value& value)
+{
+    return boost::get<T>(&value.get());
+}
+
+template <typename T>
+const T* get(const pjson::Value& value)
+{
+    return boost::get<T>(&value.get());
+}
+
+void appendToken(std::string& pointer, const std::string& token)
+{
+    pointer += '/';
+    for (char c : token) {
+        if (c == '~') {
+            pointer += "~0";
+        } else if (c == '/') {
+            pointer += "~1";
+        } else {
+            pointer += c;
+        }
+    }
+}
+
+pjson::Object::iterator findMember(pjson::Object& object,
+                                   const std::string& name)
+{
+    return std::find_if(object.begin(), object.end(),
+                        [&name](const pjson::NameValue& member) {
+                            return member.first == name;
+                        });
+}
+
+// the value a token refers to in a container, nullptr if there is none
+template <typename V>
+V* child(V& container, const std::string& token)
+{
+    using Object = typename std::conditional<std::is_const<V>::value,
+                                             const pjson::Object,
+                                             pjson::Object>::type;
+    using Array = typename std::conditional<std::is_const<V>::value,
+                                            const pjson::Array,
+                                            pjson::Array>::type;
+    if (auto object = boost::get<Object>(&container.get())) {
+        for (auto& member : *object) {
+            if (member.first == token) {
+                return &member.second;
+            }
+        }
+        return nullptr;
+    }
+    if (auto array = boost::get<Array>(&container.get())) {
+        std::size_t index;
+        if (pointerIndex(token, array->size(), index) &&
+            index < array->size()) {
+            return &(*array)[index];
+        }
+    }
+    return nullptr;
+}
+
+class Patcher
+{
+public:
+    explicit Patcher(pjson::Value& document) : m_document(document)
+    {
+    }
+
+    void apply(const pjson::Object& operation);
+
+private:
+    const pjson::Value& field(const pjson::Object& operation,
+                              const char* name) const
+    {
+        for (auto const& member : operation) {
+            if (member.first == name) {
+                return member.second;
+            }
+        }
+        throw pjson::invalid_patch{};
+    }
+
+    const std::string& text(const pjson::Object& operation,
+                            const char* name) const
+    {
+        auto v = get<std::string>(field(operation, name));
+        if (v == nullptr) {
+            throw pjson::invalid_patch{};
+        }
+        return *v;
+    }
+
+    // container holding the last token of the path
+    pjson::Value& parent(const std::vector<std::string>& path)
+    {
+        pjson::Value* value = &m_document;
+        for (std::size_t i = 0; i + 1 < path.size(); ++i) {
+            value = child(*value, path[i]);
+            if (value == nullptr) {
+                throw pjson::invalid_patch{};
+            }
+        }
+        return *value;
+    }
+
+    pjson::Value& target(const std::vector<std::string>& path)
+    {
+        if (path.empty()) {
+            return m_document;
+        }
+        pjson::Value* value = child(parent(path), path.back());
+        if (value == nullptr) {
+            throw pjson::invalid_patch{};
+        }
+        return *value;
+    }
+
+    void add(const std::vector<std::string>& path, pjson::Value&& value);
+    pjson::Value remove(const std::vector<std::string>& path);
+
+    pjson::Value& m_document;
+};
+
+void Patcher::apply(const pjson::Object& operation)
+{
+    const std::string& op = text(operation, "op");
+    const std::vector<std::string> path =
+        pointerTokens(text(operation, "path"));
+    if (op == "add") {
+        add(path, pjson::Value(field(operation, "value")));
+    } else if (op == "remove") {
+        remove(path);
+    } else if (op == "replace") {
+        target(path) = field(operation, "value");
+    } else if (op == "move") {
+        const std::vector<std::string> from =
+            pointerTokens(text(operation, "from"));
+        if (from.size() < path.size() &&
+            std::equal(from.begin(), from.end(), path.begin())) {
+            // into its own child
+            throw pjson::invalid_patch{};
+        }
+        if (from != path) {
+            add(path, remove(from));
+        } else {
+            target(path);
+        }
+    } else if (op == "copy") {
+        const std::vector<std::string> from =
+            pointerTokens(text(operation, "from"));
+        add(path, pjson::Value(target(from)));
+    } else if (op == "test") {
+        if (target(path) != field(operation, "value")) {
+            throw pjson::patch_test_failed{};
+        }
+    } else {
+        throw pjson::invalid_patch{};
+    }
+}
+
+void Patcher::add(const std::vector<std::string>& path, pjson::Value&& value)
+{
+    if (path.empty()) {
+        m_document = std::move(value);
+        return;
+    }
+    pjson::Value& container = parent(path);
+    const std::string& token = path.back();
+    if (auto object = get<pjson::Object>(container)) {
+        auto it = findMember(*object, token);
+        if (it != object->end()) {
+            it->second = std::move(value);
+        } else {
+            object->emplace_back(token, std::move(value));
+        }
+        return;
+    }
+    auto array = get<pjson::Array>(container);
+    std::size_t index;
+    if (array == nullptr || !pointerIndex(token, array->size(), index) ||
+        index > array->size()) {
+        throw pjson::invalid_patch{};
+    }
+    array->insert(array->begin() + index, std::move(value));
+}
+
+pjson::Value Patcher::remove(const std::vector<std::string>& path)
+{
+    if (path.empty()) {
+        throw pjson::invalid_patch{};
+    }
+    pjson::Value& container = parent(path);
+    const std::string& token = path.back();
+    pjson::Value removed;
+    if (auto object = get<pjson::Object>(container)) {
+        auto it = findMember(*object, token);
+        if (it == object->end()) {
+            throw pjson::invalid_patch{};
+        }
+        removed = std::move(it->second);
+        object->erase(it);
+        return removed;
+    }
+    auto array = get<pjson::Array>(container);
+    std::size_t index;
+    if (array == nullptr || !pointerIndex(token, array->size(), index) ||
+        index >= array->size()) {
+        throw pjson::invalid_patch{};
+    }
+    removed = std::move((*array)[index]);
+    array->erase(array->begin() + index);
+    return removed;
+}
+
+class Differ
+{
+public:
+    explicit Differ(pjson::Array& patch) : m_patch(patch)
+    {
+    }
+
+    void diff(const pjson::Value& from, const pjson::Value& to,
+              std::string& path);
+
+private:
+    void emit(const char* op, const std::string& path,
+              const pjson::Value* value = nullptr)
+    {
+        m_patch.emplace_back(pjson::Object{});
+        auto& operation = m_patch.back().as<pjson::Object>();
+        operation.reserve(3);
+        operation.emplace_back("op", op);
+        operation.emplace_back("path", path);
+        if (value != nullptr) {
+            operation.emplace_back("value", *value);
+        }
+    }
+
+    void objects(const pjson::Object& from, const pjson::Object& to,
+                 std::string& path);
+    void arrays(const pjson::Array& from, const pjson::Array& to,
+                std::string& path);
+    void positional(const pjson::Array& from, const pjson::Array& to,
+                    std::size_t begin, std::size_t fromEnd, std::size_t toEnd,
+                    std::string& path);
+    void matched(const pjson::Array& from, const pjson::Array& to,
+                 std::size_t begin, std::size_t fromEnd, std::size_t toEnd,
+                 std::string& path);
+
+    // emits for the item at index of the array at path
+    void item(const char* op, std::string& path, std::size_t index,
+              const pjson::Value* value);
+    void itemDiff(const pjson::Value& from, const pjson::Value& to,
+                  std::string& path, std::size_t index);
+
+    pjson::Array& m_patch;
+};
+
+void Differ::diff(const pjson::Value& from, const pjson::Value& to,
+                  std::string& path)
+{
+    if (from == to) {
+        return;
+    }
+    auto fromObject = get<pjson::Object>(from);
+    auto toObject = get<pjson::Object>(to);
+    if (fromObject && toObject) {
+        objects(*fromObject, *toObject, path);
+        return;
+    }
+    auto fromArray = get<pjson::Array>(from);
+    auto toArray = get<pjson::Array>(to);
+    if (fromArray && toArray) {
+        arrays(*fromArray, *toArray, path);
+        return;
+    }
+    emit("replace", path, &to);
+}
+
+void Differ::objects(const pjson::Object& from, const pjson::Object& to,
+                     std::string& path)
+{
+    std::unordered_map<std::string, const pjson::Value*> remaining;
+    remaining.reserve(to.size());
+    for (auto const& member : to) {
+        remaining.emplace(member.first, &member.second);
+    }
+    const std::size_t size = path.size();
+    for (auto const& member : from) {
+        appendToken(path, member.first);
+        auto it = remaining.find(member.first);
+        if (it == remaining.end()) {
+            emit("remove", path);
+        } else if (it->second != nullptr) {
+            diff(member.second, *it->second, path);
+            it->second = nullptr;  // done
+        }
+        path.resize(size);
+    }
+    for (auto const& member : to) {
+        auto it = remaining.find(member.first);
+        if (it->second != nullptr) {
+            appendToken(path, member.first);
+            emit("add", path, &member.second);
+            path.resize(size);
+            it->second = nullptr;
+        }
+    }
+}
+
+void Differ::arrays(const pjson::Array& from, const pjson::Array& to,
+                    std::string& path)
+{
+    std::size_t begin = 0;
+    while (begin < from.size() && begin < to.size() &&
+           from[begin] == to[begin]) {
+        ++begin;
+    }
+    std::size_t fromEnd = from.size();
+    std::size_t toEnd = to.size();
+    while (fromEnd > begin && toEnd > begin &&
+           from[fromEnd - 1] == to[toEnd - 1]) {
+        --fromEnd;
+        --toEnd;
+    }
+    const std::size_t fromSize = fromEnd - begin;
+    const std::size_t toSize = toEnd - begin;
+    if (fromSize == 0 || toSize == 0 ||
+        (fromSize + 1) * (toSize + 1) > maxLcsCells) {
+        positional(from, to, begin, fromEnd, toEnd, path);
+    } else {
+        matched(from, to, begin, fromEnd, toEnd, path);
+    }
+}
+
+void Differ::positional(const pjson::Array& from, const pjson::Array& to,
+                        std::size_t begin, std::size_t fromEnd,
+                        std::size_t toEnd, std::string& path)
+{
+    std::size_t i = begin;
+    for (; i < fromEnd && i < toEnd; ++i) {
+        itemDiff(from[i], to[i], path, i);
+    }
+    for (std::size_t j = i; j < toEnd; ++j) {
+        item("add", path, j, &to[j]);
+    }
+    // from the back, the indexes of the remaining items stay valid
+    for (std::size_t j = fromEnd; j > i; --j) {
+        item("remove", path, j - 1, nullptr);
+    }
+}
+
+void Differ::matched(const pjson::Array& from, const pjson::Array& to,
+                     std::size_t begin, std::size_t fromEnd, std::size_t toEnd,
+                     std::string& path)
+{
+    const std::size_t rows = fromEnd - begin;
+    const std::size_t columns = toEnd - begin;
+    // lcs[i][j] of the suffixes from[begin + i..] and to[begin + j..]
+    std::vector<std::uint32_t> lcs((rows + 1) * (columns + 1), 0);
+    auto cell = [&lcs, columns](std::size_t i, std::size_t j) -> std::uint32_t& {
+        return lcs[i * (columns + 1) + j];
+    };
+    for (std::size_t i = rows; i-- > 0;) {
+        for (std::size_t j = columns; j-- > 0;) {
+            cell(i, j) = from[begin + i] == to[begin + j]
+                             ? cell(i + 1, j + 1) + 1
+                             : std::max(cell(i + 1, j), cell(i, j + 1));
+        }
+    }
+
+    // walks the edit script, index is the position in the patched array
+    std::size_t i = 0;
+    std::size_t j = 0;
+    std::size_t index = begin;
+    while (i < rows || j < columns) {
+        if (i < rows && j < columns && from[begin + i] == to[begin + j]) {
+            ++i;
+            ++j;
+            ++index;
+        } else if (i < rows && j < columns &&
+                   cell(i + 1, j + 1) == cell(i, j)) {
+            // neither side is part of the subsequence, change in place
+            itemDiff(from[begin + i], to[begin + j], path, index);
+            ++i;
+            ++j;
+            ++index;
+        } else if (j < columns &&
+                   (i == rows || cell(i, j + 1) >= cell(i + 1, j))) {
+            item("add", path, index, &to[begin + j]);
+            ++j;
+            ++index;
+        } else {
+            item("remove", path, index, nullptr);
+            ++i;
+        }
+    }
+}
+
+void Differ::item(const char* op, std::string& path, std::size_t index,
+                  const pjson::Value* value)
+{
+    const std::size_t size = path.size();
+    appendToken(path, std::to_string(index));
+    emit(op, path, value);
+    path.resize(size);
+}
+
+void Differ::itemDiff(const pjson::Value& from, const pjson::Value& to,
+                      std::string& path, std::size_t index)
+{
+    const std::size_t size = path.size();
+    appendToken(path, std::to_string(index));
+    diff(from, to, path);
+    path.resize(size);
+}
+
+}  // anonymous namespace
+
+const pjson::Value* pjson::resolve(const Value& document,
+                                   const std::string& pointer)
+{
+    const Value* value = &document;
+    for (auto const& token : pointerTokens(pointer)) {
+        value = child(*value, token);
+        if (value == nullptr) {
+            return nullptr;
+        }
+    }
+    return value;
+}
+
+pjson::Value pjson::diff(const Value& from, const Value& to)
+{
+    Value patch = Array{};
+    std::string path;
+    Differ(patch.as<Array>()).diff(from, to, path);
+    return patch;
+}
+
+void pjson::apply_patch(Value& document, const Value& patch)
+{
+    auto operations = get<Array>(patch);
+    if (operations == nullptr) {
+        throw invalid_patch{};
+    }
+    Patcher patcher(document);
+    for (auto const& operation : *operations) {
+        auto object = get<Object>(operation);
+        if (object == nullptr) {
+            throw invalid_patch{};
+        }
+        patcher.apply(*object);
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef INCLUDE_POLIP_JSON_IMPL_POINTER_HPP
+#define INCLUDE_POLIP_JSON_IMPL_POINTER_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "polip/json/error.hpp"
+
+namespace polip
+{
+namespace json
+{
+
+// reference tokens of a JSON Pointer (RFC 6901), unescaped
+inline std::vector<std::string> pointerTokens(const std::string& pointer)
+{
+    std::vector<std::string> result;
+    if (pointer.empty()) {
+        return result;
+    }
+    if (pointer[0] != '/') {
+        throw invalid_pointer{};
+    }
+    for (std::size_t i = 0; i < pointer.size(); ++i) {
+        const char c = pointer[i];
+        if (c == '/') {
+            result.emplace_back();
+        } else if (c != '~') {
+            result.back() += c;
+        } else if (i + 1 < pointer.size() && pointer[i + 1] == '0') {
+            result.back() += '~';
+            ++i;
+        } else if (i + 1 < pointer.size() && pointer[i + 1] == '1') {
+            result.back() += '/';
+            ++i;
+        } else {
+            throw invalid_pointer{};
+        }
+    }
+    return result;
+}
+
+// array index without leading zeros, size() if the token is "-"
+inline bool pointerIndex(const std::string& token, std::size_t size,
+                         std::size_t& index)
+{
+    if (token == "-") {
+        index = size;
+        return true;
+    }
+    if (token.empty() || token.size() > 19 ||
+        (token[0] == '0' && token.size() > 1)) {
+        return false;
+    }
+    index = 0;
+    for (char c : token) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        index = index * 10 + static_cast<std::size_t>(c - '0');
+    }
+    return true;
+}
+
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_IMPL_POINTER_HPP
@@ -0,0 +1,377 @@
+#include <string>
+#include "polip/json/reader.hpp"
+#include "conformance.hpp"
+#include "scanner.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+template <pjson::Conformance Level>
+using ScannerOf =
+    pjson::Scanner<const char*, typename pjson::ConformancePolicy<Level>::type>;
+
+}  // anonymous namespace
+
+template <pjson::Conformance Level>
+pjson::BasicReader<Level>::BasicReader(const char* begin, const char* end,
+                                       std::size_t maxDepth,
+                                       const ParseLimits& limits)
+    : m_begin(begin), m_end(end), m_it(begin), m_maxDepth(maxDepth),
+      m_limits(limits)
+{
+    if (static_cast<std::size_t>(end - begin) > limits.maxDocumentBytes) {
+        m_it = begin + limits.maxDocumentBytes;
+        fail(DiagError::DocumentTooLarge);
+    }
+    skipSpace();
+    if (!ConformancePolicy<Level>::type::anyValueDocument &&
+        (m_it == m_end || (*m_it != '[' && *m_it != '{'))) {
+        fail(DiagError::Other);
+    }
+}
+
+template <pjson::Conformance Level>
+typename pjson::BasicReader<Level>::Token pjson::BasicReader<Level>::peek()
+{
+    skipSpace();
+    if (m_it == m_end) {
+        return Token::End;
+    }
+    switch (*m_it) {
+        case '\'':
+            if (!ConformancePolicy<Level>::type::singleQuotes) {
+                return Token::Number;
+            }
+            // fall through
+        case '"':
+            return Token::String;
+        case '[':
+            return Token::Array;
+        case '{':
+            return Token::Object;
+        case 't':
+        case 'f':
+            return Token::Bool;
+        case 'n':
+            if (ScannerOf<Level>(m_begin, m_end, m_it).consume("null")) {
+                return Token::Null;
+            }
+            // relaxed "nan"
+            return Token::Number;
+        default:
+            return Token::Number;
+    }
+}
+
+template <pjson::Conformance Level>
+void pjson::BasicReader<Level>::readNull()
+{
+    skipSpace();
+    countValue();
+    ScannerOf<Level> in(m_begin, m_end, m_it);
+    if (!in.consume("null")) {
+        fail(DiagError::Null);
+    }
+    m_it = in.position();
+}
+
+template <pjson::Conformance Level>
+bool pjson::BasicReader<Level>::readBool()
+{
+    skipSpace();
+    countValue();
+    ScannerOf<Level> in(m_begin, m_end, m_it);
+    bool v = true;
+    if (!in.consume("true")) {
+        if (!in.consume("false")) {
+            fail(DiagError::Value);
+        }
+        v = false;
+    }
+    m_it = in.position();
+    return v;
+}
+
+template <pjson::Conformance Level>
+int64_t pjson::BasicReader<Level>::readInteger()
+{
+    skipSpace();
+    countValue();
+    ScannerOf<Level> in(m_begin, m_end, m_it);
+    int64_t integer = 0;
+    double real = 0;
+    const auto number = in.readNumber(integer, real, numberLimit());
+    if (number != ScannerOf<Level>::Number::Integer) {
+        fail(DiagError::Int);
+    }
+    m_it = in.position();
+    return integer;
+}
+
+template <pjson::Conformance Level>
+uint64_t pjson::BasicReader<Level>::readUnsigned()
+{
+    skipSpace();
+    countValue();
+    ScannerOf<Level> in(m_begin, m_end, m_it);
+    int64_t integer = 0;
+    double real = 0;
+    const auto number = in.readNumber(integer, real, numberLimit());
+    switch (number) {
+        case ScannerOf<Level>::Number::Integer:
+            if (integer < 0) {
+                fail(DiagError::Int);
+            }
+            m_it = in.position();
+            return static_cast<uint64_t>(integer);
+        case ScannerOf<Level>::Number::Real: {
+            // beyond int64_t, only digits are an integer
+            namespace qi = boost::spirit::qi;
+            const char* it = m_it;
+            uint64_t n = 0;
+            if (!qi::parse(it, in.position(), qi::uint_parser<uint64_t>(), n) ||
+                it != in.position()) {
+                fail(DiagError::Int);
+            }
+            m_it = it;
+            return n;
+        }
+        default:
+            fail(DiagError::Int);
+    }
+}
+
+template <pjson::Conformance Level>
+double pjson::BasicReader<Level>::readDouble()
+{
+    skipSpace();
+    countValue();
+    ScannerOf<Level> in(m_begin, m_end, m_it);
+    int64_t integer = 0;
+    double real = 0;
+    const auto number = in.readNumber(integer, real, numberLimit());
+    switch (number) {
+        case ScannerOf<Level>::Number::Integer:
+            real = static_cast<double>(integer);
+            break;
+        case ScannerOf<Level>::Number::Real:
+            break;
+        default:
+            fail(DiagError::Double);
+    }
+    m_it = in.position();
+    return real;
+}
+
+template <pjson::Conformance Level>
+const std::string& pjson::BasicReader<Level>::readString()
+{
+    skipSpace();
+    countValue();
+    ScannerOf<Level> in(m_begin, m_end, m_it);
+    if (!in.atString()) {
+        fail(DiagError::String);
+    }
+    m_text.clear();
+    in.readString(m_text, m_skipping ? noLimit : m_limits.maxStringLength);
+    m_it = in.position();
+    return m_text;
+}
+
+template <pjson::Conformance Level>
+void pjson::BasicReader<Level>::arrayBegin()
+{
+    enter(DiagError::Array, '[');
+}
+
+template <pjson::Conformance Level>
+bool pjson::BasicReader<Level>::arrayNext()
+{
+    return next(']', DiagError::ExpectedArrayEnd);
+}
+
+template <pjson::Conformance Level>
+void pjson::BasicReader<Level>::objectBegin()
+{
+    enter(DiagError::Object, '{');
+}
+
+template <pjson::Conformance Level>
+bool pjson::BasicReader<Level>::objectNext()
+{
+    if (!next('}', DiagError::ExpectedObjectEnd)) {
+        return false;
+    }
+    ScannerOf<Level> in(m_begin, m_end, m_it);
+    if (!in.atString()) {
+        fail(DiagError::ExpectedObjectEnd);
+    }
+    countElement();
+    m_text.clear();
+    in.readString(m_text, m_skipping ? noLimit : m_limits.maxStringLength);
+    m_it = in.position();
+    skipSpace();
+    if (m_it == m_end || *m_it != ':') {
+        fail(DiagError::Colon);
+    }
+    ++m_it;
+    return true;
+}
+
+template <pjson::Conformance Level>
+void pjson::BasicReader<Level>::skipValue()
+{
+    m_skipping = true;
+    // '[' or '{' per container entered here
+    std::string scopes;
+    for (;;) {
+        switch (peek()) {
+            case Token::Array:
+                arrayBegin();
+                scopes += '[';
+                break;
+            case Token::Object:
+                objectBegin();
+                scopes += '{';
+                break;
+            case Token::Null:
+                readNull();
+                break;
+            case Token::Bool:
+                readBool();
+                break;
+            case Token::String:
+                readString();
+                break;
+            default: {
+                ScannerOf<Level> in(m_begin, m_end, m_it);
+                int64_t integer = 0;
+                double real = 0;
+                if (in.readNumber(integer, real) ==
+                    ScannerOf<Level>::Number::None) {
+                    fail(DiagError::Value);
+                }
+                m_it = in.position();
+            }
+        }
+
+        // move to the next value still to be skipped
+        for (;;) {
+            if (scopes.empty()) {
+                m_skipping = false;
+                return;
+            }
+            if (scopes.back() == '[' ? arrayNext() : objectNext()) {
+                break;
+            }
+            scopes.pop_back();
+        }
+    }
+}
+
+template <pjson::Conformance Level>
+void pjson::BasicReader<Level>::finish()
+{
+    skipSpace();
+    if (m_it != m_end) {
+        fail(DiagError::Other);
+    }
+}
+
+template <pjson::Conformance Level>
+void pjson::BasicReader<Level>::fail(DiagError issue) const
+{
+    throw Error{issue, m_begin, m_end, m_it, ""};
+}
+
+template <pjson::Conformance Level>
+void pjson::BasicReader<Level>::skipSpace()
+{
+    ScannerOf<Level> in(m_begin, m_end, m_it);
+    in.skipSpace();
+    m_it = in.position();
+}
+
+template <pjson::Conformance Level>
+void pjson::BasicReader<Level>::enter(DiagError issue, char bracket)
+{
+    skipSpace();
+    if (m_it == m_end || *m_it != bracket) {
+        fail(issue);
+    }
+    countValue();
+    if (m_depth >= m_maxDepth) {
+        fail(DiagError::MaxDepthExceeded);
+    }
+    ++m_depth;
+    ++m_it;
+    m_first = true;
+    m_counts.push_back(m_elements);
+    m_elements = 0;
+}
+
+template <pjson::Conformance Level>
+bool pjson::BasicReader<Level>::next(char close, DiagError issue)
+{
+    skipSpace();
+    if (m_it != m_end && *m_it == close) {
+        ++m_it;
+        leave();
+        return false;
+    }
+    if (!m_first) {
+        if (m_it == m_end || *m_it != ',') {
+            fail(issue);
+        }
+        ++m_it;
+        skipSpace();
+        if (ConformancePolicy<Level>::type::trailingCommas && m_it != m_end &&
+            *m_it == close) {
+            ++m_it;
+            leave();
+            return false;
+        }
+    }
+    m_first = false;
+    // members are counted at their names by objectNext()
+    if (close == ']') {
+        countElement();
+    }
+    return true;
+}
+
+template <pjson::Conformance Level>
+void pjson::BasicReader<Level>::leave()
+{
+    --m_depth;
+    m_first = false;
+    m_elements = m_counts.back();
+    m_counts.pop_back();
+}
+
+template <pjson::Conformance Level>
+void pjson::BasicReader<Level>::countValue()
+{
+    if (!m_skipping && ++m_nodes > m_limits.maxNodes) {
+        fail(DiagError::TooManyNodes);
+    }
+}
+
+template <pjson::Conformance Level>
+void pjson::BasicReader<Level>::countElement()
+{
+    if (!m_skipping && ++m_elements > m_limits.maxContainerElements) {
+        fail(DiagError::TooManyElements);
+    }
+}
+
+template <pjson::Conformance Level>
+std::size_t pjson::BasicReader<Level>::numberLimit() const
+{
+    return m_skipping ? noLimit : m_limits.maxNumberLength;
+}
+
+template class pjson::BasicReader<pjson::Conformance::Relaxed>;
+template class pjson::BasicReader<pjson::Conformance::Strict>;
@@ -0,0 +1,665 @@
+#ifndef INCLUDE_POLIP_JSON_IMPL_SCANNER_HPP
+#define INCLUDE_POLIP_JSON_IMPL_SCANNER_HPP
+
+#include <cstring>
+#include <iterator>
+#include <string>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include <boost/spirit/include/qi_numeric.hpp>
+#include <boost/spirit/include/qi_parse.hpp>
+#include "polip/json/error.hpp"
+#include "conformance.hpp"
+
+namespace polip
+{
+namespace json
+{
+namespace details
+{
+
+// Appends the UTF-16 code unit of a \\u escape as UTF-8. A low surrogate
+// right after a high one completes its pair, lone surrogates are kept as
+// their own three bytes.
+inline void appendCodeUnit(std::string& out, unsigned unit)
+{
+    const std::size_t size = out.size();
+    if (unit >= 0xdc00 && unit <= 0xdfff && size >= 3 &&
+        static_cast<unsigned char>(out[size - 3]) == 0xed &&
+        (static_cast<unsigned char>(out[size - 2]) & 0xf0) == 0xa0) {
+        const unsigned high = 0xd000 | (out[size - 2] & 0x3f) << 6 |
+                              (out[size - 1] & 0x3f);
+        const unsigned code =
+            0x10000 + ((high - 0xd800) << 10) + (unit - 0xdc00);
+        out.resize(size - 3);
+        out += static_cast<char>(0xf0 | code >> 18);
+        out += static_cast<char>(0x80 | (code >> 12 & 0x3f));
+        out += static_cast<char>(0x80 | (code >> 6 & 0x3f));
+        out += static_cast<char>(0x80 | (code & 0x3f));
+    } else if (unit < 0x80) {
+        out += static_cast<char>(unit);
+    } else if (unit < 0x800) {
+        out += static_cast<char>(0xc0 | unit >> 6);
+        out += static_cast<char>(0x80 | (unit & 0x3f));
+    } else {
+        out += static_cast<char>(0xe0 | unit >> 12);
+        out += static_cast<char>(0x80 | (unit >> 6 & 0x3f));
+        out += static_cast<char>(0x80 | (unit & 0x3f));
+    }
+}
+
+// value of a hex digit, -1 for other chars
+inline int hexDigit(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') {
+        return (c | 0x20) - 'a' + 10;
+    }
+    return -1;
+}
+
+// chars a number literal may consist of, letters for nan and inf
+inline bool inNumber(char c)
+{
+    return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') ||
+           c == '.' || c == '+' || c == '-';
+}
+
+// first quote char or backslash, end if there is none
+template <typename Iterator>
+Iterator findQuote(Iterator it, Iterator end, char quote)
+{
+    while (it != end && *it != quote && *it != '\\') {
+        ++it;
+    }
+    return it;
+}
+
+// Follows the nesting of a skipped container: strings are only walked to
+// their closing quote, brackets are counted but not paired. Comments and
+// single quoted strings are followed as the policy allows them. The
+// state is kept between calls, so a container can be skipped piecewise.
+template <typename Policy>
+class BracketCounter
+{
+public:
+    bool inString() const
+    {
+        return m_quote != '\0';
+    }
+
+    // a slash, backslash or comment needs the chars after it, see resume()
+    bool pending() const
+    {
+        return m_escape || m_slash;
+    }
+
+    // brackets open
+    std::size_t depth() const
+    {
+        return m_depth;
+    }
+
+    static bool mayStep(char c)
+    {
+        // clearing bit 5 turns '{' and '}' into '[' and ']'
+        return c == '"' || c == '\\' || (c & '\xdf') == '[' ||
+               (c & '\xdf') == ']' || (Policy::singleQuotes && c == '\'') ||
+               (Policy::comments && c == '/');
+    }
+
+    // on the chars accepted by mayStep(), true when it closes the outermost
+    // container; when pending() the chars after it have to be passed to
+    // resume()
+    template <typename Iterator>
+    bool step(Iterator at)
+    {
+        switch (*at) {
+            case '\'':
+                if (!Policy::singleQuotes) {
+                    break;
+                }
+                // fall through
+            case '"':
+                if (!inString()) {
+                    m_quote = *at;
+                } else if (m_quote == *at) {
+                    m_quote = '\0';
+                }
+                break;
+            case '\\':
+                m_escape = inString();
+                break;
+            case '/':
+                m_slash = Policy::comments && !inString();
+                break;
+            case '[':
+            case '{':
+                m_depth += inString() ? 0 : 1;
+                break;
+            case ']':
+            case '}':
+                return !inString() && --m_depth == 0;
+        }
+        return false;
+    }
+
+    // passes over the char after a backslash or the comment after a
+    // slash, returns where counting goes on
+    template <typename Iterator>
+    Iterator resume(Iterator it, Iterator end)
+    {
+        if (m_escape && it != end) {
+            m_escape = false;
+            ++it;
+        }
+        if (!Policy::comments) {
+            return it;
+        }
+        if (m_slash && it != end) {
+            m_slash = false;
+            if (*it == '/' || *it == '*') {
+                m_comment = *it;
+                ++it;
+            }
+        }
+        if (m_comment == '/') {
+            while (it != end && *it != '\n') {
+                ++it;
+            }
+            if (it != end) {
+                m_comment = '\0';
+            }
+        } else if (m_comment == '*') {
+            for (; it != end; ++it) {
+                if (m_star && *it == '/') {
+                    m_comment = '\0';
+                    m_star = false;
+                    return ++it;
+                }
+                m_star = *it == '*';
+            }
+        }
+        return it;
+    }
+
+private:
+    std::size_t m_depth = 0;
+    char m_quote = '\0';    // of the string the counter is in
+    bool m_escape = false;  // the next char is escaped
+    bool m_slash = false;   // a comment may start with the next char
+    char m_comment = '\0';  // '/' or '*' in a comment of that kind
+    bool m_star = false;    // the last char of a block comment was '*'
+};
+
+// past the bracket closing the container at it, end if it is not closed
+template <typename Iterator, typename Policy>
+Iterator skipContainer(Iterator it, Iterator end,
+                       BracketCounter<Policy>& counter)
+{
+    it = counter.resume(it, end);
+    while (it != end) {
+        if (!BracketCounter<Policy>::mayStep(*it)) {
+            ++it;
+        } else if (counter.step(it)) {
+            return ++it;
+        } else {
+            it = counter.resume(++it, end);
+        }
+    }
+    return it;
+}
+
+#if defined(__SSE2__)
+
+/*
+    Contiguous input is searched 16 bytes at a time, the chars of interest
+    are found through a bit mask of the block.
+ */
+
+inline unsigned matches(__m128i block, char c)
+{
+    return static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(c))));
+}
+
+inline __m128i loadBlock(const char* it)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+}
+
+inline const char* findQuote(const char* it, const char* end, char quote)
+{
+    for (; end - it >= 16; it += 16) {
+        const __m128i block = loadBlock(it);
+        const unsigned mask = matches(block, quote) | matches(block, '\\');
+        if (mask != 0) {
+            return it + __builtin_ctz(mask);
+        }
+    }
+    return findQuote<const char*>(it, end, quote);
+}
+
+template <typename Policy>
+const char* skipContainer(const char* it, const char* end,
+                          BracketCounter<Policy>& counter)
+{
+    it = counter.resume(it, end);
+    while (end - it >= 16) {
+        const __m128i block = loadBlock(it);
+        const __m128i folded = _mm_and_si128(block, _mm_set1_epi8('\xdf'));
+        unsigned bits = matches(block, '"') | matches(block, '\\') |
+                        matches(folded, '[') | matches(folded, ']');
+        if (Policy::singleQuotes) {
+            bits |= matches(block, '\'');
+        }
+        if (Policy::comments) {
+            bits |= matches(block, '/');
+        }
+        const char* next = it + 16;
+        for (; bits != 0; bits &= bits - 1) {
+            const char* const at = it + __builtin_ctz(bits);
+            if (counter.step(at)) {
+                return at + 1;
+            }
+            if (counter.pending()) {
+                // the block is searched again after the escaped char or
+                // comment
+                next = counter.resume(at + 1, end);
+                break;
+            }
+        }
+        it = next;
+    }
+    return skipContainer<const char*, Policy>(it, end, counter);
+}
+
+#endif
+
+}  // namespace details
+
+// Token level reading shared by the hand written parsers, it accepts the
+// tokens of ExtendedGrammar<Iterator, Policy>.
+template <typename Iterator, typename Policy>
+class Scanner
+{
+public:
+    using Error = parse_error<Iterator>;
+
+    enum class Number
+    {
+        None,
+        Integer,
+        Real
+    };
+
+    Scanner(Iterator begin, Iterator end)
+        : m_begin(begin), m_end(end), m_it(begin)
+    {
+    }
+
+    // resumes reading at it
+    Scanner(Iterator begin, Iterator end, Iterator it)
+        : m_begin(begin), m_end(end), m_it(it)
+    {
+    }
+
+    Iterator position() const
+    {
+        return m_it;
+    }
+
+    void fail(DiagError issue) const
+    {
+        fail(issue, m_it);
+    }
+
+    void fail(DiagError issue, Iterator where) const
+    {
+        throw Error{issue, m_begin, m_end, where, ""};
+    }
+
+    static bool isSpace(char c)
+    {
+        // ascii::space
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    // white space and, if the policy allows them, comments; unless final
+    // the input may go on, so a line comment has to end with a newline
+    void skipSpace(bool final = true)
+    {
+        do {
+            while (m_it != m_end && isSpace(*m_it)) {
+                ++m_it;
+            }
+        } while (Policy::comments && skipComment(final));
+    }
+
+    // at a slash that may start a comment not closed before the end
+    bool atComment() const;
+
+    bool atEnd() const
+    {
+        return m_it == m_end;
+    }
+
+    bool at(char c) const
+    {
+        return m_it != m_end && *m_it == c;
+    }
+
+    // at the opening quote of a string
+    bool atString() const
+    {
+        return at('"') || (Policy::singleQuotes && at('\''));
+    }
+
+    char peek() const
+    {
+        return m_it != m_end ? *m_it : '\0';
+    }
+
+    void advance()
+    {
+        ++m_it;
+    }
+
+    bool consume(const char* literal);
+
+    // at the opening quote, appends the unescaped contents to out, see
+    // details::appendCodeUnit() for \\u escapes; fails with StringTooLong
+    // there when they would be longer than maxLength
+    void readString(std::string& out,
+                    std::size_t maxLength = std::string::npos);
+
+    // the guards and numeric parsers of DecInt64Grammar and DoubleGrammar;
+    // fails with NumberTooLong at the start of a literal longer than
+    // maxLength, having looked at no more than one char beyond it
+    Number readNumber(int64_t& integer, double& real,
+                      std::size_t maxLength = std::string::npos);
+
+    /*
+        Skips a value without converting it. Strings and containers are
+        only checked for a closing quot and balanced brackets: escapes
+        are not validated, brackets are counted but not paired and the
+        contents of containers are not parsed, nor is their depth
+        limited.
+     */
+    void skipValue();
+    // at the opening quote
+    void skipString();
+    // at the opening bracket
+    void skipContainer();
+
+private:
+    // passes over a comment, false if there is none or it is not closed
+    bool skipComment(bool final);
+
+    Iterator m_begin;
+    Iterator m_end;
+    Iterator m_it;
+};
+
+template <typename Iterator, typename Policy>
+bool Scanner<Iterator, Policy>::consume(const char* literal)
+{
+    Iterator it = m_it;
+    for (; *literal != '\0'; ++literal, ++it) {
+        if (it == m_end || *it != *literal) {
+            return false;
+        }
+    }
+    m_it = it;
+    return true;
+}
+
+template <typename Iterator, typename Policy>
+void Scanner<Iterator, Policy>::readString(std::string& out,
+                                           std::size_t maxLength)
+{
+    const Iterator start = m_it;
+    // the limit on out, whatever it held before
+    const std::size_t limit = maxLength == std::string::npos
+                                  ? maxLength
+                                  : out.size() + maxLength;
+    const char quote = Policy::singleQuotes ? *m_it : '"';
+    ++m_it;
+    for (;;) {
+        Iterator run = m_it;
+        // unescaped chars as defined by QuotedUnicodeStringGrammar
+        while (m_it != m_end && static_cast<unsigned char>(*m_it) >= 0x20 &&
+               *m_it != quote && *m_it != '\\') {
+            ++m_it;
+        }
+        // checked before the run is copied, so out never outgrows it
+        if (limit != std::string::npos &&
+            static_cast<std::size_t>(std::distance(run, m_it)) >
+                limit - out.size()) {
+            m_it = start;
+            fail(DiagError::StringTooLong);
+        }
+        out.append(run, m_it);
+
+        if (at(quote)) {
+            ++m_it;
+            return;
+        }
+        if (!at('\\')) {
+            fail(DiagError::ExpectedQuot);
+        }
+        ++m_it;
+        if (at('u')) {
+            ++m_it;
+            const Iterator digits = m_it;
+            unsigned unit = 0;
+            for (int i = 0; i < 4; ++i, ++m_it) {
+                const int digit = m_it != m_end ? details::hexDigit(*m_it) : -1;
+                if (digit < 0) {
+                    fail(DiagError::InvalidSpecialChar, digits);
+                }
+                unit = unit << 4 | static_cast<unsigned>(digit);
+            }
+            details::appendCodeUnit(out, unit);
+            if (out.size() > limit) {
+                m_it = start;
+                fail(DiagError::StringTooLong);
+            }
+            continue;
+        }
+        if (m_it == m_end || *m_it == '\0' ||
+            std::strchr(Policy::escapes(), *m_it) == nullptr) {
+            fail(DiagError::InvalidSpecialChar);
+        }
+        switch (*m_it) {
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'v': out += '\v'; break;
+            default: out += *m_it; break;
+        }
+        if (out.size() > limit) {
+            m_it = start;
+            fail(DiagError::StringTooLong);
+        }
+        ++m_it;
+    }
+}
+
+template <typename Iterator, typename Policy>
+bool Scanner<Iterator, Policy>::atComment() const
+{
+    if (!Policy::comments || !at('/')) {
+        return false;
+    }
+    Iterator next = m_it;
+    ++next;
+    return next == m_end || *next == '/' || *next == '*';
+}
+
+template <typename Iterator, typename Policy>
+bool Scanner<Iterator, Policy>::skipComment(bool final)
+{
+    if (!at('/')) {
+        return false;
+    }
+    Iterator it = m_it;
+    if (++it == m_end) {
+        return false;
+    }
+    if (*it == '/') {
+        while (it != m_end && *it != '\n') {
+            ++it;
+        }
+        if (it == m_end && !final) {
+            return false;
+        }
+    } else if (*it == '*') {
+        char last = '\0';
+        for (++it; it != m_end && (last != '*' || *it != '/'); ++it) {
+            last = *it;
+        }
+        if (it == m_end) {
+            return false;
+        }
+        ++it;
+    } else {
+        return false;
+    }
+    m_it = it;
+    return true;
+}
+
+template <typename Iterator, typename Policy>
+void Scanner<Iterator, Policy>::skipValue()
+{
+    switch (peek()) {
+        case '\'':
+            if (!Policy::singleQuotes) {
+                break;
+            }
+            // fall through
+        case '"':
+            skipString();
+            return;
+        case '[':
+        case '{':
+            skipContainer();
+            return;
+    }
+    int64_t integer = 0;
+    double real = 0;
+    if (!consume("true") && !consume("false") && !consume("null") &&
+        readNumber(integer, real) == Number::None) {
+        fail(DiagError::Value);
+    }
+}
+
+template <typename Iterator, typename Policy>
+void Scanner<Iterator, Policy>::skipString()
+{
+    const char quote = Policy::singleQuotes ? *m_it : '"';
+    ++m_it;
+    for (;;) {
+        m_it = details::findQuote(m_it, m_end, quote);
+        if (m_it == m_end) {
+            fail(DiagError::ExpectedQuot);
+        }
+        if (*m_it == quote) {
+            ++m_it;
+            return;
+        }
+        ++m_it;  // backslash, the escaped char is skipped below
+        if (m_it == m_end) {
+            fail(DiagError::ExpectedQuot);
+        }
+        ++m_it;
+    }
+}
+
+template <typename Iterator, typename Policy>
+void Scanner<Iterator, Policy>::skipContainer()
+{
+    const DiagError unclosed = *m_it == '[' ? DiagError::ExpectedArrayEnd
+                                            : DiagError::ExpectedObjectEnd;
+    details::BracketCounter<Policy> counter;
+    m_it = details::skipContainer(m_it, m_end, counter);
+    if (counter.inString()) {
+        fail(DiagError::ExpectedQuot);
+    }
+    if (counter.depth() != 0) {
+        fail(unclosed);
+    }
+}
+
+#pragma GCC diagnostic push
+// false positive on the mantissa of the inlined qi::real_parser at -O2
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+template <typename Iterator, typename Policy>
+typename Scanner<Iterator, Policy>::Number
+Scanner<Iterator, Policy>::readNumber(int64_t& integer, double& real,
+                                      std::size_t maxLength)
+{
+    namespace qi = boost::spirit::qi;
+
+    if (m_it == m_end || *m_it == '+') {
+        return Number::None;
+    }
+    Iterator it = m_it;
+    if (maxLength != std::string::npos &&
+        (*it == '-' || *it == '.' || (*it >= '0' && *it <= '9'))) {
+        // a literal is a prefix of this run, which ends it in valid text,
+        // so the parsers below never go past the limit
+        std::size_t length = 0;
+        for (; it != m_end && details::inNumber(*it); ++it) {
+            if (++length > maxLength) {
+                fail(DiagError::NumberTooLong);
+            }
+        }
+        it = m_it;
+    }
+    if (*it == '-') {
+        ++it;
+    }
+    if (it != m_end && *it == '0') {
+        ++it;
+        if (it != m_end && *it >= '0' && *it <= '9') {
+            return Number::None;
+        }
+    }
+
+    it = m_it;
+    Number number = Number::None;
+    if (qi::parse(it, m_end, qi::int_parser<int64_t>(), integer) &&
+        (it == m_end || (*it != '.' && *it != 'e' && *it != 'E'))) {
+        number = Number::Integer;
+    } else {
+        it = m_it;
+        if (!qi::parse(it, m_end,
+                       qi::real_parser<double, typename Policy::RealPolicies>(),
+                       real)) {
+            return Number::None;
+        }
+        number = Number::Real;
+    }
+    // nan, inf and infinity are not measured above
+    if (maxLength != std::string::npos &&
+        static_cast<std::size_t>(std::distance(m_it, it)) > maxLength) {
+        fail(DiagError::NumberTooLong);
+    }
+    m_it = it;
+    return number;
+}
+
+#pragma GCC diagnostic pop
+
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_IMPL_SCANNER_HPP
@@ -0,0 +1,591 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <boost/optional.hpp>
+#include "polip/json/schema.hpp"
+#include "value_builder.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+enum TypeBit : unsigned
+{
+    NullType = 1,
+    BooleanType = 2,
+    IntegerType = 4,
+    NumberType = 8,
+    StringType = 16,
+    ArrayType = 32,
+    ObjectType = 64,
+    AnyType = 127
+};
+
+const std::size_t unbounded = std::numeric_limits<std::size_t>::max();
+
+// node 0 accepts anything, it is the default for items and members
+const std::size_t anyNode = 0;
+
+struct Property
+{
+    std::string name;
+    std::size_t node;
+    bool required;
+    bool listed;  // in properties, not only in required
+};
+
+struct SchemaNode
+{
+    bool reject = false;  // the false schema
+    unsigned types = AnyType;
+    boost::optional<double> minimum;
+    boost::optional<double> maximum;
+    boost::optional<double> exclusiveMinimum;
+    boost::optional<double> exclusiveMaximum;
+    std::size_t minLength = 0;
+    std::size_t maxLength = unbounded;
+    std::size_t items = anyNode;
+    std::size_t minItems = 0;
+    std::size_t maxItems = unbounded;
+    std::vector<Property> properties;  // sorted by name
+    bool required = false;             // any property is required
+    bool additional = true;
+    std::size_t additionalNode = anyNode;
+    bool hasEnum = false;
+    pjson::Array enumValues;
+};
+
+bool lessName(const Property& property, const std::string& name)
+{
+    return property.name < name;
+}
+
+const Property* findProperty(const SchemaNode& node, const std::string& name)
+{
+    auto it = std::lower_bound(node.properties.begin(), node.properties.end(),
+                               name, lessName);
+    return it != node.properties.end() && it->name == name ? &*it : nullptr;
+}
+
+template <typename T>
+const T* get(const pjson::Value& value)
+{
+    return boost::get<T>(&value.get());
+}
+
+double number(const pjson::Value& value)
+{
+    if (auto v = get<int64_t>(value)) {
+        return static_cast<double>(*v);
+    }
+    if (auto v = get<double>(value)) {
+        return *v;
+    }
+    throw pjson::invalid_schema{};
+}
+
+std::size_t count(const pjson::Value& value)
+{
+    auto v = get<int64_t>(value);
+    if (v == nullptr || *v < 0) {
+        throw pjson::invalid_schema{};
+    }
+    return static_cast<std::size_t>(*v);
+}
+
+unsigned typeBit(const pjson::Value& value)
+{
+    static const char* const names[] = {"null",   "boolean", "integer",
+                                        "number", "string",  "array",
+                                        "object"};
+    auto name = get<std::string>(value);
+    if (name != nullptr) {
+        for (unsigned i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+            if (*name == names[i]) {
+                return 1u << i;
+            }
+        }
+    }
+    throw pjson::invalid_schema{};
+}
+
+bool isAnnotation(const std::string& keyword)
+{
+    static const char* const annotations[] = {
+        "$schema", "$id", "title", "description", "default", "examples"};
+    for (const char* annotation : annotations) {
+        if (keyword == annotation) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::size_t compile(std::vector<SchemaNode>& nodes, const pjson::Value& schema);
+
+void compileKeyword(std::vector<SchemaNode>& nodes, SchemaNode& node,
+                    const std::string& keyword, const pjson::Value& value)
+{
+    if (keyword == "type") {
+        if (auto types = get<pjson::Array>(value)) {
+            node.types = 0;
+            for (auto const& type : *types) {
+                node.types |= typeBit(type);
+            }
+        } else {
+            node.types = typeBit(value);
+        }
+        // every integer is a number
+        if (node.types & NumberType) {
+            node.types |= IntegerType;
+        }
+    } else if (keyword == "enum") {
+        auto values = get<pjson::Array>(value);
+        if (values == nullptr) {
+            throw pjson::invalid_schema{};
+        }
+        for (auto const& v : *values) {
+            if (get<pjson::Array>(v) || get<pjson::Object>(v)) {
+                throw pjson::invalid_schema{};
+            }
+        }
+        node.hasEnum = true;
+        node.enumValues = *values;
+    } else if (keyword == "minimum") {
+        node.minimum = number(value);
+    } else if (keyword == "maximum") {
+        node.maximum = number(value);
+    } else if (keyword == "exclusiveMinimum") {
+        node.exclusiveMinimum = number(value);
+    } else if (keyword == "exclusiveMaximum") {
+        node.exclusiveMaximum = number(value);
+    } else if (keyword == "minLength") {
+        node.minLength = count(value);
+    } else if (keyword == "maxLength") {
+        node.maxLength = count(value);
+    } else if (keyword == "minItems") {
+        node.minItems = count(value);
+    } else if (keyword == "maxItems") {
+        node.maxItems = count(value);
+    } else if (keyword == "items") {
+        node.items = compile(nodes, value);
+    } else if (keyword == "properties") {
+        auto properties = get<pjson::Object>(value);
+        if (properties == nullptr) {
+            throw pjson::invalid_schema{};
+        }
+        for (auto const& property : *properties) {
+            if (findProperty(node, property.first) != nullptr) {
+                throw pjson::invalid_schema{};
+            }
+            const std::size_t child = compile(nodes, property.second);
+            auto it = std::lower_bound(node.properties.begin(),
+                                       node.properties.end(), property.first,
+                                       lessName);
+            node.properties.insert(
+                it, Property{property.first, child, false, true});
+        }
+    } else if (keyword == "additionalProperties") {
+        if (auto allowed = get<bool>(value)) {
+            node.additional = *allowed;
+        } else {
+            node.additionalNode = compile(nodes, value);
+        }
+    } else if (!isAnnotation(keyword)) {
+        throw pjson::invalid_schema{};
+    }
+}
+
+// required may precede or follow properties, so it is applied last
+void compileRequired(SchemaNode& node, const pjson::Value& value)
+{
+    auto names = get<pjson::Array>(value);
+    if (names == nullptr) {
+        throw pjson::invalid_schema{};
+    }
+    for (auto const& name : *names) {
+        auto text = get<std::string>(name);
+        if (text == nullptr) {
+            throw pjson::invalid_schema{};
+        }
+        auto it = std::lower_bound(node.properties.begin(),
+                                   node.properties.end(), *text, lessName);
+        if (it == node.properties.end() || it->name != *text) {
+            // still subject to additionalProperties
+            it = node.properties.insert(
+                it, Property{*text, anyNode, false, false});
+        }
+        it->required = true;
+        node.required = true;
+    }
+}
+
+std::size_t compile(std::vector<SchemaNode>& nodes, const pjson::Value& schema)
+{
+    SchemaNode node;
+    if (auto accept = get<bool>(schema)) {
+        node.reject = !*accept;
+    } else if (auto keywords = get<pjson::Object>(schema)) {
+        const pjson::Value* required = nullptr;
+        for (auto const& keyword : *keywords) {
+            if (keyword.first == "required") {
+                required = &keyword.second;
+            } else {
+                compileKeyword(nodes, node, keyword.first, keyword.second);
+            }
+        }
+        if (required != nullptr) {
+            compileRequired(node, *required);
+        }
+    } else {
+        throw pjson::invalid_schema{};
+    }
+    nodes.push_back(std::move(node));
+    return nodes.size() - 1;
+}
+
+bool sameNumber(const pjson::Value& lhs, const pjson::Value& rhs)
+{
+    auto lhsInt = get<int64_t>(lhs);
+    auto rhsInt = get<int64_t>(rhs);
+    auto lhsDouble = get<double>(lhs);
+    auto rhsDouble = get<double>(rhs);
+    if (lhsInt && rhsDouble) {
+        return static_cast<double>(*lhsInt) == *rhsDouble;
+    }
+    if (lhsDouble && rhsInt) {
+        return *lhsDouble == static_cast<double>(*rhsInt);
+    }
+    return false;
+}
+
+struct Frame
+{
+    std::size_t node;
+    bool object;
+    bool memberOpen;     // member announced, its value not started yet
+    std::size_t count;   // items, or members so far
+    std::size_t seen;    // offset of the required flags in State::seen
+    std::size_t memberNode;
+    std::string member;  // name of the last member, for the path
+};
+
+}  // anonymous namespace
+
+struct pjson::Schema::Nodes
+{
+    std::vector<SchemaNode> nodes;
+    std::size_t root;
+};
+
+pjson::Schema::Schema(const Value& schema)
+{
+    auto nodes = std::make_shared<Nodes>();
+    nodes->nodes.emplace_back();  // anyNode
+    nodes->root = compile(nodes->nodes, schema);
+    m_nodes = nodes;
+}
+
+void pjson::Schema::validate(const std::string& jsonDoc,
+                             const ParseOptions& options) const
+{
+    SchemaValidator validator(*this);
+    parse(jsonDoc, validator, options);
+}
+
+pjson::Value pjson::Schema::load(const std::string& jsonDoc,
+                                 const ParseOptions& options) const
+{
+    ValueBuilder builder;
+    SchemaValidator validator(*this, &builder);
+    parse(jsonDoc, validator, options);
+    return std::move(builder.result());
+}
+
+struct pjson::SchemaValidator::State
+{
+    const SchemaNode& node(std::size_t index) const
+    {
+        return (*nodes)[index];
+    }
+
+    // JSON Pointer of the current value, or of its container
+    [[noreturn]] void fail(const char* keyword, bool container = false) const
+    {
+        std::string path;
+        const std::size_t size = frames.size() - (container ? 1 : 0);
+        for (std::size_t i = 0; i < size; ++i) {
+            path += '/';
+            if (!frames[i].object) {
+                path += std::to_string(frames[i].count - 1);
+                continue;
+            }
+            for (char c : frames[i].member) {
+                if (c == '~') {
+                    path += "~0";
+                } else if (c == '/') {
+                    path += "~1";
+                } else {
+                    path += c;
+                }
+            }
+        }
+        throw schema_violation{keyword, path};
+    }
+
+    // schema of the value starting now
+    std::size_t valueNode()
+    {
+        if (frames.empty()) {
+            return root;
+        }
+        Frame& frame = frames.back();
+        if (frame.object) {
+            frame.memberOpen = false;
+            return frame.memberNode;
+        }
+        ++frame.count;
+        const SchemaNode& array = node(frame.node);
+        if (frame.count > array.maxItems) {
+            fail("maxItems", true);
+        }
+        return array.items;
+    }
+
+    const SchemaNode& start(unsigned type, std::size_t& index)
+    {
+        index = valueNode();
+        const SchemaNode& schema = node(index);
+        if (schema.reject) {
+            fail("false");
+        }
+        if ((schema.types & type) == 0) {
+            fail("type");
+        }
+        return schema;
+    }
+
+    void scalar(const SchemaNode& schema, const Value& value) const
+    {
+        for (auto const& allowed : schema.enumValues) {
+            if (allowed == value || sameNumber(allowed, value)) {
+                return;
+            }
+        }
+        fail("enum");
+    }
+
+    const SchemaNode& number(unsigned type, double v)
+    {
+        std::size_t index;
+        const SchemaNode& schema = start(type, index);
+        if (schema.minimum && v < *schema.minimum) {
+            fail("minimum");
+        }
+        if (schema.maximum && v > *schema.maximum) {
+            fail("maximum");
+        }
+        if (schema.exclusiveMinimum && v <= *schema.exclusiveMinimum) {
+            fail("exclusiveMinimum");
+        }
+        if (schema.exclusiveMaximum && v >= *schema.exclusiveMaximum) {
+            fail("exclusiveMaximum");
+        }
+        return schema;
+    }
+
+    void container(unsigned type)
+    {
+        std::size_t index;
+        const SchemaNode& schema = start(type, index);
+        if (schema.hasEnum) {
+            fail("enum");
+        }
+        frames.push_back(Frame{index, type == ObjectType, false, 0,
+                               seen.size(), anyNode, std::string{}});
+        if (type == ObjectType) {
+            seen.resize(seen.size() + schema.properties.size(), 0);
+        }
+    }
+
+    void member(const std::string& name)
+    {
+        Frame& frame = frames.back();
+        const SchemaNode& object = node(frame.node);
+        frame.member = name;
+        frame.memberOpen = true;
+        ++frame.count;
+        auto property = findProperty(object, name);
+        if (property != nullptr) {
+            seen[frame.seen + (property - object.properties.data())] = 1;
+        }
+        if (property != nullptr && property->listed) {
+            frame.memberNode = property->node;
+        } else if (object.additional) {
+            frame.memberNode = object.additionalNode;
+        } else {
+            fail("additionalProperties");
+        }
+    }
+
+    void closeObject()
+    {
+        const Frame& frame = frames.back();
+        const SchemaNode& object = node(frame.node);
+        if (object.required) {
+            for (std::size_t i = 0; i < object.properties.size(); ++i) {
+                if (object.properties[i].required && !seen[frame.seen + i]) {
+                    fail("required", true);
+                }
+            }
+        }
+        seen.resize(frame.seen);
+        frames.pop_back();
+    }
+
+    bool inObject() const
+    {
+        return !frames.empty() && frames.back().object &&
+               !frames.back().memberOpen;
+    }
+
+    std::shared_ptr<const std::vector<SchemaNode>> nodes;
+    std::size_t root;
+    std::vector<Frame> frames;
+    std::vector<char> seen;  // required flags of the open objects
+};
+
+pjson::SchemaValidator::SchemaValidator(const Schema& schema,
+                                        DispatchTarget* next)
+    : m_state(new State), m_next(next)
+{
+    m_state->nodes = std::shared_ptr<const std::vector<SchemaNode>>(
+        schema.m_nodes, &schema.m_nodes->nodes);
+    m_state->root = schema.m_nodes->root;
+}
+
+pjson::SchemaValidator::~SchemaValidator()
+{
+}
+
+void pjson::SchemaValidator::objectBeginImpl(const std::string& name)
+{
+    if (!m_state->inObject()) {
+        m_state->container(ObjectType);
+    }
+    m_state->member(name);
+    if (m_next) {
+        m_next->objectBegin(name);
+    }
+}
+
+void pjson::SchemaValidator::objectEndImpl()
+{
+    if (m_state->inObject()) {
+        m_state->closeObject();
+    } else {
+        // an empty object
+        m_state->container(ObjectType);
+        m_state->closeObject();
+    }
+    if (m_next) {
+        m_next->objectEnd();
+    }
+}
+
+void pjson::SchemaValidator::arrayBeginImpl()
+{
+    m_state->container(ArrayType);
+    if (m_next) {
+        m_next->arrayBegin();
+    }
+}
+
+void pjson::SchemaValidator::arrayEndImpl()
+{
+    const Frame& frame = m_state->frames.back();
+    if (frame.count < m_state->node(frame.node).minItems) {
+        m_state->fail("minItems", true);
+    }
+    m_state->frames.pop_back();
+    if (m_next) {
+        m_next->arrayEnd();
+    }
+}
+
+void pjson::SchemaValidator::nullValueImpl()
+{
+    std::size_t index;
+    const SchemaNode& schema = m_state->start(NullType, index);
+    if (schema.hasEnum) {
+        m_state->scalar(schema, Null{});
+    }
+    if (m_next) {
+        m_next->nullValue();
+    }
+}
+
+void pjson::SchemaValidator::boolValueImpl(bool v)
+{
+    std::size_t index;
+    const SchemaNode& schema = m_state->start(BooleanType, index);
+    if (schema.hasEnum) {
+        m_state->scalar(schema, v);
+    }
+    if (m_next) {
+        m_next->boolValue(v);
+    }
+}
+
+void pjson::SchemaValidator::integerValueImpl(int64_t v)
+{
+    auto const& schema =
+        m_state->number(IntegerType, static_cast<double>(v));
+    if (schema.hasEnum) {
+        m_state->scalar(schema, v);
+    }
+    if (m_next) {
+        m_next->integerValue(v);
+    }
+}
+
+void pjson::SchemaValidator::doubleValueImpl(double v)
+{
+    // 1.0 is an integer as well
+    const bool integral = std::isfinite(v) && std::floor(v) == v;
+    auto const& schema =
+        m_state->number(integral ? IntegerType : NumberType, v);
+    if (schema.hasEnum) {
+        m_state->scalar(schema, v);
+    }
+    if (m_next) {
+        m_next->doubleValue(v);
+    }
+}
+
+void pjson::SchemaValidator::stringValueImpl(const std::string& v)
+{
+    std::size_t index;
+    const SchemaNode& schema = m_state->start(StringType, index);
+    if (schema.minLength > 0 || schema.maxLength != unbounded) {
+        // code points, continuation bytes of UTF-8 are not counted
+        std::size_t length = 0;
+        for (char c : v) {
+            length += (static_cast<unsigned char>(c) & 0xc0) != 0x80;
+        }
+        if (length < schema.minLength) {
+            m_state->fail("minLength");
+        }
+        if (length > schema.maxLength) {
+            m_state->fail("maxLength");
+        }
+    }
+    if (schema.hasEnum) {
+        m_state->scalar(schema, v);
+    }
+    if (m_next) {
+        m_next->stringValue(v);
+    }
+}
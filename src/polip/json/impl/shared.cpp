@@ -0,0 +1,298 @@
+#include <vector>
+#include "polip/json/shared.hpp"
+#include "pointer.hpp"
+
+namespace pjson = polip::json;
+
+struct pjson::details::SharedNode
+{
+    enum class Kind
+    {
+        Scalar,
+        Array,
+        Object
+    };
+
+    Kind kind = Kind::Scalar;
+    Value scalar;
+    // items of an array, values of object members
+    std::vector<SharedValue> items;
+    // names of object members
+    std::vector<std::string> names;
+};
+
+namespace
+{
+
+using Node = pjson::details::SharedNode;
+using Kind = Node::Kind;
+
+// V is Value or const Value, the contents of a Value are moved
+template <typename V>
+std::shared_ptr<const Node> makeNode(V& value)
+{
+    using Array = typename std::conditional<std::is_const<V>::value,
+                                            const pjson::Array,
+                                            pjson::Array>::type;
+    using Object = typename std::conditional<std::is_const<V>::value,
+                                             const pjson::Object,
+                                             pjson::Object>::type;
+    if (boost::get<pjson::Null>(&value.get()) != nullptr) {
+        return nullptr;
+    }
+    auto node = std::make_shared<Node>();
+    if (auto array = boost::get<Array>(&value.get())) {
+        node->kind = Kind::Array;
+        node->items.reserve(array->size());
+        for (auto& item : *array) {
+            node->items.emplace_back(std::move(item));
+        }
+    } else if (auto object = boost::get<Object>(&value.get())) {
+        node->kind = Kind::Object;
+        node->items.reserve(object->size());
+        node->names.reserve(object->size());
+        for (auto& member : *object) {
+            node->names.push_back(std::move(member.first));
+            node->items.emplace_back(std::move(member.second));
+        }
+    } else {
+        node->scalar = std::move(value);
+    }
+    return node;
+}
+
+const Node& checkArray(const Node& node)
+{
+    if (node.kind != Kind::Array) {
+        throw pjson::not_array{};
+    }
+    return node;
+}
+
+const Node& checkObject(const Node& node)
+{
+    if (node.kind != Kind::Object) {
+        throw pjson::not_object{};
+    }
+    return node;
+}
+
+pjson::SharedValue replace(const pjson::SharedValue& document,
+                           const std::vector<std::string>& tokens,
+                           std::size_t i, pjson::SharedValue value)
+{
+    if (i == tokens.size()) {
+        return value;
+    }
+    const std::string& token = tokens[i];
+    const bool last = i + 1 == tokens.size();
+    if (document.isObject()) {
+        const pjson::SharedValue* child = document.find(token);
+        if (child == nullptr) {
+            if (!last) {
+                throw pjson::invalid_pointer{};
+            }
+            return document.withMember(token, std::move(value));
+        }
+        return document.withMember(
+            token, replace(*child, tokens, i + 1, std::move(value)));
+    }
+    if (document.isArray()) {
+        const std::size_t size = document.size();
+        std::size_t index;
+        if (!pjson::pointerIndex(token, size, index) || index > size ||
+            (index == size && !last)) {
+            throw pjson::invalid_pointer{};
+        }
+        if (index == size) {
+            return document.withAppended(std::move(value));
+        }
+        return document.withItem(index, replace(document.at(index), tokens,
+                                                i + 1, std::move(value)));
+    }
+    throw pjson::invalid_pointer{};
+}
+
+}  // anonymous namespace
+
+pjson::SharedValue::SharedValue(const Value& value) : m_node(makeNode(value))
+{
+}
+
+pjson::SharedValue::SharedValue(Value&& value) : m_node(makeNode(value))
+{
+}
+
+pjson::SharedValue::SharedValue(std::shared_ptr<details::SharedNode> node)
+    : m_node(std::move(node))
+{
+}
+
+pjson::Value pjson::SharedValue::toValue() const
+{
+    const Node& n = node();
+    switch (n.kind) {
+        case Kind::Array: {
+            Array array;
+            array.reserve(n.items.size());
+            for (auto const& item : n.items) {
+                array.push_back(item.toValue());
+            }
+            return Value(std::move(array));
+        }
+        case Kind::Object: {
+            Object object;
+            object.reserve(n.items.size());
+            for (std::size_t i = 0; i < n.items.size(); ++i) {
+                object.emplace_back(n.names[i], n.items[i].toValue());
+            }
+            return Value(std::move(object));
+        }
+        default:
+            return n.scalar;
+    }
+}
+
+bool pjson::SharedValue::isArray() const
+{
+    return node().kind == Kind::Array;
+}
+
+bool pjson::SharedValue::isObject() const
+{
+    return node().kind == Kind::Object;
+}
+
+std::size_t pjson::SharedValue::size() const
+{
+    if (node().kind == Kind::Scalar) {
+        throw not_array{};
+    }
+    return node().items.size();
+}
+
+const pjson::SharedValue& pjson::SharedValue::at(std::size_t index) const
+{
+    if (node().kind == Kind::Scalar) {
+        throw not_array{};
+    }
+    return node().items.at(index);
+}
+
+const std::string& pjson::SharedValue::name(std::size_t index) const
+{
+    return checkObject(node()).names.at(index);
+}
+
+const pjson::SharedValue* pjson::SharedValue::find(
+    const std::string& name) const
+{
+    const Node& n = checkObject(node());
+    for (std::size_t i = 0; i < n.names.size(); ++i) {
+        if (n.names[i] == name) {
+            return &n.items[i];
+        }
+    }
+    return nullptr;
+}
+
+pjson::SharedValue pjson::SharedValue::withItem(std::size_t index,
+                                                SharedValue item) const
+{
+    auto copy = std::make_shared<Node>(checkArray(node()));
+    copy->items.at(index) = std::move(item);
+    return SharedValue(std::move(copy));
+}
+
+pjson::SharedValue pjson::SharedValue::withAppended(SharedValue item) const
+{
+    const Node& n = checkArray(node());
+    auto copy = std::make_shared<Node>();
+    copy->kind = Kind::Array;
+    copy->items.reserve(n.items.size() + 1);
+    copy->items.insert(copy->items.end(), n.items.begin(), n.items.end());
+    copy->items.push_back(std::move(item));
+    return SharedValue(std::move(copy));
+}
+
+pjson::SharedValue pjson::SharedValue::withMember(const std::string& name,
+                                                  SharedValue value) const
+{
+    const Node& n = checkObject(node());
+    auto copy = std::make_shared<Node>();
+    copy->kind = Kind::Object;
+    copy->items.reserve(n.items.size() + 1);
+    copy->names.reserve(n.items.size() + 1);
+    copy->items.insert(copy->items.end(), n.items.begin(), n.items.end());
+    copy->names.insert(copy->names.end(), n.names.begin(), n.names.end());
+    for (std::size_t i = 0; i < copy->names.size(); ++i) {
+        if (copy->names[i] == name) {
+            copy->items[i] = std::move(value);
+            return SharedValue(std::move(copy));
+        }
+    }
+    copy->names.push_back(name);
+    copy->items.push_back(std::move(value));
+    return SharedValue(std::move(copy));
+}
+
+pjson::SharedValue pjson::SharedValue::withoutMember(
+    const std::string& name) const
+{
+    const Node& n = checkObject(node());
+    auto copy = std::make_shared<Node>();
+    copy->kind = Kind::Object;
+    for (std::size_t i = 0; i < n.names.size(); ++i) {
+        if (n.names[i] != name) {
+            copy->names.push_back(n.names[i]);
+            copy->items.push_back(n.items[i]);
+        }
+    }
+    return SharedValue(std::move(copy));
+}
+
+pjson::SharedValue pjson::SharedValue::withValueAt(const std::string& pointer,
+                                                   SharedValue value) const
+{
+    return replace(*this, pointerTokens(pointer), 0, std::move(value));
+}
+
+const pjson::details::SharedNode& pjson::SharedValue::node() const
+{
+    static const Node null;
+    return m_node ? *m_node : null;
+}
+
+const pjson::Value* pjson::SharedValue::scalar() const
+{
+    const Node& n = node();
+    return n.kind == Kind::Scalar ? &n.scalar : nullptr;
+}
+
+bool pjson::operator==(const SharedValue& lhs, const SharedValue& rhs)
+{
+    if (lhs.sameAs(rhs)) {
+        return true;
+    }
+    if (lhs.isArray() != rhs.isArray() || lhs.isObject() != rhs.isObject()) {
+        return false;
+    }
+    if (!lhs.isArray() && !lhs.isObject()) {
+        return *lhs.scalar() == *rhs.scalar();
+    }
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < lhs.size(); ++i) {
+        if ((lhs.isObject() && lhs.name(i) != rhs.name(i)) ||
+            lhs.at(i) != rhs.at(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool pjson::operator!=(const SharedValue& lhs, const SharedValue& rhs)
+{
+    return !(lhs == rhs);
+}
@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <utility>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "polip/json/source.hpp"
+#include "nesting.hpp"
+#include "stack_parser.hpp"
+#include "value_builder.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+// appends the offsets of the newlines in [begin, end), counted from base
+void collectNewlines(const char* base, const char* begin, const char* end,
+                     std::vector<std::size_t>& out)
+{
+    const char* it = begin;
+#if defined(__SSE2__)
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; end - it >= 16; it += 16) {
+        const __m128i block =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        unsigned mask = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+        for (; mask != 0; mask &= mask - 1) {
+            out.push_back(static_cast<std::size_t>(it - base) +
+                          __builtin_ctz(mask));
+        }
+    }
+#endif
+    for (; it != end; ++it) {
+        if (*it == '\n') {
+            out.push_back(static_cast<std::size_t>(it - base));
+        }
+    }
+}
+
+// Builds the Value and notes the offset of every value down to maxDepth,
+// in document order.
+class LocatingBuilder final : public pjson::DispatchTarget
+{
+public:
+    LocatingBuilder(const char* begin, std::size_t maxDepth)
+        : m_begin(begin), m_maxDepth(maxDepth)
+    {
+    }
+
+    pjson::Value& result()
+    {
+        return m_values.result();
+    }
+
+    const std::vector<std::size_t>& offsets() const
+    {
+        return m_offsets;
+    }
+
+    void valueAt(const char* it)
+    {
+        if (m_nesting.depth() <= m_maxDepth) {
+            m_offsets.push_back(static_cast<std::size_t>(it - m_begin));
+        }
+    }
+
+private:
+    void objectBeginImpl(const std::string& name) override
+    {
+        m_nesting.member();
+        m_values.objectBegin(name);
+    }
+
+    void objectEndImpl() override
+    {
+        m_nesting.closeObject();
+        m_values.objectEnd();
+    }
+
+    void arrayBeginImpl() override
+    {
+        m_nesting.openArray();
+        m_values.arrayBegin();
+    }
+
+    void arrayEndImpl() override
+    {
+        m_nesting.closeArray();
+        m_values.arrayEnd();
+    }
+
+    void nullValueImpl() override
+    {
+        m_nesting.value();
+        m_values.nullValue();
+    }
+
+    void boolValueImpl(bool v) override
+    {
+        m_nesting.value();
+        m_values.boolValue(v);
+    }
+
+    void integerValueImpl(int64_t v) override
+    {
+        m_nesting.value();
+        m_values.integerValue(v);
+    }
+
+    void doubleValueImpl(double v) override
+    {
+        m_nesting.value();
+        m_values.doubleValue(v);
+    }
+
+    void stringValueImpl(const std::string& v) override
+    {
+        m_nesting.value();
+        m_values.stringValue(v);
+    }
+
+    const char* m_begin;
+    std::size_t m_maxDepth;
+    pjson::ValueBuilder m_values;
+    pjson::Nesting m_nesting;
+    std::vector<std::size_t> m_offsets;
+};
+
+template <typename Policy>
+void parseAs(const char* begin, const char* end,
+             const pjson::ParseOptions& options, LocatingBuilder& builder)
+{
+    pjson::StackParser<const char*, Policy> parser(
+        begin, end, options.maxDepth, options.limits);
+    parser.parse(builder);
+}
+
+}  // anonymous namespace
+
+pjson::Location pjson::LineIndex::locate(std::size_t offset) const
+{
+    const std::size_t size = static_cast<std::size_t>(m_end - m_begin);
+    offset = std::min(offset, size);
+    scan(offset);
+    // newlines before offset
+    const auto line = std::lower_bound(m_newlines.begin(), m_newlines.end(),
+                                       offset);
+    const std::size_t start = line == m_newlines.begin() ? 0 : *(line - 1) + 1;
+    return Location{
+        static_cast<std::size_t>(line - m_newlines.begin()) + 1,
+        offset - start + 1};
+}
+
+void pjson::LineIndex::scan(std::size_t offset) const
+{
+    if (offset <= m_scanned) {
+        return;
+    }
+    // in steps of at least 64 KB so that rising offsets scan the text once
+    const std::size_t size = static_cast<std::size_t>(m_end - m_begin);
+    const std::size_t target =
+        std::min(size, std::max(offset, m_scanned + (64 << 10)));
+    collectNewlines(m_begin, m_begin + m_scanned, m_begin + target,
+                    m_newlines);
+    m_scanned = target;
+}
+
+const std::size_t pjson::SourceMap::npos;
+
+std::size_t pjson::SourceMap::offset(const Value& value) const
+{
+    auto it = m_offsets.find(&value);
+    return it == m_offsets.end() ? npos : it->second;
+}
+
+void pjson::SourceMap::assign(const Value& value,
+                              const std::vector<std::size_t>& offsets)
+{
+    m_offsets.clear();
+    m_offsets.reserve(offsets.size());
+    // values still to visit with their depth, walked without recursion
+    std::vector<std::pair<const Value*, std::size_t>> pending{{&value, 0}};
+    std::size_t next = 0;
+    while (!pending.empty() && next < offsets.size()) {
+        const Value* current = pending.back().first;
+        const std::size_t depth = pending.back().second;
+        pending.pop_back();
+        m_offsets.emplace(current, offsets[next++]);
+        if (depth == m_maxDepth) {
+            continue;
+        }
+        if (auto array = boost::get<Array>(&current->get())) {
+            for (auto it = array->rbegin(); it != array->rend(); ++it) {
+                pending.emplace_back(&*it, depth + 1);
+            }
+        } else if (auto object = boost::get<Object>(&current->get())) {
+            for (auto it = object->rbegin(); it != object->rend(); ++it) {
+                pending.emplace_back(&it->second, depth + 1);
+            }
+        }
+    }
+}
+
+void pjson::load(const char* begin, const char* end, Value& value,
+                 SourceMap& sources, const ParseOptions& options)
+{
+    const ResourceScope scope(options.resource ? options.resource
+                                               : currentResource());
+    LocatingBuilder builder(begin, sources.maxDepth());
+    if (options.level == Conformance::Strict) {
+        parseAs<StrictConformance>(begin, end, options, builder);
+    } else {
+        parseAs<RelaxedConformance>(begin, end, options, builder);
+    }
+    value = std::move(builder.result());
+    sources.assign(value, builder.offsets());
+}
+
+void pjson::load(const std::string& jsonDoc, Value& value, SourceMap& sources,
+                 const ParseOptions& options)
+{
+    load(jsonDoc.data(), jsonDoc.data() + jsonDoc.size(), value, sources,
+         options);
+}
@@ -0,0 +1,343 @@
+#ifndef INCLUDE_POLIP_JSON_IMPL_STACK_PARSER_HPP
+#define INCLUDE_POLIP_JSON_IMPL_STACK_PARSER_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "polip/json/error.hpp"
+#include "polip/json/parser.hpp"
+#include "conformance.hpp"
+#include "scanner.hpp"
+
+namespace polip
+{
+namespace json
+{
+namespace details
+{
+
+template <typename Target, typename Iterator>
+auto notePosition(Target& target, Iterator it, int)
+    -> decltype(target.valueAt(it), void())
+{
+    target.valueAt(it);
+}
+
+template <typename Target, typename Iterator>
+void notePosition(Target&, Iterator, long)
+{
+}
+
+// whether [begin, end) holds more than limit chars, without going
+// further than that into input that is not random access
+template <typename Iterator>
+bool longerThan(Iterator begin, Iterator end, std::size_t limit,
+                std::random_access_iterator_tag)
+{
+    return static_cast<std::size_t>(end - begin) > limit;
+}
+
+template <typename Iterator>
+bool longerThan(Iterator begin, Iterator end, std::size_t limit,
+                std::forward_iterator_tag)
+{
+    for (; begin != end; ++begin) {
+        if (limit-- == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Iterator>
+bool longerThan(Iterator begin, Iterator end, std::size_t limit)
+{
+    return longerThan(
+        begin, end, limit,
+        typename std::iterator_traits<Iterator>::iterator_category());
+}
+
+// reads a string, literal or number and reports it, false if there is
+// none; text is the buffer for strings
+template <typename Iterator, typename Policy, typename Target>
+bool readScalar(Scanner<Iterator, Policy>& in, std::string& text,
+                Target& target, const ParseLimits& limits)
+{
+    switch (in.peek()) {
+        case '\'':
+            if (!Policy::singleQuotes) {
+                break;
+            }
+            // fall through
+        case '"':
+            text.clear();
+            in.readString(text, limits.maxStringLength);
+            target.stringValue(text);
+            return true;
+        case 't':
+            if (in.consume("true")) {
+                target.boolValue(true);
+                return true;
+            }
+            break;
+        case 'f':
+            if (in.consume("false")) {
+                target.boolValue(false);
+                return true;
+            }
+            break;
+        case 'n':
+            if (in.consume("null")) {
+                target.nullValue();
+                return true;
+            }
+            break;
+    }
+
+    int64_t integer = 0;
+    double real = 0;
+    switch (in.readNumber(integer, real, limits.maxNumberLength)) {
+        case Scanner<Iterator, Policy>::Number::Integer:
+            target.integerValue(integer);
+            return true;
+        case Scanner<Iterator, Policy>::Number::Real:
+            target.doubleValue(real);
+            return true;
+        default:
+            return false;
+    }
+}
+
+}  // namespace details
+
+/*
+    Non-recursive parser: nesting is tracked by an explicit stack on the
+    heap, so the C++ stack use does not depend on the input. It accepts the
+    same language as ExtendedGrammar<Iterator, Policy> and reports events
+    to the target as described for DispatchTarget. Targets with a
+    valueAt(Iterator) member are also told where every value starts,
+    before its first event.
+ */
+template <typename Iterator, typename Policy>
+class StackParser
+{
+public:
+    using Error = parse_error<Iterator>;
+
+    StackParser(Iterator begin, Iterator end, std::size_t maxDepth,
+                const ParseLimits& limits = ParseLimits{})
+        : m_in(begin, end), m_maxDepth(maxDepth), m_limits(limits)
+    {
+        if (limits.maxDocumentBytes != noLimit &&
+            details::longerThan(begin, end, limits.maxDocumentBytes)) {
+            m_in.fail(DiagError::DocumentTooLarge,
+                      std::next(begin, limits.maxDocumentBytes));
+        }
+    }
+
+    template <typename Target>
+    void parse(Target& target);
+
+private:
+    enum class Scope : char
+    {
+        Array,
+        Object
+    };
+
+    void enter(Scope scope);
+    void leave();
+    // a value starts, an item if the scope is an array
+    void countValue();
+    // an item or member starts
+    void countElement();
+
+    DiagError invalidValue() const
+    {
+        if (m_scopes.empty()) {
+            return DiagError::Other;
+        }
+        return m_scopes.back() == Scope::Array ? DiagError::ExpectedArrayEnd
+                                               : DiagError::Value;
+    }
+
+    Scanner<Iterator, Policy> m_in;
+    std::size_t m_maxDepth;
+    ParseLimits m_limits;
+    std::vector<Scope> m_scopes;
+    // elements of the open containers but the innermost one
+    std::vector<std::size_t> m_counts;
+    std::size_t m_elements = 0;  // of the innermost open container
+    std::size_t m_nodes = 0;
+    std::string m_text;
+};
+
+template <typename Iterator, typename Policy>
+template <typename Target>
+void StackParser<Iterator, Policy>::parse(Target& target)
+{
+    enum class State
+    {
+        Value,
+        Member,
+        Next
+    };
+
+    m_in.skipSpace();
+    if (!Policy::anyValueDocument && !m_in.at('[') && !m_in.at('{')) {
+        m_in.fail(DiagError::Other);
+    }
+
+    State state = State::Value;
+    for (;;) {
+        switch (state) {
+            case State::Value:
+                countValue();
+                details::notePosition(target, m_in.position(), 0);
+                if (m_in.at('[') && target.skipArray()) {
+                    m_in.skipContainer();
+                    target.arrayBegin();
+                    target.arrayEnd();
+                    state = State::Next;
+                } else if (m_in.at('{') && target.skipObject()) {
+                    m_in.skipContainer();
+                    target.objectEnd();
+                    state = State::Next;
+                } else if (m_in.at('[')) {
+                    enter(Scope::Array);
+                    target.arrayBegin();
+                    m_in.skipSpace();
+                    if (m_in.at(']')) {
+                        m_in.advance();
+                        leave();
+                        target.arrayEnd();
+                        state = State::Next;
+                    }
+                } else if (m_in.at('{')) {
+                    enter(Scope::Object);
+                    m_in.skipSpace();
+                    if (m_in.at('}')) {
+                        m_in.advance();
+                        leave();
+                        target.objectEnd();
+                        state = State::Next;
+                    } else {
+                        state = State::Member;
+                    }
+                } else if (details::readScalar(m_in, m_text, target,
+                                               m_limits)) {
+                    state = State::Next;
+                } else {
+                    m_in.fail(invalidValue());
+                }
+                break;
+
+            case State::Member:
+                if (!m_in.atString()) {
+                    m_in.fail(DiagError::ExpectedObjectEnd);
+                }
+                countElement();
+                m_text.clear();
+                m_in.readString(m_text, m_limits.maxStringLength);
+                m_in.skipSpace();
+                if (!m_in.at(':')) {
+                    m_in.fail(DiagError::Colon);
+                }
+                m_in.advance();
+                m_in.skipSpace();
+                if (target.skipMember(m_text)) {
+                    m_in.skipValue();
+                    state = State::Next;
+                    break;
+                }
+                target.objectBegin(m_text);
+                state = State::Value;
+                break;
+
+            case State::Next:
+                m_in.skipSpace();
+                if (m_scopes.empty()) {
+                    if (!m_in.atEnd()) {
+                        m_in.fail(DiagError::Other);
+                    }
+                    return;
+                }
+                if (m_scopes.back() == Scope::Array) {
+                    if (m_in.at(',')) {
+                        m_in.advance();
+                        m_in.skipSpace();
+                        // a trailing comma is followed by the bracket
+                        if (!Policy::trailingCommas || !m_in.at(']')) {
+                            state = State::Value;
+                        }
+                    } else if (m_in.at(']')) {
+                        m_in.advance();
+                        leave();
+                        target.arrayEnd();
+                    } else {
+                        m_in.fail(DiagError::ExpectedArrayEnd);
+                    }
+                } else {
+                    if (m_in.at(',')) {
+                        m_in.advance();
+                        m_in.skipSpace();
+                        if (!Policy::trailingCommas || !m_in.at('}')) {
+                            state = State::Member;
+                        }
+                    } else if (m_in.at('}')) {
+                        m_in.advance();
+                        leave();
+                        target.objectEnd();
+                    } else {
+                        m_in.fail(DiagError::ExpectedObjectEnd);
+                    }
+                }
+                break;
+        }
+    }
+}
+
+template <typename Iterator, typename Policy>
+void StackParser<Iterator, Policy>::enter(Scope scope)
+{
+    if (m_scopes.size() >= m_maxDepth) {
+        m_in.fail(DiagError::MaxDepthExceeded);
+    }
+    m_scopes.push_back(scope);
+    m_counts.push_back(m_elements);
+    m_elements = 0;
+    m_in.advance();
+}
+
+template <typename Iterator, typename Policy>
+void StackParser<Iterator, Policy>::leave()
+{
+    m_scopes.pop_back();
+    m_elements = m_counts.back();
+    m_counts.pop_back();
+}
+
+template <typename Iterator, typename Policy>
+void StackParser<Iterator, Policy>::countValue()
+{
+    if (++m_nodes > m_limits.maxNodes) {
+        m_in.fail(DiagError::TooManyNodes);
+    }
+    if (!m_scopes.empty() && m_scopes.back() == Scope::Array) {
+        countElement();
+    }
+}
+
+template <typename Iterator, typename Policy>
+void StackParser<Iterator, Policy>::countElement()
+{
+    if (++m_elements > m_limits.maxContainerElements) {
+        m_in.fail(DiagError::TooManyElements);
+    }
+}
+
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_IMPL_STACK_PARSER_HPP
@@ -0,0 +1,416 @@
+#include <memory>
+#include <stdexcept>
+#include "polip/json/table.hpp"
+#include "nesting.hpp"
+#include "value_builder.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+// the document is not an array of objects with the same members
+struct NotTabular
+{
+};
+
+pjson::Column::Type typeOf(const pjson::Value& value)
+{
+    // alternatives in the order of the Value variant
+    static const pjson::Column::Type types[] = {
+        pjson::Column::Type::Null,   pjson::Column::Type::Bool,
+        pjson::Column::Type::Int,    pjson::Column::Type::Double,
+        pjson::Column::Type::String, pjson::Column::Type::Mixed,
+        pjson::Column::Type::Mixed};
+    return types[value.get().which()];
+}
+
+/*
+    Collects the columns row by row. Rows are expected to list their
+    members in the order of the first row, so the column of a member is
+    usually found without a lookup.
+
+    As a DispatchTarget it takes the events of the whole document: the
+    top level array is depth 1, its objects depth 2, values of members
+    that are containers themselves are assembled by a ValueBuilder.
+ */
+class TableBuilder final : public pjson::DispatchTarget
+{
+public:
+    std::vector<pjson::Column>& columns()
+    {
+        return m_columns;
+    }
+
+    std::size_t rows() const
+    {
+        return m_rows;
+    }
+
+    void beginRow()
+    {
+        ++m_rows;
+        m_member = 0;
+    }
+
+    pjson::Column& member(const std::string& name)
+    {
+        std::size_t index = m_member;
+        if (index >= m_columns.size() || m_columns[index].name() != name) {
+            auto it = m_index.find(name);
+            if (it != m_index.end()) {
+                index = it->second;
+            } else if (m_rows == 1) {
+                index = m_columns.size();
+                m_index.emplace(name, index);
+                m_columns.emplace_back(name);
+            } else {
+                throw NotTabular{};
+            }
+        }
+        pjson::Column& column = m_columns[index];
+        // a second member of the name in this row
+        if (column.size() != m_rows - 1) {
+            throw NotTabular{};
+        }
+        ++m_member;
+        m_column = index;
+        return column;
+    }
+
+    void endRow()
+    {
+        if (m_member != m_columns.size()) {
+            throw NotTabular{};
+        }
+    }
+
+private:
+    // a scalar or empty object outside of a capture
+    void add(pjson::Value&& value)
+    {
+        if (m_nesting.depth() != 2) {
+            throw NotTabular{};
+        }
+        m_columns[m_column].pushBack(std::move(value));
+    }
+
+    // events of member values that are containers
+    pjson::DispatchTarget& capture()
+    {
+        return *m_capture;
+    }
+
+    void endCapture()
+    {
+        if (m_nesting.depth() == 2) {
+            m_columns[m_column].pushBack(std::move(m_capture->result()));
+            m_capture.reset();
+        }
+    }
+
+    void objectBeginImpl(const std::string& name) override
+    {
+        const bool opened = m_nesting.member();
+        const std::size_t depth = m_nesting.depth();
+        if (depth == 1) {
+            throw NotTabular{};
+        }
+        if (depth == 2) {
+            if (opened) {
+                beginRow();
+            }
+            member(name);
+            return;
+        }
+        if (depth == 3 && opened) {
+            m_capture.reset(new pjson::ValueBuilder);
+        }
+        capture().objectBegin(name);
+    }
+
+    void objectEndImpl() override
+    {
+        const bool closed = m_nesting.closeObject();
+        const std::size_t depth = m_nesting.depth();
+        if (closed && depth == 1) {
+            endRow();
+        } else if (!closed && depth == 1) {
+            // a row without members
+            beginRow();
+            endRow();
+        } else if (!closed && depth == 2) {
+            add(pjson::Object{});
+        } else if (depth >= 2) {
+            capture().objectEnd();
+            endCapture();
+        } else {
+            throw NotTabular{};
+        }
+    }
+
+    void arrayBeginImpl() override
+    {
+        m_nesting.openArray();
+        const std::size_t depth = m_nesting.depth();
+        if (depth == 2) {
+            throw NotTabular{};
+        }
+        if (depth == 3) {
+            m_capture.reset(new pjson::ValueBuilder);
+        }
+        if (depth >= 3) {
+            capture().arrayBegin();
+        }
+    }
+
+    void arrayEndImpl() override
+    {
+        m_nesting.closeArray();
+        if (m_nesting.depth() >= 2) {
+            capture().arrayEnd();
+            endCapture();
+        }
+    }
+
+    void nullValueImpl() override
+    {
+        m_nesting.value();
+        if (m_nesting.depth() > 2) {
+            capture().nullValue();
+        } else {
+            add(pjson::Null{});
+        }
+    }
+
+    void boolValueImpl(bool v) override
+    {
+        m_nesting.value();
+        if (m_nesting.depth() > 2) {
+            capture().boolValue(v);
+        } else {
+            add(v);
+        }
+    }
+
+    void integerValueImpl(int64_t v) override
+    {
+        m_nesting.value();
+        if (m_nesting.depth() > 2) {
+            capture().integerValue(v);
+        } else {
+            add(v);
+        }
+    }
+
+    void doubleValueImpl(double v) override
+    {
+        m_nesting.value();
+        if (m_nesting.depth() > 2) {
+            capture().doubleValue(v);
+        } else {
+            add(v);
+        }
+    }
+
+    void stringValueImpl(const std::string& v) override
+    {
+        m_nesting.value();
+        if (m_nesting.depth() > 2) {
+            capture().stringValue(v);
+        } else {
+            add(v);
+        }
+    }
+
+    std::vector<pjson::Column> m_columns;
+    std::unordered_map<std::string, std::size_t> m_index;
+    std::size_t m_rows = 0;
+    std::size_t m_member = 0;  // members seen in the current row
+    std::size_t m_column = 0;  // column of the open member
+    pjson::Nesting m_nesting;
+    std::unique_ptr<pjson::ValueBuilder> m_capture;
+};
+
+}  // anonymous namespace
+
+const std::vector<char>& pjson::Column::bools() const
+{
+    if (m_type != Type::Bool) {
+        throw not_bool{};
+    }
+    return m_bools;
+}
+
+const std::vector<int64_t>& pjson::Column::integers() const
+{
+    if (m_type != Type::Int) {
+        throw not_int{};
+    }
+    return m_integers;
+}
+
+const std::vector<double>& pjson::Column::doubles() const
+{
+    if (m_type != Type::Double) {
+        throw not_double{};
+    }
+    return m_doubles;
+}
+
+const std::vector<std::string>& pjson::Column::strings() const
+{
+    if (m_type != Type::String) {
+        throw not_string{};
+    }
+    return m_strings;
+}
+
+const std::vector<pjson::Value>& pjson::Column::values() const
+{
+    if (m_type != Type::Mixed) {
+        throw error{};
+    }
+    return m_values;
+}
+
+pjson::Value pjson::Column::at(std::size_t row) const
+{
+    if (row >= m_size) {
+        throw std::out_of_range("row past the end of the column");
+    }
+    switch (m_type) {
+        case Type::Null:
+            return Null{};
+        case Type::Bool:
+            return m_bools[row] != 0;
+        case Type::Int:
+            return m_integers[row];
+        case Type::Double:
+            return m_doubles[row];
+        case Type::String:
+            return m_strings[row];
+        case Type::Mixed:
+            break;
+    }
+    return m_values[row];
+}
+
+void pjson::Column::pushBack(Value value)
+{
+    const Type type = typeOf(value);
+    if (m_size == 0) {
+        m_type = type;
+    } else if (type != m_type && m_type != Type::Mixed) {
+        mix();
+    }
+    switch (m_type) {
+        case Type::Null:
+            break;
+        case Type::Bool:
+            m_bools.push_back(value.as<bool>());
+            break;
+        case Type::Int:
+            m_integers.push_back(value.as<int64_t>());
+            break;
+        case Type::Double:
+            m_doubles.push_back(value.as<double>());
+            break;
+        case Type::String:
+            m_strings.push_back(std::move(value.as<std::string>()));
+            break;
+        case Type::Mixed:
+            m_values.push_back(std::move(value));
+            break;
+    }
+    ++m_size;
+}
+
+void pjson::Column::mix()
+{
+    std::vector<Value> values;
+    values.reserve(m_size + 1);
+    for (std::size_t row = 0; row < m_size; ++row) {
+        values.push_back(at(row));
+    }
+    m_values = std::move(values);
+    m_bools = std::vector<char>{};
+    m_integers = std::vector<int64_t>{};
+    m_doubles = std::vector<double>{};
+    m_strings = std::vector<std::string>{};
+    m_type = Type::Mixed;
+}
+
+pjson::Table::Table(std::vector<Column>&& columns, std::size_t rows)
+    : m_rows(rows), m_columns(std::move(columns))
+{
+    for (std::size_t i = 0; i < m_columns.size(); ++i) {
+        m_index.emplace(m_columns[i].name(), i);
+    }
+}
+
+boost::optional<pjson::Table> pjson::Table::load(const std::string& jsonDoc,
+                                                 const ParseOptions& options)
+{
+    TableBuilder builder;
+    try {
+        parse(jsonDoc, builder, options);
+    } catch (const NotTabular&) {
+        return boost::none;
+    }
+    return Table(std::move(builder.columns()), builder.rows());
+}
+
+boost::optional<pjson::Table> pjson::Table::fromValue(const Value& value)
+{
+    const Array* rows = boost::get<Array>(&value.get());
+    if (rows == nullptr) {
+        return boost::none;
+    }
+    TableBuilder builder;
+    try {
+        for (auto const& row : *rows) {
+            const Object* object = boost::get<Object>(&row.get());
+            if (object == nullptr) {
+                return boost::none;
+            }
+            builder.beginRow();
+            for (auto const& member : *object) {
+                builder.member(member.first).pushBack(member.second);
+            }
+            builder.endRow();
+        }
+    } catch (const NotTabular&) {
+        return boost::none;
+    }
+    return Table(std::move(builder.columns()), builder.rows());
+}
+
+const pjson::Column* pjson::Table::column(const std::string& name) const
+{
+    auto it = m_index.find(name);
+    return it == m_index.end() ? nullptr : &m_columns[it->second];
+}
+
+pjson::Value pjson::Table::row(std::size_t index) const
+{
+    if (index >= m_rows) {
+        throw std::out_of_range("row past the end of the table");
+    }
+    Object object;
+    object.reserve(m_columns.size());
+    for (auto const& column : m_columns) {
+        object.emplace_back(column.name(), column.at(index));
+    }
+    return object;
+}
+
+pjson::Value pjson::Table::toValue() const
+{
+    Array array;
+    array.reserve(m_rows);
+    for (std::size_t i = 0; i < m_rows; ++i) {
+        array.push_back(row(i));
+    }
+    return array;
+}
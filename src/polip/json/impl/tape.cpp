@@ -0,0 +1,708 @@
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "polip/json/tape.hpp"
+#include "nesting.hpp"
+#include "stack_parser.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+const char magic[8] = {'P', 'O', 'L', 'I', 'P', 'T', 'P', '2'};
+
+struct Header
+{
+    char magic[8];
+    std::uint64_t wordCount;
+    std::uint64_t stringBytes;
+    // the KeyTable prefix of the string area
+    std::uint64_t keyTable;
+    std::uint64_t keyBytes;
+};
+
+const unsigned countBits = 24;
+const std::uint64_t maxCount = (std::uint64_t{1} << countBits) - 1;
+const std::uint64_t indexMask = 0xffffffff;
+const std::uint64_t payloadMask = (std::uint64_t{1} << 56) - 1;
+
+std::uint64_t makeWord(char tag, std::uint64_t payload = 0)
+{
+    return (static_cast<std::uint64_t>(static_cast<unsigned char>(tag)) << 56) |
+           payload;
+}
+
+using Offsets = std::unordered_map<std::string, std::uint64_t>;
+
+// FNV-1a of the bytes, 0 only for none
+std::uint64_t fingerprint(const char* bytes, std::size_t size)
+{
+    if (size == 0) {
+        return 0;
+    }
+    std::uint64_t h = 0xcbf29ce484222325ull;
+    for (std::size_t i = 0; i < size; ++i) {
+        h = (h ^ static_cast<unsigned char>(bytes[i])) * 0x100000001b3ull;
+    }
+    return h ? h : 1;
+}
+
+void appendEntry(std::string& strings, boost::string_view v)
+{
+    if (v.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::length_error("tape string longer than 4 GiB");
+    }
+    if (strings.size() > payloadMask) {
+        throw std::length_error("tape string area too large");
+    }
+    const std::uint32_t length = static_cast<std::uint32_t>(v.size());
+    strings.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    strings.append(v.data(), v.size());
+}
+
+// Writes the tape straight from parsing events.
+class TapeBuilder final : public pjson::DispatchTarget
+{
+public:
+    TapeBuilder() = default;
+
+    // interns object keys, the string area starts with the entries of
+    // a KeyTable at the given offsets
+    TapeBuilder(const std::string& tableStrings, const Offsets& tableOffsets)
+        : strings(tableStrings), m_interning(true), m_table(&tableOffsets)
+    {
+    }
+
+    std::vector<std::uint64_t> words;
+    std::string strings;
+
+private:
+    struct Open
+    {
+        std::size_t index;
+        std::uint64_t count;
+    };
+
+    void countInArray()
+    {
+        if (m_nesting.inArray()) {
+            ++m_open.back().count;
+        }
+    }
+
+    void open(char tag)
+    {
+        m_open.push_back(Open{words.size(), 0});
+        words.push_back(makeWord(tag));
+    }
+
+    void close(char tag)
+    {
+        const Open open = m_open.back();
+        m_open.pop_back();
+        words.push_back(makeWord(tag, open.index));
+        if (words.size() > indexMask) {
+            throw std::length_error("tape longer than 2^32 words");
+        }
+        const std::uint64_t count = open.count < maxCount ? open.count : maxCount;
+        words[open.index] |= (count << 32) | words.size();
+    }
+
+    void string(const std::string& v)
+    {
+        words.push_back(makeWord('s', strings.size()));
+        appendEntry(strings, v);
+    }
+
+    void key(const std::string& name)
+    {
+        if (!m_interning) {
+            string(name);
+            return;
+        }
+        auto shared = m_table->find(name);
+        if (shared != m_table->end()) {
+            words.push_back(makeWord('s', shared->second));
+            return;
+        }
+        auto inserted = m_keys.emplace(name, strings.size());
+        if (inserted.second) {
+            appendEntry(strings, name);
+        }
+        words.push_back(makeWord('s', inserted.first->second));
+    }
+
+    void scalar(char tag)
+    {
+        countInArray();
+        m_nesting.value();
+        words.push_back(makeWord(tag));
+    }
+
+    void objectBeginImpl(const std::string& name) override
+    {
+        countInArray();
+        if (m_nesting.member()) {
+            open('{');
+        }
+        ++m_open.back().count;
+        key(name);
+    }
+
+    void objectEndImpl() override
+    {
+        if (m_nesting.closeObject()) {
+            close('}');
+        } else {
+            countInArray();
+            if (words.size() + 2 > indexMask) {
+                throw std::length_error("tape longer than 2^32 words");
+            }
+            words.push_back(makeWord('{', words.size() + 2));
+            words.push_back(makeWord('}', words.size() - 1));
+        }
+    }
+
+    void arrayBeginImpl() override
+    {
+        countInArray();
+        m_nesting.openArray();
+        open('[');
+    }
+
+    void arrayEndImpl() override
+    {
+        m_nesting.closeArray();
+        close(']');
+    }
+
+    void nullValueImpl() override
+    {
+        scalar('n');
+    }
+
+    void boolValueImpl(bool v) override
+    {
+        scalar(v ? 't' : 'f');
+    }
+
+    void integerValueImpl(int64_t v) override
+    {
+        scalar('l');
+        words.push_back(static_cast<std::uint64_t>(v));
+    }
+
+    void doubleValueImpl(double v) override
+    {
+        scalar('d');
+        std::uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        words.push_back(bits);
+    }
+
+    void stringValueImpl(const std::string& v) override
+    {
+        countInArray();
+        m_nesting.value();
+        string(v);
+    }
+
+    pjson::Nesting m_nesting;
+    std::vector<Open> m_open;
+    bool m_interning = false;
+    const Offsets* m_table = nullptr;
+    // keys interned by this tape only
+    Offsets m_keys;
+};
+
+template <typename Policy>
+void parseAs(const std::string& jsonDoc, const pjson::ParseOptions& options,
+             TapeBuilder& builder)
+{
+    pjson::StackParser<std::string::const_iterator, Policy> parser(
+        jsonDoc.begin(), jsonDoc.end(), options.maxDepth, options.limits);
+    parser.parse(builder);
+}
+
+void parseInto(const std::string& jsonDoc, const pjson::ParseOptions& options,
+               TapeBuilder& builder)
+{
+    if (options.level == pjson::Conformance::Strict) {
+        parseAs<pjson::StrictConformance>(jsonDoc, options, builder);
+    } else {
+        parseAs<pjson::RelaxedConformance>(jsonDoc, options, builder);
+    }
+}
+
+class Mapping
+{
+public:
+    Mapping(void* address, std::size_t length)
+        : m_address(address), m_length(length)
+    {
+    }
+
+    ~Mapping()
+    {
+        ::munmap(m_address, m_length);
+    }
+
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+
+private:
+    void* m_address;
+    std::size_t m_length;
+};
+
+bool validEntry(std::uint64_t offset, const char* strings,
+                std::size_t stringBytes)
+{
+    std::uint32_t length;
+    if (offset > stringBytes || stringBytes - offset < sizeof(length)) {
+        return false;
+    }
+    std::memcpy(&length, strings + offset, sizeof(length));
+    return length <= stringBytes - offset - sizeof(length);
+}
+
+// Walks the words once, checking what TapeValue relies on: known tags,
+// string entries inside the string area, container end indices pointing
+// past their matching end word, key words before object member values
+// and item counts, so no navigation of a mapped tape leaves the file.
+bool validTape(const std::uint64_t* words, std::size_t wordCount,
+               const char* strings, std::size_t stringBytes)
+{
+    struct Open
+    {
+        std::size_t index;
+        bool object;
+        bool key;  // a key or the end is expected next
+        std::uint64_t count;
+    };
+    std::vector<Open> open;
+    std::size_t i = 0;
+    while (i < wordCount) {
+        const char tag = static_cast<char>(words[i] >> 56);
+        const std::uint64_t payload = words[i] & payloadMask;
+        if (!open.empty() && open.back().key && tag != '}') {
+            if (tag != 's' || !validEntry(payload, strings, stringBytes)) {
+                return false;
+            }
+            open.back().key = false;
+            ++open.back().count;
+            ++i;
+            continue;
+        }
+        if (!open.empty() && !open.back().object && tag != ']') {
+            ++open.back().count;
+        }
+        switch (tag) {
+            case 'n':
+            case 't':
+            case 'f':
+                ++i;
+                break;
+            case 'l':
+            case 'd':
+                if (wordCount - i < 2) {
+                    return false;
+                }
+                i += 2;
+                break;
+            case 's':
+                if (!validEntry(payload, strings, stringBytes)) {
+                    return false;
+                }
+                ++i;
+                break;
+            case '[':
+            case '{': {
+                const std::uint64_t end = payload & indexMask;
+                if (end < i + 2 || end > wordCount) {
+                    return false;
+                }
+                open.push_back(Open{i, tag == '{', tag == '{', 0});
+                ++i;
+                continue;
+            }
+            case ']':
+            case '}': {
+                if (open.empty() || open.back().object != (tag == '}') ||
+                    (tag == '}' && !open.back().key) ||
+                    payload != open.back().index) {
+                    return false;
+                }
+                const std::uint64_t begin = words[open.back().index];
+                const std::uint64_t count = open.back().count;
+                if ((begin & indexMask) != i + 1 ||
+                    ((begin & payloadMask) >> 32) !=
+                        (count < maxCount ? count : maxCount)) {
+                    return false;
+                }
+                open.pop_back();
+                ++i;
+                break;
+            }
+            default:
+                return false;
+        }
+        // a value is complete
+        if (open.empty()) {
+            return i == wordCount;
+        }
+        if (open.back().object) {
+            open.back().key = true;
+        }
+    }
+    return false;
+}
+
+std::system_error systemError(const std::string& what)
+{
+    return std::system_error(errno, std::system_category(), what);
+}
+
+}  // anonymous namespace
+
+struct pjson::Tape::Storage
+{
+    std::vector<std::uint64_t> words;
+    std::string strings;
+    std::unique_ptr<Mapping> mapping;
+};
+
+pjson::KeyTable::KeyTable(const std::vector<std::string>& keys)
+{
+    for (auto const& key : keys) {
+        if (m_offsets.emplace(key, m_strings.size()).second) {
+            appendEntry(m_strings, key);
+        }
+    }
+    m_fingerprint = fingerprint(m_strings.data(), m_strings.size());
+}
+
+pjson::TapeKey pjson::KeyTable::find(boost::string_view name) const
+{
+    TapeKey key;
+    auto it = m_offsets.find(std::string(name.data(), name.size()));
+    if (it != m_offsets.end()) {
+        key.offset = it->second;
+        key.table = m_fingerprint;
+        key.name = it->first;
+    }
+    return key;
+}
+
+pjson::Tape pjson::Tape::load(const std::string& jsonDoc,
+                              const ParseOptions& options)
+{
+    TapeBuilder builder;
+    parseInto(jsonDoc, options, builder);
+    return adopt(builder.words, builder.strings);
+}
+
+pjson::Tape pjson::Tape::load(const std::string& jsonDoc,
+                              const ParseOptions& options,
+                              const KeyTable& keys)
+{
+    TapeBuilder builder(keys.m_strings, keys.m_offsets);
+    parseInto(jsonDoc, options, builder);
+    return adopt(builder.words, builder.strings, &keys);
+}
+
+pjson::Tape pjson::Tape::adopt(std::vector<std::uint64_t>& words,
+                               std::string& strings, const KeyTable* keys)
+{
+    std::shared_ptr<Storage> storage = std::make_shared<Storage>();
+    storage->words.swap(words);
+    storage->strings.swap(strings);
+
+    Tape tape;
+    tape.m_words = storage->words.data();
+    tape.m_wordCount = storage->words.size();
+    tape.m_strings = storage->strings.data();
+    tape.m_stringBytes = storage->strings.size();
+    if (keys != nullptr) {
+        tape.m_keyTable = keys->m_fingerprint;
+        tape.m_keyBytes = keys->m_strings.size();
+    }
+    tape.m_storage = std::move(storage);
+    return tape;
+}
+
+pjson::Tape pjson::Tape::map(const std::string& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw systemError("cannot open " + path);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        const std::system_error e = systemError("cannot stat " + path);
+        ::close(fd);
+        throw e;
+    }
+    const std::size_t length = static_cast<std::size_t>(info.st_size);
+    if (length < sizeof(Header)) {
+        ::close(fd);
+        throw invalid_tape{};
+    }
+    void* address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        throw systemError("cannot map " + path);
+    }
+
+    std::shared_ptr<Storage> storage = std::make_shared<Storage>();
+    storage->mapping.reset(new Mapping(address, length));
+
+    const char* data = static_cast<const char*>(address);
+    Header header;
+    std::memcpy(&header, data, sizeof(header));
+    const std::size_t available = length - sizeof(Header);
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 ||
+        header.wordCount == 0 ||
+        header.wordCount > available / sizeof(std::uint64_t) ||
+        header.stringBytes !=
+            available - header.wordCount * sizeof(std::uint64_t) ||
+        header.keyBytes > header.stringBytes) {
+        throw invalid_tape{};
+    }
+
+    Tape tape;
+    tape.m_words = reinterpret_cast<const std::uint64_t*>(data + sizeof(Header));
+    tape.m_wordCount = header.wordCount;
+    tape.m_strings = data + sizeof(Header) + header.wordCount * sizeof(std::uint64_t);
+    tape.m_stringBytes = header.stringBytes;
+    tape.m_keyTable = header.keyTable;
+    tape.m_keyBytes = header.keyBytes;
+    if (!validTape(tape.m_words, tape.m_wordCount, tape.m_strings,
+                   tape.m_stringBytes) ||
+        fingerprint(tape.m_strings, tape.m_keyBytes) != tape.m_keyTable) {
+        throw invalid_tape{};
+    }
+    tape.m_storage = std::move(storage);
+    return tape;
+}
+
+void pjson::Tape::save(const std::string& path) const
+{
+    Header header;
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.wordCount = m_wordCount;
+    header.stringBytes = m_stringBytes;
+    header.keyTable = m_keyTable;
+    header.keyBytes = m_keyBytes;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(m_words),
+              m_wordCount * sizeof(std::uint64_t));
+    out.write(m_strings, m_stringBytes);
+    out.close();
+    if (!out) {
+        throw systemError("cannot write " + path);
+    }
+}
+
+std::size_t pjson::TapeValue::next() const
+{
+    switch (tag()) {
+        case '[':
+        case '{':
+            return payload() & indexMask;
+        case 'l':
+        case 'd':
+            return m_index + 2;
+        default:
+            return m_index + 1;
+    }
+}
+
+boost::string_view pjson::TapeValue::text() const
+{
+    const char* entry = m_strings + payload();
+    std::uint32_t length;
+    std::memcpy(&length, entry, sizeof(length));
+    return boost::string_view(entry + sizeof(length), length);
+}
+
+template <typename T>
+void pjson::TapeValue::expect(Type t) const
+{
+    if (type() != t) {
+        throw typename details::UnexpectedType<T>::error{};
+    }
+}
+
+namespace polip
+{
+namespace json
+{
+
+template <>
+Null TapeValue::as<Null>() const
+{
+    expect<Null>(Type::Null);
+    return Null{};
+}
+
+template <>
+bool TapeValue::as<bool>() const
+{
+    if (type() != Type::True) {
+        expect<bool>(Type::False);
+    }
+    return type() == Type::True;
+}
+
+template <>
+int64_t TapeValue::as<int64_t>() const
+{
+    expect<int64_t>(Type::Int);
+    return static_cast<int64_t>(m_words[m_index + 1]);
+}
+
+template <>
+double TapeValue::as<double>() const
+{
+    expect<double>(Type::Double);
+    double v;
+    std::memcpy(&v, &m_words[m_index + 1], sizeof(v));
+    return v;
+}
+
+template <>
+boost::string_view TapeValue::as<boost::string_view>() const
+{
+    expect<std::string>(Type::String);
+    return text();
+}
+
+template <>
+std::string TapeValue::as<std::string>() const
+{
+    const boost::string_view v = as<boost::string_view>();
+    return std::string(v.data(), v.size());
+}
+
+}
+}  // namespace polip::json
+
+std::size_t pjson::TapeValue::size() const
+{
+    if (type() != Type::Array) {
+        expect<Object>(Type::Object);
+    }
+    const std::uint64_t count = payload() >> 32;
+    if (count < maxCount) {
+        return count;
+    }
+    std::size_t n = 0;
+    if (type() == Type::Array) {
+        for (auto it = arrayBegin(); it != arrayEnd(); ++it) {
+            ++n;
+        }
+    } else {
+        for (auto it = objectBegin(); it != objectEnd(); ++it) {
+            ++n;
+        }
+    }
+    return n;
+}
+
+pjson::TapeValue::array_iterator pjson::TapeValue::arrayBegin() const
+{
+    expect<Array>(Type::Array);
+    return array_iterator(at(m_index + 1));
+}
+
+pjson::TapeValue::array_iterator pjson::TapeValue::arrayEnd() const
+{
+    expect<Array>(Type::Array);
+    return array_iterator(at((payload() & indexMask) - 1));
+}
+
+pjson::TapeValue::object_iterator pjson::TapeValue::objectBegin() const
+{
+    expect<Object>(Type::Object);
+    return object_iterator(at(m_index + 1));
+}
+
+pjson::TapeValue::object_iterator pjson::TapeValue::objectEnd() const
+{
+    expect<Object>(Type::Object);
+    return object_iterator(at((payload() & indexMask) - 1));
+}
+
+pjson::TapeValue::object_iterator pjson::TapeValue::find(
+    boost::string_view name) const
+{
+    auto it = objectBegin();
+    const auto end = objectEnd();
+    while (it != end && it->first != name) {
+        ++it;
+    }
+    return it;
+}
+
+pjson::TapeValue::object_iterator pjson::TapeValue::find(TapeKey key) const
+{
+    if (key.valid() && key.table != m_keyTable) {
+        return find(key.name);
+    }
+    expect<Object>(Type::Object);
+    const std::uint64_t wanted = makeWord('s', key.offset);
+    const std::size_t end = (payload() & indexMask) - 1;
+    std::size_t index = m_index + 1;
+    while (index != end && m_words[index] != wanted) {
+        index = at(index + 1).next();
+    }
+    return object_iterator(at(index));
+}
+
+pjson::Value pjson::TapeValue::toValue() const
+{
+    switch (type()) {
+        case Type::Null:
+            return Null{};
+        case Type::True:
+        case Type::False:
+            return as<bool>();
+        case Type::Int:
+            return as<int64_t>();
+        case Type::Double:
+            return as<double>();
+        case Type::String:
+            return as<std::string>();
+        case Type::Array: {
+            Array array;
+            array.reserve(size());
+            for (auto it = arrayBegin(); it != arrayEnd(); ++it) {
+                array.push_back(it->toValue());
+            }
+            return array;
+        }
+        case Type::Object: {
+            Object object;
+            object.reserve(size());
+            for (auto it = objectBegin(); it != objectEnd(); ++it) {
+                object.emplace_back(
+                    std::string(it->first.data(), it->first.size()),
+                    it->second.toValue());
+            }
+            return object;
+        }
+    }
+    return Null{};
+}
@@ -0,0 +1,90 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "polip/json/text.hpp"
+
+namespace pjson = polip::json;
+
+void pjson::appendString(std::string& out, boost::string_view v)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    out += '"';
+    auto run = v.begin();
+    for (auto it = v.begin(); it != v.end(); ++it) {
+        const unsigned char c = static_cast<unsigned char>(*it);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        out.append(run, it);
+        run = it + 1;
+        out += '\\';
+        switch (c) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '\b': out += 'b'; break;
+            case '\f': out += 'f'; break;
+            case '\n': out += 'n'; break;
+            case '\r': out += 'r'; break;
+            case '\t': out += 't'; break;
+            default:
+                out += "u00";
+                out += hex[c >> 4];
+                out += hex[c & 0xf];
+        }
+    }
+    out.append(run, v.end());
+    out += '"';
+}
+
+void pjson::appendInteger(std::string& out, int64_t v)
+{
+    if (v < 0) {
+        out += '-';
+        // magnitude as unsigned, the minimal value has no positive
+        // counterpart
+        appendUnsigned(out, 0 - static_cast<uint64_t>(v));
+    } else {
+        appendUnsigned(out, static_cast<uint64_t>(v));
+    }
+}
+
+void pjson::appendUnsigned(std::string& out, uint64_t v)
+{
+    char buffer[24];
+    char* end = buffer + sizeof(buffer);
+    char* it = end;
+    do {
+        *--it = static_cast<char>('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+    out.append(it, end);
+}
+
+void pjson::appendDouble(std::string& out, double v, bool nonFinite)
+{
+    if (!std::isfinite(v)) {
+        if (!nonFinite) {
+            out += "null";
+        } else if (std::isnan(v)) {
+            out += "nan";
+        } else {
+            out += v < 0 ? "-inf" : "inf";
+        }
+        return;
+    }
+    // fewest digits, up to 17, that read back as v
+    char buffer[32];
+    int size = 0;
+    for (int precision = 15; precision <= 17; ++precision) {
+        size = std::snprintf(buffer, sizeof(buffer), "%.*g", precision, v);
+        if (std::strtod(buffer, nullptr) == v) {
+            break;
+        }
+    }
+    out.append(buffer, size);
+    if (std::strpbrk(buffer, ".e") == nullptr) {
+        out += ".0";
+    }
+}
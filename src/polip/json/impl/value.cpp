@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "polip/json/value.hpp"
 
 namespace pjson = polip::json;
@@ -115,10 +116,84 @@ struct ValueEqual : public boost::static_visitor<bool>
 
 bool pjson::operator==(const Value& lhs, const Value& rhs)
 {
+    // no shortcut for a value compared with itself: NaN, also one inside
+    // a container, is not equal to itself
     return boost::apply_visitor(ValueEqual(), lhs.get(), rhs.get());
 }
 
 bool pjson::operator!=(const Value& lhs, const Value& rhs)
 {
-    return !boost::apply_visitor(ValueEqual(), lhs.get(), rhs.get());
+    return !(lhs == rhs);
+}
+
+std::size_t pjson::Value::size() const
+{
+    if (auto object = boost::get<Object>(&get())) {
+        return object->size();
+    }
+    return as<Array>().size();
+}
+
+void pjson::Value::reserve(std::size_t size)
+{
+    if (auto object = boost::get<Object>(&get())) {
+        object->reserve(size);
+        return;
+    }
+    as<Array>().reserve(size);
+}
+
+pjson::Value& pjson::Value::pushBack(Value item)
+{
+    Array& array = as<Array>();
+    array.push_back(std::move(item));
+    return array.back();
+}
+
+pjson::Value& pjson::Value::set(const std::string& name, Value value)
+{
+    if (Value* member = find(name)) {
+        *member = std::move(value);
+        return *member;
+    }
+    return append(name, std::move(value));
+}
+
+pjson::Value& pjson::Value::append(std::string name, Value value)
+{
+    Object& object = as<Object>();
+    object.emplace_back(std::move(name), std::move(value));
+    return object.back().second;
+}
+
+pjson::Value* pjson::Value::find(const std::string& name)
+{
+    for (auto& member : as<Object>()) {
+        if (member.first == name) {
+            return &member.second;
+        }
+    }
+    return nullptr;
+}
+
+const pjson::Value* pjson::Value::find(const std::string& name) const
+{
+    for (auto const& member : as<Object>()) {
+        if (member.first == name) {
+            return &member.second;
+        }
+    }
+    return nullptr;
+}
+
+std::size_t pjson::Value::erase(const std::string& name)
+{
+    Object& object = as<Object>();
+    const std::size_t size = object.size();
+    object.erase(std::remove_if(object.begin(), object.end(),
+                                [&name](const NameValue& member) {
+                                    return member.first == name;
+                                }),
+                 object.end());
+    return size - object.size();
 }
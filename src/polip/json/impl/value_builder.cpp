@@ -0,0 +1,170 @@
+#include <iterator>
+#include "value_builder.hpp"
+
+namespace pjson = polip::json;
+
+pjson::ValueBuilder::~ValueBuilder()
+{
+    // containers still open at an error
+    for (const Frame& frame : m_stack) {
+        if (frame.charged != 0) {
+            m_budget->release(frame.charged);
+        }
+    }
+}
+
+void pjson::ValueBuilder::open(bool object, std::size_t start)
+{
+    if (m_stack.empty()) {
+        m_budget = details::currentBudget();
+    }
+    m_stack.push_back(Frame{object, false, start, 0});
+}
+
+void pjson::ValueBuilder::charge(std::size_t length)
+{
+    const std::size_t bytes = details::stringBytes(length);
+    if (bytes != 0 && m_budget && currentResource() == m_budget) {
+        m_budget->charge(bytes);
+        m_stack.back().charged += bytes;
+    }
+}
+
+void pjson::ValueBuilder::close(void* data)
+{
+    const std::size_t charged = m_stack.back().charged;
+    m_stack.pop_back();
+    if (charged != 0) {
+        details::attachCharge(data, m_budget, charged);
+    }
+}
+
+bool pjson::ValueBuilder::inObject() const
+{
+    // an object whose last member already got its value
+    return !m_stack.empty() && m_stack.back().object &&
+           !m_stack.back().memberOpen;
+}
+
+void pjson::ValueBuilder::add(Value&& value)
+{
+    if (m_stack.empty()) {
+        m_result = std::move(value);
+        return;
+    }
+    Frame& top = m_stack.back();
+    if (top.memberOpen) {
+        m_members.back().second = std::move(value);
+        top.memberOpen = false;
+    } else {
+        m_items.push_back(std::move(value));
+    }
+}
+
+void pjson::ValueBuilder::objectBeginImpl(const std::string& name)
+{
+    if (!inObject()) {
+        open(true, m_members.size());
+    }
+    charge(name.size());
+    m_members.emplace_back(name, Null{});
+    m_stack.back().memberOpen = true;
+}
+
+void pjson::ValueBuilder::objectEndImpl()
+{
+    if (!inObject()) {
+        add(Object{});
+        return;
+    }
+    const auto first = m_members.begin() + m_stack.back().start;
+    Object object(std::make_move_iterator(first),
+                  std::make_move_iterator(m_members.end()));
+    m_members.erase(first, m_members.end());
+    close(object.data());
+    add(std::move(object));
+}
+
+void pjson::ValueBuilder::arrayBeginImpl()
+{
+    open(false, m_items.size());
+}
+
+void pjson::ValueBuilder::arrayEndImpl()
+{
+    const auto first = m_items.begin() + m_stack.back().start;
+    Array array(std::make_move_iterator(first),
+                std::make_move_iterator(m_items.end()));
+    m_items.erase(first, m_items.end());
+    close(array.data());
+    add(std::move(array));
+}
+
+void pjson::ValueBuilder::nullValueImpl()
+{
+    add(Null{});
+}
+
+void pjson::ValueBuilder::boolValueImpl(bool v)
+{
+    add(v);
+}
+
+void pjson::ValueBuilder::integerValueImpl(int64_t v)
+{
+    add(v);
+}
+
+void pjson::ValueBuilder::doubleValueImpl(double v)
+{
+    add(v);
+}
+
+void pjson::ValueBuilder::stringValueImpl(const std::string& v)
+{
+    if (m_stack.empty()) {
+        details::checkString(v);
+    } else {
+        charge(v.size());
+    }
+    add(v);
+}
+
+void pjson::details::chargeStrings(Value& container)
+{
+    BudgetResource* const budget = currentBudget();
+    if (!budget) {
+        return;
+    }
+    std::size_t bytes = 0;
+    void* data = nullptr;
+    if (Array* const array = boost::get<Array>(&container.get())) {
+        for (const Value& item : *array) {
+            if (const auto v = boost::get<std::string>(&item.get())) {
+                bytes += stringBytes(v->size());
+            }
+        }
+        data = array->data();
+    } else if (Object* const object = boost::get<Object>(&container.get())) {
+        for (const NameValue& member : *object) {
+            bytes += stringBytes(member.first.size());
+            if (const auto v = boost::get<std::string>(&member.second.get())) {
+                bytes += stringBytes(v->size());
+            }
+        }
+        data = object->data();
+    }
+    if (bytes != 0) {
+        budget->charge(bytes);
+        attachCharge(data, budget, bytes);
+    }
+}
+
+void pjson::details::checkString(const std::string& v)
+{
+    if (BudgetResource* const budget = currentBudget()) {
+        const std::size_t bytes = stringBytes(v.size());
+        budget->charge(bytes);
+        budget->release(bytes);
+    }
+}
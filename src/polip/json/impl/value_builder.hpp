@@ -0,0 +1,90 @@
+#ifndef INCLUDE_POLIP_JSON_IMPL_VALUE_BUILDER_HPP
+#define INCLUDE_POLIP_JSON_IMPL_VALUE_BUILDER_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "polip/json/parser.hpp"
+#include "polip/json/value.hpp"
+
+namespace polip
+{
+namespace json
+{
+
+/*
+    Assembles a Value from parsing events, open containers are kept on an
+    explicit stack. Their items and members are collected on scratch
+    stacks shared by all of them, so each container is allocated once,
+    with its exact size, when its closing bracket is seen; the scratch
+    stacks stop growing once they hold the largest containers open at the
+    same time.
+
+    Strings are charged to the BudgetResource current when the outermost
+    container opens, as they are read, and the charge is handed over to
+    the block of their container when it closes.
+ */
+class ValueBuilder final : public DispatchTarget
+{
+public:
+    ValueBuilder() = default;
+    ~ValueBuilder();
+
+    ValueBuilder(const ValueBuilder&) = delete;
+    ValueBuilder& operator=(const ValueBuilder&) = delete;
+
+    Value& result()
+    {
+        return m_result;
+    }
+
+private:
+    struct Frame
+    {
+        bool object;
+        bool memberOpen;    // object member announced, its value not yet seen
+        std::size_t start;  // first item or member on the scratch stack
+        std::size_t charged;  // bytes of its strings charged to m_budget
+    };
+
+    void add(Value&& value);
+    bool inObject() const;
+    void open(bool object, std::size_t start);
+    // charges a string of the given length to the open container
+    void charge(std::size_t length);
+    void close(void* data);
+
+    void objectBeginImpl(const std::string& name) override;
+    void objectEndImpl() override;
+    void arrayBeginImpl() override;
+    void arrayEndImpl() override;
+    void nullValueImpl() override;
+    void boolValueImpl(bool v) override;
+    void integerValueImpl(int64_t v) override;
+    void doubleValueImpl(double v) override;
+    void stringValueImpl(const std::string& v) override;
+
+    std::vector<Frame> m_stack;
+    std::vector<Value> m_items;
+    std::vector<NameValue> m_members;
+    Value m_result;
+    BudgetResource* m_budget = nullptr;
+};
+
+namespace details
+{
+
+// charges the strings directly in an array or object to the current
+// BudgetResource and hands the charge over to its block, as ValueBuilder
+// does for the strings it reads
+void chargeStrings(Value& container);
+// a string outside of containers is not kept track of, only checked
+// against the limit of the current BudgetResource
+void checkString(const std::string& v);
+
+}  // namespace details
+
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_IMPL_VALUE_BUILDER_HPP
@@ -0,0 +1,253 @@
+#include <cerrno>
+#include <ostream>
+#include <stdexcept>
+#include <unistd.h>
+#include "polip/json/text.hpp"
+#include "polip/json/writer.hpp"
+
+namespace pjson = polip::json;
+
+namespace
+{
+
+class Emitter : public boost::static_visitor<void>
+{
+public:
+    explicit Emitter(pjson::DispatchTarget& target) : m_target(target)
+    {
+    }
+
+    void operator()(const pjson::Null&) const
+    {
+        m_target.nullValue();
+    }
+
+    void operator()(bool v) const
+    {
+        m_target.boolValue(v);
+    }
+
+    void operator()(int64_t v) const
+    {
+        m_target.integerValue(v);
+    }
+
+    void operator()(double v) const
+    {
+        m_target.doubleValue(v);
+    }
+
+    void operator()(const std::string& v) const
+    {
+        m_target.stringValue(v);
+    }
+
+    void operator()(const pjson::Array& array) const
+    {
+        m_target.arrayBegin();
+        for (auto const& item : array) {
+            boost::apply_visitor(*this, item);
+        }
+        m_target.arrayEnd();
+    }
+
+    void operator()(const pjson::Object& object) const
+    {
+        for (auto const& member : object) {
+            m_target.objectBegin(member.first);
+            boost::apply_visitor(*this, member.second);
+        }
+        m_target.objectEnd();
+    }
+
+private:
+    pjson::DispatchTarget& m_target;
+};
+
+}  // anonymous namespace
+
+void pjson::StringSink::write(const char* data, std::size_t size)
+{
+    m_out.append(data, size);
+}
+
+void pjson::StreamSink::write(const char* data, std::size_t size)
+{
+    if (!m_os.write(data, static_cast<std::streamsize>(size))) {
+        throw write_error{};
+    }
+}
+
+void pjson::FileSink::write(const char* data, std::size_t size)
+{
+    while (size > 0) {
+        const ssize_t written = ::write(m_fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw write_error{};
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+
+pjson::Writer::Writer(Sink& sink, const WriterOptions& options)
+    : m_sink(sink), m_options(options)
+{
+    m_buffer.reserve(options.flushThreshold);
+}
+
+pjson::Writer::~Writer()
+{
+    try {
+        flush();
+    } catch (...) {
+    }
+}
+
+void pjson::Writer::value(const Value& v)
+{
+    boost::apply_visitor(Emitter(*this), v);
+}
+
+void pjson::Writer::flush()
+{
+    if (!m_buffer.empty()) {
+        m_sink.write(m_buffer.data(), m_buffer.size());
+        m_buffer.clear();
+    }
+}
+
+bool pjson::Writer::inObject() const
+{
+    // an object whose last member already got its value
+    return !m_scopes.empty() && m_scopes.back().object &&
+           !m_scopes.back().memberOpen;
+}
+
+void pjson::Writer::beginValue()
+{
+    if (m_scopes.empty()) {
+        if (m_started) {
+            m_buffer += '\n';
+        }
+        m_started = true;
+        return;
+    }
+    Scope& top = m_scopes.back();
+    if (top.memberOpen) {
+        top.memberOpen = false;
+        return;
+    }
+    if (!top.empty) {
+        m_buffer += ',';
+    }
+    top.empty = false;
+    newLine(m_scopes.size());
+}
+
+void pjson::Writer::endValue()
+{
+    if (m_buffer.size() >= m_options.flushThreshold) {
+        flush();
+    }
+}
+
+void pjson::Writer::newLine(std::size_t level)
+{
+    if (m_options.indent != 0) {
+        m_buffer += '\n';
+        m_buffer.append(level * m_options.indent, ' ');
+    }
+}
+
+void pjson::Writer::objectBeginImpl(const std::string& name)
+{
+    if (!inObject()) {
+        beginValue();
+        m_buffer += '{';
+        m_scopes.push_back(Scope{true, true, false});
+    }
+    Scope& top = m_scopes.back();
+    if (!top.empty) {
+        m_buffer += ',';
+    }
+    top.empty = false;
+    top.memberOpen = true;
+    newLine(m_scopes.size());
+    appendString(m_buffer, name);
+    m_buffer += m_options.indent != 0 ? ": " : ":";
+}
+
+void pjson::Writer::objectEndImpl()
+{
+    // anywhere else but in an object with its last member complete it
+    // reports an empty object, so it cannot be out of place
+    if (!inObject()) {
+        beginValue();
+        m_buffer += "{}";
+    } else {
+        m_scopes.pop_back();
+        newLine(m_scopes.size());
+        m_buffer += '}';
+    }
+    endValue();
+}
+
+void pjson::Writer::arrayBeginImpl()
+{
+    beginValue();
+    m_buffer += '[';
+    m_scopes.push_back(Scope{false, true, false});
+}
+
+void pjson::Writer::arrayEndImpl()
+{
+    if (m_scopes.empty() || m_scopes.back().object) {
+        throw std::logic_error("arrayEnd() without an open array");
+    }
+    const bool empty = m_scopes.back().empty;
+    m_scopes.pop_back();
+    if (!empty) {
+        newLine(m_scopes.size());
+    }
+    m_buffer += ']';
+    endValue();
+}
+
+void pjson::Writer::nullValueImpl()
+{
+    beginValue();
+    m_buffer += "null";
+    endValue();
+}
+
+void pjson::Writer::boolValueImpl(bool v)
+{
+    beginValue();
+    m_buffer += v ? "true" : "false";
+    endValue();
+}
+
+void pjson::Writer::integerValueImpl(int64_t v)
+{
+    beginValue();
+    appendInteger(m_buffer, v);
+    endValue();
+}
+
+void pjson::Writer::doubleValueImpl(double v)
+{
+    beginValue();
+    appendDouble(m_buffer, v, m_options.nonFinite);
+    endValue();
+}
+
+void pjson::Writer::stringValueImpl(const std::string& v)
+{
+    beginValue();
+    appendString(m_buffer, v);
+    endValue();
+}
@@ -0,0 +1,79 @@
+#ifndef INCLUDE_POLIP_JSON_INCREMENTAL_HPP
+#define INCLUDE_POLIP_JSON_INCREMENTAL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "polip/json/error.hpp"
+#include "polip/json/parser.hpp"
+
+namespace polip
+{
+namespace json
+{
+
+/*
+    Push parser for a document that arrives in chunks. Every chunk is
+    parsed as far as it goes and the parser returns when it is exhausted,
+    so the caller can wait for the next one, e.g. by co_await in a
+    coroutine or from an event loop serving many connections:
+
+        IncrementalParser parser(target);
+        while (!parser.feed(chunk)) { chunk = next chunk }
+        parser.finish();
+
+    Chunks are not kept: only a string, number or literal that is cut by
+    the end of a chunk is copied until the rest of it arrives, so memory
+    use is bounded by the nesting and the largest token, not by the size
+    of the document. Skipped containers are passed over without copying
+    at all.
+
+    It accepts the same language as the iterative engine, checks the same
+    ParseLimits and reports the events described for DispatchTarget; a cut
+    string or number is not held beyond its limit, a chunk going beyond
+    maxDocumentBytes is refused as a whole. Errors are Error, with offsets
+    counted from the start of the document over all chunks; end is the
+    number of bytes fed so far. After an error the parser must not be
+    used any more.
+ */
+class IncrementalParser
+{
+public:
+    using Error = parse_error<std::size_t>;
+
+    // reports the events to target, which must outlive the parser
+    explicit IncrementalParser(DispatchTarget& target,
+                               const ParseOptions& options = ParseOptions{});
+    // builds the document, see value()
+    explicit IncrementalParser(const ParseOptions& options = ParseOptions{});
+    ~IncrementalParser();
+
+    IncrementalParser(const IncrementalParser&) = delete;
+    IncrementalParser& operator=(const IncrementalParser&) = delete;
+
+    // parses what the chunk completes, true once the document is complete;
+    // white space may still follow then, anything else is an error
+    bool feed(const char* begin, const char* end);
+    bool feed(const std::string& chunk);
+
+    // end of the input: completes a document that is a bare number and
+    // fails on an incomplete one
+    void finish();
+
+    bool done() const;
+
+    // bytes of an incomplete token held until the next chunk
+    std::size_t buffered() const;
+
+    // the document built by a parser without target, complete once done()
+    Value& value();
+
+private:
+    struct State;
+    std::unique_ptr<State> m_state;
+};
+
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_INCREMENTAL_HPP
@@ -0,0 +1,165 @@
+#ifndef INCLUDE_POLIP_JSON_MEMORY_HPP
+#define INCLUDE_POLIP_JSON_MEMORY_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <boost/container/pmr/memory_resource.hpp>
+
+namespace polip
+{
+namespace json
+{
+
+/*
+    Storage for the items of Arrays and the members of Objects. It is the
+    polymorphic resource of Boost.Container, with the same interface as
+    std::pmr::memory_resource, so pools and arenas written for either are
+    plugged in by deriving from it.
+
+    Containers do not hold a resource: each block remembers the resource
+    it came from and is given back to it whatever thread frees it, so
+    Values keep their size and move between resources freely. A block is
+    taken from the resource current on the allocating thread, see
+    ResourceScope, and a resource must outlive the containers allocated
+    from it. Strings, including member names, are std::string and always
+    use operator new; those that load() reads into a container are charged
+    to a BudgetResource, see there.
+ */
+using MemoryResource = boost::container::pmr::memory_resource;
+
+// the resource of the calling thread, nullptr for operator new
+MemoryResource* currentResource();
+
+/*
+    Makes resource the current one of the calling thread while it lives,
+    nullptr restores operator new. Scopes nest, the previous resource is
+    current again after the scope. load() opens one for
+    ParseOptions::resource; other code that builds or copies containers,
+    e.g. SharedValue::toValue() or Value::pushBack(), may be wrapped in
+    one to allocate from a resource as well.
+ */
+class ResourceScope
+{
+public:
+    explicit ResourceScope(MemoryResource* resource);
+    ~ResourceScope();
+
+    ResourceScope(const ResourceScope&) = delete;
+    ResourceScope& operator=(const ResourceScope&) = delete;
+
+private:
+    MemoryResource* m_previous;
+};
+
+/*
+    Accounts for the bytes allocated through it and throws
+    budget_exceeded instead of going beyond limit, e.g. to bound the
+    memory of the documents of one tenant. The blocks are taken from
+    upstream, operator new if nullptr. It may be shared by threads.
+
+    The heap bytes of strings that load() puts into an array or object,
+    member names included, are charged to it as well while that container
+    holds them, i.e. until it is freed or grows into a new block.
+ */
+class BudgetResource final : public MemoryResource
+{
+public:
+    explicit BudgetResource(std::size_t limit,
+                            MemoryResource* upstream = nullptr);
+
+    std::size_t limit() const
+    {
+        return m_limit;
+    }
+
+    // bytes allocated and not freed yet
+    std::size_t used() const
+    {
+        return m_used;
+    }
+
+    // the most bytes used at the same time
+    std::size_t peak() const
+    {
+        return m_peak;
+    }
+
+    // accounts for bytes allocated elsewhere, charge() throws
+    // budget_exceeded instead of going beyond limit
+    void charge(std::size_t bytes);
+    void release(std::size_t bytes) noexcept;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes,
+                       std::size_t alignment) override;
+    bool do_is_equal(const MemoryResource& other) const noexcept override;
+
+    const std::size_t m_limit;
+    MemoryResource* const m_upstream;
+    std::atomic<std::size_t> m_used{0};
+    std::atomic<std::size_t> m_peak{0};
+};
+
+namespace details
+{
+
+// from the current resource, the block is tagged with it
+void* allocate(std::size_t bytes);
+// to the resource the block was allocated from
+void deallocate(void* p, std::size_t bytes) noexcept;
+
+// the current resource if it is a BudgetResource
+BudgetResource* currentBudget();
+// heap bytes of a string of the given length, 0 for one kept inline
+std::size_t stringBytes(std::size_t length);
+// hands bytes charged to budget over to the block of p, which releases
+// them when deallocated; they are released at once if the block is not
+// from budget
+void attachCharge(void* p, BudgetResource* budget, std::size_t bytes) noexcept;
+
+// allocator of Array and Object, all of them are interchangeable
+template <typename T>
+struct Allocator
+{
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    Allocator() = default;
+
+    template <typename U>
+    Allocator(const Allocator<U>&)
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(details::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        details::deallocate(p, n * sizeof(T));
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const Allocator<T>&, const Allocator<U>&)
+{
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const Allocator<T>&, const Allocator<U>&)
+{
+    return false;
+}
+
+}  // namespace details
+
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_MEMORY_HPP
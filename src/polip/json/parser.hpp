@@ -1,7 +1,10 @@
 #ifndef INCLUDE_POLIP_JSON_PARSER_HPP
 #define INCLUDE_POLIP_JSON_PARSER_HPP
 
+#include <cstddef>
 #include <string>
+#include <type_traits>
+#include "polip/json/memory.hpp"
 #include "polip/json/value.hpp"
 
 namespace polip
@@ -15,8 +18,132 @@ enum class Conformance
     Strict      // RFC 4627 compliant
 };
 
+enum class Engine
+{
+    Recursive,  // Spirit grammar, nesting bounded by maxDepth
+    Iterative   // explicit heap stack, C++ stack use independent of nesting
+};
+
+const std::size_t defaultMaxDepth = 128;
+const std::size_t noLimit = static_cast<std::size_t>(-1);
+
+/*
+    Bounds on untrusted input, each reported as its own DiagError where
+    the offending token starts. They are checked as the input is scanned,
+    so a document is rejected before more than about a limit's worth of
+    it has been read or built. Values inside skipped containers or
+    members are not counted. Only the iterative engine checks them, a
+    Recursive load() with any limit set runs it instead.
+ */
+struct ParseLimits
+{
+    // bytes of the whole input, DocumentTooLarge at the first byte beyond
+    std::size_t maxDocumentBytes = noLimit;
+    // chars of a string or member name once unescaped, StringTooLong
+    std::size_t maxStringLength = noLimit;
+    // items of an array or members of an object, TooManyElements
+    std::size_t maxContainerElements = noLimit;
+    // values in the document, containers included, TooManyNodes
+    std::size_t maxNodes = noLimit;
+    // chars of a number, sign, point and exponent included, NumberTooLong
+    std::size_t maxNumberLength = noLimit;
+
+    bool any() const
+    {
+        return maxDocumentBytes != noLimit || maxStringLength != noLimit ||
+               maxContainerElements != noLimit || maxNodes != noLimit ||
+               maxNumberLength != noLimit;
+    }
+};
+
+struct ParseOptions
+{
+    Conformance level = Conformance::Relaxed;
+    Engine engine = Engine::Recursive;
+    // max number of nested arrays/objects, DiagError::MaxDepthExceeded
+    // is reported beyond it; the default keeps the recursive engine well
+    // within 256 KB thread stacks
+    std::size_t maxDepth = defaultMaxDepth;
+    // arrays and objects of the loaded Value are allocated from it and
+    // its strings charged to it if it is a BudgetResource, nullptr keeps
+    // the current resource, see ResourceScope; an exception
+    // of the resource, e.g. budget_exceeded, is passed on by load() after
+    // all that was allocated has been freed
+    MemoryResource* resource = nullptr;
+    ParseLimits limits;
+};
+
 Value load(const std::string& jsonDoc, Conformance level = Conformance::Relaxed);
+Value load(const std::string& jsonDoc, const ParseOptions& options);
+
+// contiguous input without copying it, errors are parse_error<const char*>
+Value load(const char* begin, const char* end,
+           const ParseOptions& options = ParseOptions{});
+
+/*
+    Input from any forward iterator over chars, errors are
+    parse_error<Iterator>. The library is compiled for two iterators,
+    const char* (the overload above) and std::string::const_iterator; the
+    parsers for other iterators are instantiated from
+    polip/json/parser_templates.hpp, which has to be included where they
+    are used.
+ */
+template <typename Iterator, typename = typename std::enable_if<
+                                 !std::is_pointer<Iterator>::value>::type>
+Value load(Iterator begin, Iterator end,
+           const ParseOptions& options = ParseOptions{});
+
+namespace details
+{
+
+template <typename Range>
+struct IsText : std::is_convertible<const Range&, std::string>
+{
+};
+
+template <typename Range>
+auto loadRange(const Range& range, const ParseOptions& options, int)
+    -> decltype(static_cast<const char*>(range.data()), Value())
+{
+    const char* const data = range.data();
+    return load(data, data + range.size(), options);
+}
+
+template <typename Range>
+Value loadRange(const Range& range, const ParseOptions& options, long)
+{
+    return load(range.begin(), range.end(), options);
+}
+
+}  // namespace details
+
+/*
+    Ranges of chars such as std::vector<char> or boost::string_ref. Those
+    with contiguous data() are read through const char*, others through
+    their iterators as above.
+ */
+template <typename Range, typename = typename std::enable_if<
+                              !details::IsText<Range>::value>::type>
+Value load(const Range& range, const ParseOptions& options = ParseOptions{})
+{
+    return details::loadRange(range, options, 0);
+}
+
+/*
+    Parsing events. Every object member is announced by objectBegin() with
+    the member name and followed by the events of its value, objectEnd()
+    closes the object. An object without members is reported by objectEnd()
+    alone, e.g. {"a": {}, "b": [1]} is reported as:
+        objectBegin("a") objectEnd() objectBegin("b") arrayBegin()
+        integerValue(1) arrayEnd() objectEnd()
 
+    A target may ask for values it does not need to be skipped, they are
+    then passed over without unescaping strings or converting numbers,
+    see Scanner::skipValue(). skipMember() is asked before a member is
+    announced, a skipped member is not reported at all. skipArray() and
+    skipObject() are asked when a container value starts, a skipped one
+    is reported as empty. Nothing is skipped by default.
+ */
 class DispatchTarget
 {
 public:
@@ -32,6 +159,10 @@ public:
     void doubleValue(double v) { doubleValueImpl(v); }
     void stringValue(const std::string& v) { stringValueImpl(v); }
 
+    bool skipMember(const std::string& name) { return skipMemberImpl(name); }
+    bool skipArray() { return skipArrayImpl(); }
+    bool skipObject() { return skipObjectImpl(); }
+
 private:
     virtual void objectBeginImpl(const std::string& name) = 0;
     virtual void objectEndImpl() = 0;
@@ -42,9 +173,58 @@ private:
     virtual void integerValueImpl(int64_t v) = 0;
     virtual void doubleValueImpl(double v) = 0;
     virtual void stringValueImpl(const std::string& v) = 0;
+
+    virtual bool skipMemberImpl(const std::string&) { return false; }
+    virtual bool skipArrayImpl() { return false; }
+    virtual bool skipObjectImpl() { return false; }
 };
 
+// always runs the iterative engine, options.engine is not consulted
 void parse(const std::string& jsonDoc, DispatchTarget& builder);
+void parse(const std::string& jsonDoc, DispatchTarget& builder,
+           const ParseOptions& options);
+// other inputs as for load()
+void parse(const char* begin, const char* end, DispatchTarget& builder,
+           const ParseOptions& options = ParseOptions{});
+template <typename Iterator, typename = typename std::enable_if<
+                                 !std::is_pointer<Iterator>::value>::type>
+void parse(Iterator begin, Iterator end, DispatchTarget& builder,
+           const ParseOptions& options = ParseOptions{});
+
+namespace details
+{
+
+template <typename Range>
+auto parseRange(const Range& range, DispatchTarget& builder,
+                const ParseOptions& options, int)
+    -> decltype(static_cast<const char*>(range.data()), void())
+{
+    const char* const data = range.data();
+    parse(data, data + range.size(), builder, options);
+}
+
+template <typename Range>
+void parseRange(const Range& range, DispatchTarget& builder,
+                const ParseOptions& options, long)
+{
+    parse(range.begin(), range.end(), builder, options);
+}
+
+}  // namespace details
+
+template <typename Range, typename = typename std::enable_if<
+                              !details::IsText<Range>::value>::type>
+void parse(const Range& range, DispatchTarget& builder,
+           const ParseOptions& options = ParseOptions{})
+{
+    details::parseRange(range, builder, options, 0);
+}
+
+extern template Value load(std::string::const_iterator,
+                           std::string::const_iterator, const ParseOptions&);
+extern template void parse(std::string::const_iterator,
+                           std::string::const_iterator, DispatchTarget&,
+                           const ParseOptions&);
 
 
 }} // namespace polip::json
@@ -0,0 +1,74 @@
+#ifndef INCLUDE_POLIP_JSON_PARSER_TEMPLATES_HPP
+#define INCLUDE_POLIP_JSON_PARSER_TEMPLATES_HPP
+
+#include "polip/json/parser.hpp"
+#include "polip/json/impl/grammar.hpp"
+#include "polip/json/impl/parser_instances.hpp"
+#include "polip/json/impl/stack_parser.hpp"
+#include "polip/json/impl/value_builder.hpp"
+
+// Definitions of the parsers over arbitrary iterators, see parser.hpp.
+// Including this header compiles both grammars for every new iterator,
+// those for the iterators the library supports are declared extern.
+
+namespace polip
+{
+namespace json
+{
+namespace details
+{
+
+template <typename Iterator, typename Policy>
+Value loadRecursive(Iterator begin, Iterator end, std::size_t maxDepth)
+{
+    // rules are immutable once built and carry no per-parse state, so a
+    // single grammar instance per conformance level is shared by all calls
+    static const ExtendedGrammar<Iterator, Policy> parser;
+    Iterator it = begin;
+    Value value;
+    ContainerScratch scratch;
+    bool success = false;
+    try {
+        success = qi::phrase_parse(it, end, parser(maxDepth, &scratch),
+                                   SkipperOf<Policy>(), value);
+    } catch (const parse_error<Iterator>& e) {
+        // the error handlers only see the input of the failed rule
+        throw parse_error<Iterator>{e.issue, begin, end, e.where, e.info};
+    }
+    if (success && it == end) {
+        if (const auto v = boost::get<std::string>(&value.get())) {
+            checkString(*v);
+        }
+        return value;
+    }
+    throw parse_error<Iterator>{DiagError::Other, begin, end, it, ""};
+}
+
+template <typename Iterator, typename Policy, typename Target>
+void parseIterative(Iterator begin, Iterator end, Target& target,
+                    const ParseOptions& options)
+{
+    StackParser<Iterator, Policy> parser(begin, end, options.maxDepth,
+                                         options.limits);
+    parser.parse(target);
+}
+
+template <typename Iterator, typename Policy>
+Value loadAs(Iterator begin, Iterator end, const ParseOptions& options)
+{
+    const ResourceScope scope(options.resource ? options.resource
+                                               : currentResource());
+    // the grammar does not check ParseLimits
+    if (options.engine == Engine::Recursive && !options.limits.any()) {
+        return loadRecursive<Iterator, Policy>(begin, end, options.maxDepth);
+    }
+    ValueBuilder builder;
+    parseIterative<Iterator, Policy>(begin, end, builder, options);
+    return std::move(builder.result());
+}
+
+}  // namespace details
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_PARSER_TEMPLATES_HPP
@@ -0,0 +1,41 @@
+#ifndef INCLUDE_POLIP_JSON_PATCH_HPP
+#define INCLUDE_POLIP_JSON_PATCH_HPP
+
+#include <string>
+#include "polip/json/value.hpp"
+
+namespace polip
+{
+namespace json
+{
+
+/*
+    JSON Pointer (RFC 6901) lookup, nullptr if nothing is found there.
+    Throws invalid_pointer if the pointer is malformed. Of members sharing
+    a name the first one is found.
+ */
+const Value* resolve(const Value& document, const std::string& pointer);
+
+/*
+    JSON Patch (RFC 6902). diff() returns the patch, an Array of operation
+    objects, that turns from into to. Object members are compared by name.
+    Arrays are compared after trimming their common prefix and suffix, and
+    the rest is matched by longest common subsequence. When that rest is
+    too large for the quadratic match, it is compared position by
+    position. Appending to or removing from the end of a large array thus
+    produces operations for the changed items only.
+
+    apply_patch() changes the document in place, unchanged subtrees are not
+    copied and moved values are not copied either. A failing "test"
+    throws patch_test_failed, a malformed patch or a path that cannot be
+    applied throws invalid_patch (invalid_pointer for malformed paths).
+    Operations are applied one by one, and a failure leaves the effect of
+    the preceding ones in place.
+ */
+Value diff(const Value& from, const Value& to);
+void apply_patch(Value& document, const Value& patch);
+
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_PATCH_HPP
@@ -0,0 +1,126 @@
+#ifndef INCLUDE_POLIP_JSON_READER_HPP
+#define INCLUDE_POLIP_JSON_READER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "polip/json/error.hpp"
+#include "polip/json/parser.hpp"
+
+namespace polip
+{
+namespace json
+{
+
+/*
+    Pull reader: the caller asks for the value it expects next, nothing is
+    materialized on the way. Values of an unexpected type are reported as
+    parse_error<const char*> with the DiagError of the requested type
+    (Null, Int, Double, String, Array, Object, or Value for bool).
+
+    Arrays are read as
+        in.arrayBegin();
+        while (in.arrayNext()) { read one item }
+    and objects as
+        in.objectBegin();
+        while (in.objectNext()) { in.memberName(); read one value }
+    The input is not owned and must outlive the reader.
+
+    ParseLimits are checked as by the iterative parser and reported with
+    the same DiagErrors at the same places. What skipValue() passes over
+    is neither counted nor measured, as for skipped members there.
+ */
+template <Conformance Level>
+class BasicReader
+{
+public:
+    using Error = parse_error<const char*>;
+
+    enum class Token
+    {
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object,
+        End,
+        Invalid
+    };
+
+    BasicReader(const char* begin, const char* end,
+                std::size_t maxDepth = defaultMaxDepth,
+                const ParseLimits& limits = ParseLimits{});
+
+    // kind of the next value, without consuming it
+    Token peek();
+
+    void readNull();
+    bool readBool();
+    int64_t readInteger();
+    // non-negative integers up to the maximum of uint64_t, Int otherwise
+    uint64_t readUnsigned();
+    // integers are accepted as well
+    double readDouble();
+    // valid until the next read
+    const std::string& readString();
+
+    void arrayBegin();
+    bool arrayNext();
+
+    void objectBegin();
+    bool objectNext();
+
+    // name read by the last successful objectNext(), valid until the next
+    // read
+    const std::string& memberName() const
+    {
+        return m_text;
+    }
+
+    // skips the next value, nesting is walked without recursion
+    void skipValue();
+
+    // checks that only white space follows the document
+    void finish();
+
+    [[noreturn]] void fail(DiagError issue) const;
+
+private:
+    void skipSpace();
+    void enter(DiagError issue, char bracket);
+    bool next(char close, DiagError issue);
+    void leave();
+    // a value starts at the current position
+    void countValue();
+    void countElement();
+    // maxNumberLength unless skipping
+    std::size_t numberLimit() const;
+
+    const char* m_begin;
+    const char* m_end;
+    const char* m_it;
+    std::size_t m_depth = 0;
+    std::size_t m_maxDepth;
+    bool m_first = false;  // container opened, no item read yet
+    std::string m_text;
+    ParseLimits m_limits;
+    bool m_skipping = false;  // in skipValue(), nothing is counted
+    std::size_t m_nodes = 0;
+    // items or members of the innermost container, those of the
+    // enclosing ones
+    std::size_t m_elements = 0;
+    std::vector<std::size_t> m_counts;
+};
+
+using Reader = BasicReader<Conformance::Relaxed>;
+using StrictReader = BasicReader<Conformance::Strict>;
+
+extern template class BasicReader<Conformance::Relaxed>;
+extern template class BasicReader<Conformance::Strict>;
+
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_READER_HPP
@@ -0,0 +1,82 @@
+#ifndef INCLUDE_POLIP_JSON_SCHEMA_HPP
+#define INCLUDE_POLIP_JSON_SCHEMA_HPP
+
+#include <memory>
+#include <string>
+#include "polip/json/parser.hpp"
+#include "polip/json/value.hpp"
+
+namespace polip
+{
+namespace json
+{
+
+/*
+    JSON Schema subset, compiled once into a table of nodes:
+        true, false
+        type            string or array of "null", "boolean", "integer",
+                        "number", "string", "array", "object"
+        enum            of scalars only
+        minimum, maximum, exclusiveMinimum, exclusiveMaximum (numbers)
+        minLength, maxLength    in code points
+        items           a single schema for all array items
+        minItems, maxItems
+        properties, required, additionalProperties (bool or schema)
+    Annotations ($schema, $id, title, description, default, examples) are
+    ignored, any other keyword throws invalid_schema rather than being
+    silently skipped.
+
+    Documents are checked while being parsed, the first violation throws
+    schema_violation and ends parsing.
+ */
+class Schema
+{
+public:
+    explicit Schema(const Value& schema);
+
+    // throws schema_violation, or the parse_error of parse()
+    void validate(const std::string& jsonDoc,
+                  const ParseOptions& options = ParseOptions{}) const;
+
+    // validates and builds the document in a single pass
+    Value load(const std::string& jsonDoc,
+               const ParseOptions& options = ParseOptions{}) const;
+
+private:
+    friend class SchemaValidator;
+
+    struct Nodes;
+
+    std::shared_ptr<const Nodes> m_nodes;
+};
+
+// Checks parsing events against a schema, optionally passing them on to
+// another target. A validator checks one document.
+class SchemaValidator final : public DispatchTarget
+{
+public:
+    explicit SchemaValidator(const Schema& schema,
+                             DispatchTarget* next = nullptr);
+    ~SchemaValidator();
+
+private:
+    struct State;
+
+    void objectBeginImpl(const std::string& name) override;
+    void objectEndImpl() override;
+    void arrayBeginImpl() override;
+    void arrayEndImpl() override;
+    void nullValueImpl() override;
+    void boolValueImpl(bool v) override;
+    void integerValueImpl(int64_t v) override;
+    void doubleValueImpl(double v) override;
+    void stringValueImpl(const std::string& v) override;
+
+    std::unique_ptr<State> m_state;
+    DispatchTarget* m_next;
+};
+
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_SCHEMA_HPP
@@ -0,0 +1,132 @@
+#ifndef INCLUDE_POLIP_JSON_SHARED_HPP
+#define INCLUDE_POLIP_JSON_SHARED_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "polip/json/value.hpp"
+
+namespace polip
+{
+namespace json
+{
+
+namespace details
+{
+
+struct SharedNode;
+
+}  // namespace details
+
+/*
+    Immutable document whose subtrees are shared by reference counting.
+    Copying a SharedValue or handing out one of its items or members is
+    O(1), and an update returns a new document that copies only the
+    containers along the modified path, the rest stays shared with the
+    original. The reference counts are atomic and nothing is ever changed
+    in place, so any number of threads may read and copy the same document
+    without locking. A single SharedValue object is not to be assigned to
+    while other threads read it, as with std::shared_ptr.
+
+    Scalars are read with the Value accessors, as<T>() throws the same
+    not_* errors. Containers are read by index, arrays yield their items
+    and objects their members in order.
+ */
+class SharedValue
+{
+public:
+    // null
+    SharedValue() = default;
+
+    SharedValue(const Value& value);
+    SharedValue(Value&& value);
+
+    // scalars and containers a Value can be made of
+    template <typename T, typename D = typename std::decay<T>::type,
+              typename = typename std::enable_if<
+                  !std::is_base_of<Value, D>::value &&
+                  !std::is_same<SharedValue, D>::value>::type>
+    SharedValue(T&& v) : SharedValue(Value(std::forward<T>(v)))
+    {
+    }
+
+    // deep copy into a mutable Value
+    Value toValue() const;
+
+    bool isArray() const;
+    bool isObject() const;
+
+    template <typename T>
+    const T& as() const;
+
+    // the following throw not_array for scalars
+
+    // items of an array or members of an object
+    std::size_t size() const;
+    // value of the item or member, std::out_of_range past the end
+    const SharedValue& at(std::size_t index) const;
+
+    // the following throw not_object for other types
+
+    // name of a member, std::out_of_range past the end
+    const std::string& name(std::size_t index) const;
+    // first member of the name, nullptr if there is none
+    const SharedValue* find(const std::string& name) const;
+
+    // updates, the document itself stays unchanged
+
+    // not_array for other types, std::out_of_range past the end
+    SharedValue withItem(std::size_t index, SharedValue item) const;
+    SharedValue withAppended(SharedValue item) const;
+
+    // replaces the first member of the name or appends a new member,
+    // not_object for other types
+    SharedValue withMember(const std::string& name, SharedValue value) const;
+    // removes all members of the name, not_object for other types
+    SharedValue withoutMember(const std::string& name) const;
+
+    // replaces the value at a JSON Pointer, the empty pointer replaces the
+    // whole document. A missing member is added, "-" appends to an array.
+    // Throws invalid_pointer if the pointer is malformed or its parent
+    // does not exist.
+    SharedValue withValueAt(const std::string& pointer,
+                            SharedValue value) const;
+
+    // true if both refer to the same node, which implies equality
+    bool sameAs(const SharedValue& other) const
+    {
+        return m_node == other.m_node;
+    }
+
+private:
+    friend bool operator==(const SharedValue& lhs, const SharedValue& rhs);
+
+    explicit SharedValue(std::shared_ptr<details::SharedNode> node);
+
+    const details::SharedNode& node() const;
+    // nullptr for containers
+    const Value* scalar() const;
+
+    // nullptr for null
+    std::shared_ptr<const details::SharedNode> m_node;
+};
+
+template <typename T>
+const T& SharedValue::as() const
+{
+    const Value* const v = scalar();
+    if (v == nullptr) {
+        throw typename details::UnexpectedType<T>::error{};
+    }
+    return v->as<T>();
+}
+
+bool operator==(const SharedValue& lhs, const SharedValue& rhs);
+bool operator!=(const SharedValue& lhs, const SharedValue& rhs);
+
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_SHARED_HPP
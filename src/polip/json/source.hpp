@@ -0,0 +1,111 @@
+#ifndef INCLUDE_POLIP_JSON_SOURCE_HPP
+#define INCLUDE_POLIP_JSON_SOURCE_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "polip/json/error.hpp"
+#include "polip/json/parser.hpp"
+#include "polip/json/value.hpp"
+
+namespace polip
+{
+namespace json
+{
+
+// both counted from 1, the column in bytes
+struct Location
+{
+    std::size_t line;
+    std::size_t column;
+};
+
+/*
+    Finds the line and column of byte offsets in a text without rescanning
+    it for every lookup. Line starts are collected on demand, only as far
+    as the largest offset asked for, after that a lookup is a binary
+    search. The text is not owned and must outlive the index; lookups
+    extend the index, so they must not run concurrently.
+ */
+class LineIndex
+{
+public:
+    LineIndex(const char* begin, const char* end) : m_begin(begin), m_end(end)
+    {
+    }
+
+    explicit LineIndex(const std::string& text)
+        : LineIndex(text.data(), text.data() + text.size())
+    {
+    }
+
+    // offsets past the end of the text are located at its end
+    Location locate(std::size_t offset) const;
+
+    // where the error of parsing this text was found
+    template <typename Iterator>
+    Location locate(const parse_error<Iterator>& e) const
+    {
+        return locate(
+            static_cast<std::size_t>(std::distance(e.begin, e.where)));
+    }
+
+private:
+    // collects the newlines before offset
+    void scan(std::size_t offset) const;
+
+    const char* m_begin;
+    const char* m_end;
+    mutable std::vector<std::size_t> m_newlines;
+    mutable std::size_t m_scanned = 0;
+};
+
+/*
+    Byte offsets in the text of the values loaded by load() with a
+    SourceMap, down to the selected depth: 0 for the document only, 1
+    for its items or member values as well, and so on. Values are looked
+    up by address, so the Value has to stay where load() put it and must
+    not be modified. Together with a LineIndex this answers where a value
+    came from.
+ */
+class SourceMap
+{
+public:
+    static const std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    explicit SourceMap(std::size_t maxDepth = npos) : m_maxDepth(maxDepth)
+    {
+    }
+
+    std::size_t maxDepth() const
+    {
+        return m_maxDepth;
+    }
+
+    // offset of the first char of the value, npos for values that are
+    // not from the last load
+    std::size_t offset(const Value& value) const;
+
+    // replaces the offsets by those of values, visited in document order
+    // down to maxDepth()
+    void assign(const Value& value, const std::vector<std::size_t>& offsets);
+
+private:
+    std::size_t m_maxDepth;
+    std::unordered_map<const Value*, std::size_t> m_offsets;
+};
+
+// loads into value and records where its values are in the text, always
+// runs the iterative engine as parse()
+void load(const char* begin, const char* end, Value& value,
+          SourceMap& sources, const ParseOptions& options = ParseOptions{});
+void load(const std::string& jsonDoc, Value& value, SourceMap& sources,
+          const ParseOptions& options = ParseOptions{});
+
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_SOURCE_HPP
@@ -0,0 +1,131 @@
+#ifndef INCLUDE_POLIP_JSON_TABLE_HPP
+#define INCLUDE_POLIP_JSON_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <boost/optional.hpp>
+#include "polip/json/parser.hpp"
+#include "polip/json/value.hpp"
+
+namespace polip
+{
+namespace json
+{
+
+/*
+    Values of one member across all rows of a Table. When all of them
+    have the same scalar type they are stored in a vector of that type,
+    otherwise as Values. The typed accessors throw the not_* error of
+    their type for columns of another type.
+ */
+class Column
+{
+public:
+    enum class Type : char
+    {
+        Null,
+        Bool,
+        Int,
+        Double,
+        String,
+        Mixed
+    };
+
+    explicit Column(std::string name) : m_name(std::move(name))
+    {
+    }
+
+    const std::string& name() const
+    {
+        return m_name;
+    }
+
+    Type type() const
+    {
+        return m_type;
+    }
+
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    const std::vector<char>& bools() const;
+    const std::vector<int64_t>& integers() const;
+    const std::vector<double>& doubles() const;
+    const std::vector<std::string>& strings() const;
+    // Type::Mixed only, error for the other types
+    const std::vector<Value>& values() const;
+
+    // std::out_of_range past the last row
+    Value at(std::size_t row) const;
+
+    void pushBack(Value value);
+
+private:
+    // turns the typed storage into values
+    void mix();
+
+    std::string m_name;
+    Type m_type = Type::Null;
+    std::size_t m_size = 0;
+    std::vector<char> m_bools;
+    std::vector<int64_t> m_integers;
+    std::vector<double> m_doubles;
+    std::vector<std::string> m_strings;
+    std::vector<Value> m_values;
+};
+
+/*
+    Columnar form of an array of objects that all have the same member
+    names, each name appearing once, e.g. a table export. Member order
+    may differ between the objects, rows present their members in the
+    order of the first one. A scan over a single member reads one
+    contiguous column instead of visiting every object.
+
+    load() and fromValue() return none for documents of another shape;
+    load() builds the columns straight from parsing events, so the
+    document never exists as a Value.
+ */
+class Table
+{
+public:
+    static boost::optional<Table> load(
+        const std::string& jsonDoc,
+        const ParseOptions& options = ParseOptions{});
+    static boost::optional<Table> fromValue(const Value& value);
+
+    std::size_t rows() const
+    {
+        return m_rows;
+    }
+
+    const std::vector<Column>& columns() const
+    {
+        return m_columns;
+    }
+
+    // nullptr if there is no such member
+    const Column* column(const std::string& name) const;
+
+    // the object of a row, its members in the order of the first row;
+    // std::out_of_range past the last row
+    Value row(std::size_t index) const;
+    // the whole array
+    Value toValue() const;
+
+private:
+    Table(std::vector<Column>&& columns, std::size_t rows);
+
+    std::size_t m_rows = 0;
+    std::vector<Column> m_columns;
+    std::unordered_map<std::string, std::size_t> m_index;
+};
+
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_TABLE_HPP
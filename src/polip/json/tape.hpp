@@ -0,0 +1,365 @@
+#ifndef INCLUDE_POLIP_JSON_TAPE_HPP
+#define INCLUDE_POLIP_JSON_TAPE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <boost/utility/string_view.hpp>
+#include "polip/json/parser.hpp"
+#include "polip/json/value.hpp"
+
+namespace polip
+{
+namespace json
+{
+
+/*
+    Flat representation of a parsed document: a sequence of tagged 64-bit
+    words plus a string area. The top 8 bits of a word are the tag, the
+    remaining 56 bits the payload:
+        'n' 't' 'f'     null, true, false
+        'l' 'd'         int64_t, double, the raw value is in the next word
+        's'             string, payload is its offset in the string area
+                        where it is stored as uint32_t length + bytes
+        '[' '{'         container begin, payload is the index of the word
+                        following the matching end (low 32 bits) and the
+                        number of items or members (high 24 bits,
+                        saturated)
+        ']' '}'         container end, payload is the index of the begin
+    Object members are stored as a key string word followed by the value.
+    A subtree is skipped in O(1), so iteration never descends into
+    elements it passes over.
+
+    Strings longer than 4 GiB and tapes of 2^32 words or more do not fit
+    these fields, load() throws std::length_error for them.
+
+    A tape saved to a file can be mapped back without deserialization. The
+    words of a mapped file are checked in one pass, so a corrupted file
+    throws invalid_tape instead of sending navigation outside of it. The
+    file also records which KeyTable its keys were interned with.
+ */
+class TapeValue;
+
+// an object key interned by a KeyTable, valid as long as the table
+struct TapeKey
+{
+    static const std::uint64_t npos = ~std::uint64_t{0};
+
+    bool valid() const
+    {
+        return offset != npos;
+    }
+
+    // of the key in the string area
+    std::uint64_t offset = npos;
+    // fingerprint of the table the key comes from
+    std::uint64_t table = 0;
+    boost::string_view name;
+};
+
+/*
+    Object keys shared by tapes. Tapes loaded with a table store each key
+    once: keys of the table come first in their string area, at the same
+    offsets in all of them, and the other keys are deduplicated per tape.
+    A key looked up in the table then finds members by comparing words
+    instead of strings. Tapes remember a fingerprint of the table they
+    were loaded with, in saved files too, so a key of another table is
+    compared by name instead. The table is immutable, so it may be shared by
+    threads loading tapes concurrently. Interning is a Tape feature only,
+    object members of a Value loaded by load() keep their own names.
+ */
+class KeyTable
+{
+public:
+    KeyTable() = default;
+    explicit KeyTable(const std::vector<std::string>& keys);
+
+    // invalid if the key is not in the table
+    TapeKey find(boost::string_view name) const;
+
+private:
+    friend class Tape;
+
+    // string area prefix of the tapes
+    std::string m_strings;
+    std::unordered_map<std::string, std::uint64_t> m_offsets;
+    // of m_strings, 0 for an empty table
+    std::uint64_t m_fingerprint = 0;
+};
+
+class Tape
+{
+public:
+    static Tape load(const std::string& jsonDoc,
+                     const ParseOptions& options = ParseOptions{});
+    // interns object keys, an empty table deduplicates them per tape
+    static Tape load(const std::string& jsonDoc, const ParseOptions& options,
+                     const KeyTable& keys);
+    static Tape map(const std::string& path);
+
+    void save(const std::string& path) const;
+
+    TapeValue root() const;
+
+    const std::uint64_t* words() const
+    {
+        return m_words;
+    }
+
+    std::size_t size() const
+    {
+        return m_wordCount;
+    }
+
+    const char* strings() const
+    {
+        return m_strings;
+    }
+
+    std::size_t stringBytes() const
+    {
+        return m_stringBytes;
+    }
+
+    // fingerprint of the KeyTable the keys were interned with, 0 for none
+    std::uint64_t keyTable() const
+    {
+        return m_keyTable;
+    }
+
+private:
+    struct Storage;
+
+    Tape() = default;
+
+    static Tape adopt(std::vector<std::uint64_t>& words, std::string& strings,
+                      const KeyTable* keys = nullptr);
+
+    std::shared_ptr<const Storage> m_storage;
+    const std::uint64_t* m_words = nullptr;
+    std::size_t m_wordCount = 0;
+    const char* m_strings = nullptr;
+    std::size_t m_stringBytes = 0;
+    std::uint64_t m_keyTable = 0;
+    // of the table prefix in the string area
+    std::size_t m_keyBytes = 0;
+};
+
+class TapeValue
+{
+public:
+    enum class Type : char
+    {
+        Null = 'n',
+        True = 't',
+        False = 'f',
+        Int = 'l',
+        Double = 'd',
+        String = 's',
+        Array = '[',
+        Object = '{'
+    };
+
+    class array_iterator;
+    class object_iterator;
+
+    // views stay valid as long as any Tape sharing the storage exists
+    TapeValue(const Tape& tape, std::size_t index)
+        : m_words(tape.words()), m_strings(tape.strings()),
+          m_keyTable(tape.keyTable()), m_index(index)
+    {
+    }
+
+    Type type() const
+    {
+        return static_cast<Type>(tag());
+    }
+
+    // Null, bool, int64_t, double, std::string and boost::string_view,
+    // the latter pointing into the tape
+    template <typename T>
+    T as() const;
+
+    // number of array items or object members
+    std::size_t size() const;
+
+    array_iterator arrayBegin() const;
+    array_iterator arrayEnd() const;
+
+    object_iterator objectBegin() const;
+    object_iterator objectEnd() const;
+
+    // first member of the given name or objectEnd()
+    object_iterator find(boost::string_view name) const;
+    // the same, without comparing strings for a tape loaded with the
+    // table the key comes from
+    object_iterator find(TapeKey key) const;
+
+    Value toValue() const;
+
+private:
+    friend class array_iterator;
+    friend class object_iterator;
+
+    char tag() const
+    {
+        return static_cast<char>(word() >> 56);
+    }
+
+    std::uint64_t word() const
+    {
+        return m_words[m_index];
+    }
+
+    std::uint64_t payload() const
+    {
+        return word() & ((std::uint64_t{1} << 56) - 1);
+    }
+
+    // index of the word following this value
+    std::size_t next() const;
+
+    boost::string_view text() const;
+
+    TapeValue at(std::size_t index) const
+    {
+        TapeValue value = *this;
+        value.m_index = index;
+        return value;
+    }
+
+    template <typename T>
+    void expect(Type type) const;
+
+    const std::uint64_t* m_words;
+    const char* m_strings;
+    std::uint64_t m_keyTable;
+    std::size_t m_index;
+};
+
+class TapeValue::array_iterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = TapeValue;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const TapeValue*;
+    using reference = const TapeValue&;
+
+    explicit array_iterator(const TapeValue& value) : m_value(value)
+    {
+    }
+
+    const TapeValue& operator*() const
+    {
+        return m_value;
+    }
+
+    const TapeValue* operator->() const
+    {
+        return &m_value;
+    }
+
+    array_iterator& operator++()
+    {
+        m_value.m_index = m_value.next();
+        return *this;
+    }
+
+    bool operator==(const array_iterator& rhs) const
+    {
+        return m_value.m_index == rhs.m_value.m_index;
+    }
+
+    bool operator!=(const array_iterator& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+private:
+    TapeValue m_value;
+};
+
+class TapeValue::object_iterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<boost::string_view, TapeValue>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    explicit object_iterator(const TapeValue& value)
+        : m_member(boost::string_view{}, value)
+    {
+        load();
+    }
+
+    const value_type& operator*() const
+    {
+        return m_member;
+    }
+
+    const value_type* operator->() const
+    {
+        return &m_member;
+    }
+
+    object_iterator& operator++()
+    {
+        m_member.second.m_index = m_member.second.next();
+        load();
+        return *this;
+    }
+
+    bool operator==(const object_iterator& rhs) const
+    {
+        return m_member.second.m_index == rhs.m_member.second.m_index;
+    }
+
+    bool operator!=(const object_iterator& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+private:
+    // m_member.second is positioned at the key, moves it to the value
+    void load()
+    {
+        TapeValue& value = m_member.second;
+        if (value.tag() == 's') {
+            m_member.first = value.text();
+            ++value.m_index;
+        }
+    }
+
+    value_type m_member;
+};
+
+template <>
+Null TapeValue::as<Null>() const;
+template <>
+bool TapeValue::as<bool>() const;
+template <>
+int64_t TapeValue::as<int64_t>() const;
+template <>
+double TapeValue::as<double>() const;
+template <>
+boost::string_view TapeValue::as<boost::string_view>() const;
+template <>
+std::string TapeValue::as<std::string>() const;
+
+inline TapeValue Tape::root() const
+{
+    return TapeValue(*this, 0);
+}
+
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_TAPE_HPP
@@ -0,0 +1,28 @@
+#ifndef INCLUDE_POLIP_JSON_TEXT_HPP
+#define INCLUDE_POLIP_JSON_TEXT_HPP
+
+#include <cstdint>
+#include <string>
+#include <boost/utility/string_view.hpp>
+
+namespace polip
+{
+namespace json
+{
+
+/*
+    Appends JSON text of single values to out. Doubles are written with
+    enough digits to read back the same value and always carry a decimal
+    point or an exponent, so they are not read back as integers. NaN and
+    infinities have no JSON text and are written as null, or with
+    nonFinite as nan, inf and -inf, which only the relaxed level accepts.
+ */
+void appendString(std::string& out, boost::string_view v);
+void appendInteger(std::string& out, int64_t v);
+void appendUnsigned(std::string& out, uint64_t v);
+void appendDouble(std::string& out, double v, bool nonFinite = false);
+
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_TEXT_HPP
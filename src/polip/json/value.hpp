@@ -1,6 +1,10 @@
 #ifndef INCLUDE_POLIP_JSON_VALUE_HPP
 #define INCLUDE_POLIP_JSON_VALUE_HPP
 
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <boost/spirit/include/support_extended_variant.hpp>
 #include "polip/json/value_fwd.hpp"
 #include "polip/json/error.hpp"
@@ -28,16 +32,37 @@ class Value : public boost::spirit::extended_variant<
 public:
     Value() = default;
 
-    template <typename T>
-    Value(const T& v)
-        : base_type(v)
+    // rvalues, e.g. a whole Array or Object, are moved in, not copied
+    template <typename T, typename = typename std::enable_if<!std::is_base_of<
+                              Value, typename std::decay<T>::type>::value>::type>
+    Value(T&& v)
     {
+        var = std::forward<T>(v);
     }
 
     Value(const char* v) : base_type(std::string{v})
     {
     }
 
+    Value(const Value&) = default;
+    Value(Value&&) = default;
+    Value& operator=(const Value&) = default;
+    Value& operator=(Value&&) = default;
+
+    template <typename T, typename = typename std::enable_if<!std::is_base_of<
+                              Value, typename std::decay<T>::type>::value>::type>
+    Value& operator=(T&& v)
+    {
+        var = std::forward<T>(v);
+        return *this;
+    }
+
+    Value& operator=(const char* v)
+    {
+        var = std::string{v};
+        return *this;
+    }
+
     template <typename T>
     const T& as() const;
 
@@ -61,6 +86,28 @@ public:
 
     object_iterator objectBegin();
     object_iterator objectEnd();
+
+    // items of an array or members of an object, not_array for other types
+    std::size_t size() const;
+    void reserve(std::size_t size);
+
+    // the following throw not_array/not_object for other types
+
+    // appends to an array, returns the new item
+    Value& pushBack(Value item);
+
+    // sets the first member of the name or appends a new member,
+    // returns its value
+    Value& set(const std::string& name, Value value);
+    // appends a member without looking for one of the same name
+    Value& append(std::string name, Value value);
+
+    // first member of the name, nullptr if there is none
+    Value* find(const std::string& name);
+    const Value* find(const std::string& name) const;
+
+    // removes all members of the name, returns their number
+    std::size_t erase(const std::string& name);
 };
 
 namespace details
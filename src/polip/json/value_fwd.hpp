@@ -4,6 +4,7 @@
 #include <string>
 #include <utility>
 #include <vector>
+#include "polip/json/memory.hpp"
 
 namespace polip
 {
@@ -12,9 +13,16 @@ namespace json
 
 struct Null;
 class Value;
+// Member names are plain strings, each object holds its own copies, short
+// ones within the string itself. load() has no key interning, only Tape
+// stores a repeated key once, see KeyTable in polip/json/tape.hpp.
 using NameValue = std::pair<std::string, Value>;
-using Array = std::vector<Value>;
-using Object = std::vector<NameValue>;
+// Arrays and objects stay std::vector rather than a small-buffer vector:
+// inline items would make Value contain Values by value, which needs a
+// heap indirection anyway, and would widen every Value. Both parsers size
+// them exactly instead, so each one is a single allocation.
+using Array = std::vector<Value, details::Allocator<Value>>;
+using Object = std::vector<NameValue, details::Allocator<NameValue>>;
 
 }
 }  // namespace polip::json
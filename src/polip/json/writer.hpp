@@ -0,0 +1,139 @@
+#ifndef INCLUDE_POLIP_JSON_WRITER_HPP
+#define INCLUDE_POLIP_JSON_WRITER_HPP
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "polip/json/parser.hpp"
+#include "polip/json/value.hpp"
+
+namespace polip
+{
+namespace json
+{
+
+// destination of the text produced by a Writer
+class Sink
+{
+public:
+    virtual ~Sink() {}
+
+    virtual void write(const char* data, std::size_t size) = 0;
+};
+
+// appends to a string
+class StringSink final : public Sink
+{
+public:
+    explicit StringSink(std::string& out) : m_out(out)
+    {
+    }
+
+    void write(const char* data, std::size_t size) override;
+
+private:
+    std::string& m_out;
+};
+
+// throws write_error when the stream fails
+class StreamSink final : public Sink
+{
+public:
+    explicit StreamSink(std::ostream& os) : m_os(os)
+    {
+    }
+
+    void write(const char* data, std::size_t size) override;
+
+private:
+    std::ostream& m_os;
+};
+
+// writes to a POSIX file descriptor it does not own, throws write_error
+// with errno left set when write(2) fails
+class FileSink final : public Sink
+{
+public:
+    explicit FileSink(int fd) : m_fd(fd)
+    {
+    }
+
+    void write(const char* data, std::size_t size) override;
+
+private:
+    int m_fd;
+};
+
+struct WriterOptions
+{
+    // spaces per nesting level, 0 writes compact text on a single line
+    std::size_t indent = 0;
+    // buffered bytes that trigger a write to the sink
+    std::size_t flushThreshold = 64 * 1024;
+    // NaN and infinities as nan, inf and -inf, which only the relaxed level
+    // reads back, instead of null
+    bool nonFinite = false;
+};
+
+/*
+    Writes JSON text from DispatchTarget events, so parse() can stream a
+    document through it in constant memory, e.g. to reformat it. Commas,
+    colons and indentation follow from the events, which have to describe
+    complete values in the order documented for DispatchTarget; arrayEnd()
+    outside an array throws std::logic_error and leaves the text as it
+    was. Several top level values are written one per line.
+
+    Text is collected in a buffer and handed to the sink whenever it grows
+    past the flush threshold. The destructor flushes what is left but has
+    to ignore errors, call flush() to have them reported.
+ */
+class Writer final : public DispatchTarget
+{
+public:
+    explicit Writer(Sink& sink, const WriterOptions& options = WriterOptions{});
+    ~Writer();
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    // events of a whole value
+    void value(const Value& v);
+
+    void flush();
+
+private:
+    struct Scope
+    {
+        bool object;
+        bool empty;       // nothing written in it yet
+        bool memberOpen;  // object member name written, its value not yet
+    };
+
+    bool inObject() const;
+    // separator and indentation in front of a value
+    void beginValue();
+    void endValue();
+    void newLine(std::size_t level);
+
+    void objectBeginImpl(const std::string& name) override;
+    void objectEndImpl() override;
+    void arrayBeginImpl() override;
+    void arrayEndImpl() override;
+    void nullValueImpl() override;
+    void boolValueImpl(bool v) override;
+    void integerValueImpl(int64_t v) override;
+    void doubleValueImpl(double v) override;
+    void stringValueImpl(const std::string& v) override;
+
+    Sink& m_sink;
+    WriterOptions m_options;
+    std::string m_buffer;
+    std::vector<Scope> m_scopes;
+    bool m_started = false;  // a top level value was begun
+};
+
+}
+}  // namespace polip::json
+
+#endif  // INCLUDE_POLIP_JSON_WRITER_HPP